@@ -0,0 +1,19 @@
+#!/bin/bash
+# Example: Find the limits of a storage system in one run
+
+STORAGE="/mnt/storage"
+PROFILE="FULLHD-24bit"
+THREADS=4
+FRAMES=500
+
+# Highest total frame rate written without drops, p99 under 40 ms
+vframetest -c -w $PROFILE -t $THREADS -n $FRAMES \
+  --search fps -f 24 --search-p99 40 $STORAGE > saturation-fps-$(date +%Y%m%d).csv
+
+# Highest number of 24 fps playback streams, each reading 100 frames;
+# up to 100 streams need 10000 frames on the storage
+vframetest -w $PROFILE -t $THREADS -n 10000 $STORAGE > /dev/null
+vframetest -c -r -t $THREADS -n 100 -f 24 --search streams --search-max 100 \
+  --prebuffer 2 $STORAGE > saturation-streams-$(date +%Y%m%d).csv
+
+echo "Test complete. Search curves saved to saturation-*-$(date +%Y%m%d).csv"
@@ -0,0 +1,319 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "complog.h"
+
+typedef struct complog_buf_t {
+	complog_t *log;
+	size_t cnt;
+	struct complog_buf_t *next;
+	test_completion_t recs[COMPLOG_BUF_RECORDS];
+} complog_buf_t;
+
+struct complog_t {
+	complog_writer_t *writer;
+	platform_handle_t f;
+	complog_buf_t *cur; /* Filled by the worker */
+	complog_buf_t *free; /* Written out, under the writer lock */
+	size_t pending; /* Buffers queued to the logger thread */
+	int error;
+	complog_buf_t bufs[COMPLOG_BUFS];
+};
+
+struct complog_writer_t {
+	const platform_t *platform;
+	uint64_t thread;
+	int threaded; /* The logger thread is running */
+	int stop;
+	pthread_mutex_t lock;
+	pthread_cond_t queued; /* Logger thread: a buffer is queued */
+	pthread_cond_t written; /* Workers: a buffer is free again */
+	complog_buf_t *head;
+	complog_buf_t *tail;
+};
+
+static int complog_write(const platform_t *platform, platform_handle_t f,
+			 const void *data, size_t size)
+{
+	const char *p = (const char *)data;
+
+	while (size) {
+		size_t ret = platform->write(f, p, size);
+
+		if (!ret || ret == (size_t)-1 || ret > size)
+			return 1;
+		p += ret;
+		size -= ret;
+	}
+
+	return 0;
+}
+
+static void complog_buf_write(const platform_t *platform, complog_buf_t *buf)
+{
+	complog_t *log = buf->log;
+
+	if (buf->cnt && complog_write(platform, log->f, buf->recs,
+				      sizeof(buf->recs[0]) * buf->cnt))
+		log->error = 1;
+	buf->cnt = 0;
+}
+
+static void *complog_writer_thread(void *arg)
+{
+	complog_writer_t *w = (complog_writer_t *)arg;
+	complog_buf_t *buf;
+
+	pthread_mutex_lock(&w->lock);
+	for (;;) {
+		while (!w->head && !w->stop)
+			pthread_cond_wait(&w->queued, &w->lock);
+		buf = w->head;
+		if (!buf)
+			break;
+		w->head = buf->next;
+		if (!w->head)
+			w->tail = NULL;
+		pthread_mutex_unlock(&w->lock);
+
+		/* Each log has its own file, no ordering between logs */
+		complog_buf_write(w->platform, buf);
+
+		pthread_mutex_lock(&w->lock);
+		buf->next = buf->log->free;
+		buf->log->free = buf;
+		--buf->log->pending;
+		pthread_cond_broadcast(&w->written);
+	}
+	pthread_mutex_unlock(&w->lock);
+
+	return NULL;
+}
+
+complog_writer_t *complog_writer_create(const platform_t *platform)
+{
+	complog_writer_t *w;
+
+	w = platform->calloc(1, sizeof(*w));
+	if (!w)
+		return NULL;
+	w->platform = platform;
+	pthread_mutex_init(&w->lock, NULL);
+	pthread_cond_init(&w->queued, NULL);
+	pthread_cond_init(&w->written, NULL);
+	w->threaded = !platform->thread_create(&w->thread,
+					       complog_writer_thread, w);
+
+	return w;
+}
+
+/* Every log on the writer must be closed first */
+void complog_writer_destroy(complog_writer_t *w)
+{
+	if (!w)
+		return;
+	if (w->threaded) {
+		pthread_mutex_lock(&w->lock);
+		w->stop = 1;
+		pthread_cond_signal(&w->queued);
+		pthread_mutex_unlock(&w->lock);
+		w->platform->thread_join(w->thread, NULL);
+	}
+	pthread_cond_destroy(&w->written);
+	pthread_cond_destroy(&w->queued);
+	pthread_mutex_destroy(&w->lock);
+	w->platform->free(w);
+}
+
+complog_t *complog_open(complog_writer_t *writer, const char *path,
+			const complog_header_t *hdr)
+{
+	const platform_t *platform = writer->platform;
+	complog_header_t h = *hdr;
+	complog_t *log;
+	size_t i;
+
+	log = platform->calloc(1, sizeof(*log));
+	if (!log)
+		return NULL;
+	log->writer = writer;
+	log->f = platform->open(path,
+				PLATFORM_OPEN_CREATE | PLATFORM_OPEN_WRITE |
+					PLATFORM_OPEN_TRUNC,
+				0666);
+	if (log->f <= 0) {
+		platform->free(log);
+		return NULL;
+	}
+
+	memset(h.magic, 0, sizeof(h.magic));
+	memcpy(h.magic, COMPLOG_MAGIC, sizeof(COMPLOG_MAGIC));
+	h.version = COMPLOG_VERSION;
+	h.record_size = sizeof(test_completion_t);
+	if (complog_write(platform, log->f, &h, sizeof(h))) {
+		platform->close(log->f);
+		platform->free(log);
+		return NULL;
+	}
+
+	for (i = 0; i < COMPLOG_BUFS; i++)
+		log->bufs[i].log = log;
+	log->cur = &log->bufs[0];
+	for (i = COMPLOG_BUFS - 1; i > 0; i--) {
+		log->bufs[i].next = log->free;
+		log->free = &log->bufs[i];
+	}
+
+	return log;
+}
+
+/* Hand the current buffer over and take a free one, it may have to wait */
+static void complog_flush(complog_t *log)
+{
+	complog_writer_t *w = log->writer;
+	complog_buf_t *buf = log->cur;
+
+	if (!w->threaded) {
+		complog_buf_write(w->platform, buf);
+		return;
+	}
+
+	pthread_mutex_lock(&w->lock);
+	buf->next = NULL;
+	if (w->tail)
+		w->tail->next = buf;
+	else
+		w->head = buf;
+	w->tail = buf;
+	++log->pending;
+	pthread_cond_signal(&w->queued);
+	while (!log->free)
+		pthread_cond_wait(&w->written, &w->lock);
+	log->cur = log->free;
+	log->free = log->cur->next;
+	pthread_mutex_unlock(&w->lock);
+}
+
+int complog_append(complog_t *log, const test_completion_t *comp)
+{
+	log->cur->recs[log->cur->cnt++] = *comp;
+	if (log->cur->cnt == COMPLOG_BUF_RECORDS)
+		complog_flush(log);
+
+	return log->error;
+}
+
+int complog_close(complog_t *log)
+{
+	complog_writer_t *w;
+	int ret;
+
+	if (!log)
+		return 0;
+	w = log->writer;
+	if (log->cur->cnt)
+		complog_flush(log);
+	if (w->threaded) {
+		pthread_mutex_lock(&w->lock);
+		while (log->pending)
+			pthread_cond_wait(&w->written, &w->lock);
+		pthread_mutex_unlock(&w->lock);
+	}
+
+	ret = log->error;
+	if (w->platform->close(log->f))
+		ret = 1;
+	w->platform->free(log);
+
+	return ret;
+}
+
+int complog_reader_open(const platform_t *platform, complog_reader_t *rd,
+			const char *path)
+{
+	memset(rd, 0, sizeof(*rd));
+	rd->platform = platform;
+	rd->f = platform->open(path, PLATFORM_OPEN_READ, 0);
+	if (rd->f <= 0)
+		return 1;
+
+	if (platform->read(rd->f, (char *)&rd->hdr, sizeof(rd->hdr)) !=
+		    sizeof(rd->hdr) ||
+	    memcmp(rd->hdr.magic, COMPLOG_MAGIC, sizeof(COMPLOG_MAGIC)) ||
+	    rd->hdr.version != COMPLOG_VERSION ||
+	    rd->hdr.record_size != sizeof(test_completion_t))
+		goto fail;
+	rd->hdr.profile[sizeof(rd->hdr.profile) - 1] = 0;
+
+	rd->buf = platform->malloc(sizeof(*rd->buf) * COMPLOG_BUF_RECORDS);
+	if (!rd->buf)
+		goto fail;
+
+	return 0;
+
+fail:
+	platform->close(rd->f);
+	rd->f = 0;
+	return 1;
+}
+
+int complog_reader_next(complog_reader_t *rd, test_completion_t *comp)
+{
+	if (rd->pos == rd->cnt) {
+		size_t want = sizeof(*rd->buf) * COMPLOG_BUF_RECORDS;
+		size_t got = 0;
+
+		/* Whole records only, a short read isn't the end yet */
+		while (got < want) {
+			size_t ret = rd->platform->read(
+				rd->f, (char *)rd->buf + got, want - got);
+
+			if (ret == (size_t)-1)
+				return -1;
+			if (!ret)
+				break;
+			got += ret;
+		}
+		rd->cnt = got / sizeof(*rd->buf);
+		rd->pos = 0;
+		if (got % sizeof(*rd->buf))
+			rd->truncated = 1;
+		if (!rd->cnt)
+			return 0;
+	}
+
+	*comp = rd->buf[rd->pos++];
+	++rd->records;
+
+	return 1;
+}
+
+void complog_reader_close(complog_reader_t *rd)
+{
+	if (rd->f > 0)
+		rd->platform->close(rd->f);
+	if (rd->buf)
+		rd->platform->free(rd->buf);
+	memset(rd, 0, sizeof(*rd));
+}
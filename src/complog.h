@@ -0,0 +1,89 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FRAMETEST_COMPLOG_H
+#define FRAMETEST_COMPLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "frametest.h"
+#include "platform.h"
+
+/*
+ * Completion log: an append-only file of the test_completion_t records
+ * of one worker, after a fixed header. Records are in the byte order of
+ * the machine that ran the test. A log cut short by a crash is still
+ * valid up to its last whole record.
+ */
+#define COMPLOG_MAGIC "VFTCLOG"
+#define COMPLOG_VERSION 1
+#define COMPLOG_SUFFIX ".vfl"
+/* Records a worker fills before the buffer goes to the logger thread */
+#define COMPLOG_BUF_RECORDS 1024
+/* Buffers per log, the worker only waits when all are being written */
+#define COMPLOG_BUFS 4
+#define COMPLOG_PROFILE_MAX 24
+
+typedef struct complog_header_t {
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size; /* sizeof(test_completion_t) */
+	uint64_t frame_size; /* Bytes per frame */
+	uint64_t fps; /* Frame rate of the worker, 0 if unpaced */
+	uint64_t begin; /* Start of the run, timing_time() ns */
+	char profile[COMPLOG_PROFILE_MAX]; /* Profile name, NUL terminated */
+} complog_header_t;
+
+typedef struct complog_writer_t complog_writer_t;
+typedef struct complog_t complog_t;
+
+/*
+ * One logger thread writes the full buffers of every log opened on it.
+ * Without threads the workers write them themselves.
+ */
+complog_writer_t *complog_writer_create(const platform_t *platform);
+void complog_writer_destroy(complog_writer_t *writer);
+
+/* Create the log at path, magic, version and record_size are filled in */
+complog_t *complog_open(complog_writer_t *writer, const char *path,
+			const complog_header_t *hdr);
+int complog_append(complog_t *log, const test_completion_t *comp);
+/* Write what's left and close, returns non-zero if a write failed */
+int complog_close(complog_t *log);
+
+typedef struct complog_reader_t {
+	const platform_t *platform;
+	platform_handle_t f;
+	complog_header_t hdr;
+	test_completion_t *buf;
+	size_t cnt; /* Records in buf */
+	size_t pos; /* Next record in buf */
+	size_t records; /* Records read so far */
+	int truncated; /* The log ends in a partial record */
+} complog_reader_t;
+
+/* Returns non-zero if path can't be opened or isn't a completion log */
+int complog_reader_open(const platform_t *platform, complog_reader_t *rd,
+			const char *path);
+/* Returns 1 with the next record in comp, 0 at the end, -1 on errors */
+int complog_reader_next(complog_reader_t *rd, test_completion_t *comp);
+void complog_reader_close(complog_reader_t *rd);
+
+#endif
@@ -23,6 +23,7 @@
 #else
 #define _XOPEN_SOURCE 500
 #endif
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -117,6 +118,172 @@ size_t frame_fill(frame_t *frame, char val)
 	return frame->size;
 }
 
+static inline uint64_t frame_splitmix(uint64_t *x)
+{
+	uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/*
+ * Independent xoshiro256** generators stepped side by side. Every
+ * operation is lane-wise and the multiplies by 5 and 9 are shifts and
+ * adds, so compilers turn the step into SSE2/AVX2/NEON code.
+ */
+#define FRAME_RNG_LANES 4
+
+typedef struct frame_rng_t {
+	uint64_t s[4][FRAME_RNG_LANES];
+} frame_rng_t;
+
+static void frame_rng_seed(frame_rng_t *rng, uint64_t seed)
+{
+	size_t i;
+	size_t l;
+
+	for (i = 0; i < 4; i++)
+		for (l = 0; l < FRAME_RNG_LANES; l++)
+			rng->s[i][l] = frame_splitmix(&seed);
+}
+
+static inline void frame_rng_next(frame_rng_t *rng,
+				  uint64_t out[FRAME_RNG_LANES])
+{
+	size_t l;
+
+	for (l = 0; l < FRAME_RNG_LANES; l++) {
+		uint64_t s1 = rng->s[1][l];
+		uint64_t r = (s1 << 2) + s1;
+		uint64_t t = s1 << 17;
+
+		r = (r << 7) | (r >> 57);
+		out[l] = (r << 3) + r;
+		rng->s[2][l] ^= rng->s[0][l];
+		rng->s[3][l] ^= s1;
+		rng->s[1][l] ^= rng->s[2][l];
+		rng->s[0][l] ^= rng->s[3][l];
+		rng->s[2][l] ^= t;
+		rng->s[3][l] = (rng->s[3][l] << 45) | (rng->s[3][l] >> 19);
+	}
+}
+
+static void frame_rng_fill(frame_rng_t *rng, unsigned char *buf, size_t size)
+{
+	uint64_t out[FRAME_RNG_LANES];
+
+	while (size >= sizeof(out)) {
+		frame_rng_next(rng, out);
+		memcpy(buf, out, sizeof(out));
+		buf += sizeof(out);
+		size -= sizeof(out);
+	}
+	if (size) {
+		frame_rng_next(rng, out);
+		memcpy(buf, out, size);
+	}
+}
+
+void frame_fill_random(void *buf, size_t size, uint64_t seed,
+		       unsigned int compress)
+{
+	unsigned char *p = (unsigned char *)buf;
+	size_t keep;
+	size_t offs;
+	frame_rng_t rng;
+
+	if (compress > FRAME_COMPRESS_MAX)
+		compress = FRAME_COMPRESS_MAX;
+	keep = FRAME_BLOCK - FRAME_BLOCK * compress / 100;
+
+	frame_rng_seed(&rng, seed);
+	for (offs = 0; offs < size; offs += FRAME_BLOCK) {
+		size_t len = size - offs < FRAME_BLOCK ? size - offs :
+							 FRAME_BLOCK;
+		size_t rnd = len < keep ? len : keep;
+
+		frame_rng_fill(&rng, p + offs, rnd);
+		memset(p + offs + rnd, 0, len - rnd);
+	}
+}
+
+void frame_stamp(void *buf, size_t size, uint64_t seed, uint64_t n)
+{
+	unsigned char *p = (unsigned char *)buf;
+	uint64_t x = n;
+	size_t offs;
+
+	x = seed ^ frame_splitmix(&x);
+	for (offs = 0; offs + 2 * sizeof(uint64_t) <= size;
+	     offs += FRAME_BLOCK) {
+		uint64_t v[2];
+
+		v[0] = frame_splitmix(&x);
+		v[1] = frame_splitmix(&x);
+		memcpy(p + offs, v, sizeof(v));
+	}
+}
+
+int frame_pool_create(const platform_t *platform, frame_pool_t *pool,
+		      const frame_t *frame, size_t cnt, size_t budget,
+		      platform_pages_t pages)
+{
+	void *arena;
+
+	memset(pool, 0, sizeof(*pool));
+	pool->stride = (frame->size + ALIGN_SIZE - 1) &
+		       ~((size_t)ALIGN_SIZE - 1);
+	if (!pool->stride)
+		pool->stride = ALIGN_SIZE;
+	if (budget && cnt > budget / pool->stride)
+		cnt = budget / pool->stride;
+	if (!cnt)
+		cnt = 1;
+	if (cnt > SIZE_MAX / pool->stride)
+		return 1;
+
+	if (pages != PLATFORM_PAGES_DEFAULT && platform->page_alloc) {
+		if (platform->page_alloc(&arena, pool->stride * cnt, pages,
+					 &pool->pages))
+			return 1;
+		pool->mapped = 1;
+	} else if (platform->aligned_alloc(&arena, ALIGN_SIZE,
+					   pool->stride * cnt)) {
+		return 1;
+	}
+	if (!arena)
+		return 1;
+	pool->arena = (char *)arena;
+	pool->cnt = cnt;
+
+	return 0;
+}
+
+void frame_pool_fill(frame_pool_t *pool, const frame_t *frame, size_t n)
+{
+	char *buf = frame_pool_buf(pool, n);
+
+	if (frame->size)
+		memcpy(buf, frame->data, frame->size);
+	memset(buf + frame->size, 0, pool->stride - frame->size);
+}
+
+void *frame_pool_buf(const frame_pool_t *pool, size_t n)
+{
+	return pool->arena + (n % pool->cnt) * pool->stride;
+}
+
+void frame_pool_destroy(const platform_t *platform, frame_pool_t *pool)
+{
+	if (pool->arena && pool->mapped)
+		platform->page_free(pool->arena, pool->stride * pool->cnt,
+				    pool->pages);
+	else if (pool->arena)
+		platform->free(pool->arena);
+	memset(pool, 0, sizeof(*pool));
+}
+
 size_t frame_write(const platform_t *platform, platform_handle_t f,
 		   frame_t *frame)
 {
@@ -153,3 +320,106 @@ size_t frame_read(const platform_t *platform, platform_handle_t f,
 	}
 	return res;
 }
+
+/* Length of the sub-request at pos, req_size 0 means the whole frame */
+static inline size_t frame_chunk(const frame_t *frame, size_t pos,
+				 size_t req_size)
+{
+	size_t left = frame->size - pos;
+
+	if (!req_size || req_size > left)
+		return left;
+	return req_size;
+}
+
+size_t frame_write_chunked(const platform_t *platform, platform_handle_t f,
+			   frame_t *frame, size_t req_size)
+{
+	size_t res = 0;
+
+	if (!f || !frame)
+		return 0;
+	if (!req_size || req_size >= frame->size)
+		return frame_write(platform, f, frame);
+
+	while (res < frame->size) {
+		size_t len = frame_chunk(frame, res, req_size);
+		size_t cnt;
+
+		cnt = platform->write(f, (char *)frame->data + res, len);
+		if (cnt == 0 || cnt == (size_t)-1)
+			break;
+		res += cnt;
+		if (cnt != len)
+			break;
+	}
+	return res;
+}
+
+size_t frame_read_chunked(const platform_t *platform, platform_handle_t f,
+			  frame_t *frame, size_t req_size)
+{
+	size_t res = 0;
+
+	if (!f || !frame)
+		return 0;
+	if (!req_size || req_size >= frame->size)
+		return frame_read(platform, f, frame);
+
+	while (res < frame->size) {
+		size_t readcnt;
+
+		readcnt = platform->read(f, (char *)frame->data + res,
+					 frame_chunk(frame, res, req_size));
+		if (readcnt == 0 || readcnt == (size_t)-1)
+			break;
+		res += readcnt;
+	}
+	return res;
+}
+
+size_t frame_pwrite(const platform_t *platform, platform_handle_t f,
+		    frame_t *frame, platform_off_t offs, size_t req_size)
+{
+	size_t res = 0;
+
+	if (!f || !frame)
+		return 0;
+	if (!frame->size)
+		return 0;
+
+	while (res < frame->size) {
+		size_t len = frame_chunk(frame, res, req_size);
+		size_t cnt;
+
+		cnt = platform->pwrite(f, (char *)frame->data + res, len,
+				       offs + res);
+		if (cnt == 0 || cnt == (size_t)-1)
+			break;
+		res += cnt;
+		if (cnt != len)
+			break;
+	}
+	return res;
+}
+
+size_t frame_pread(const platform_t *platform, platform_handle_t f,
+		   frame_t *frame, platform_off_t offs, size_t req_size)
+{
+	size_t res = 0;
+
+	if (!f || !frame)
+		return 0;
+
+	while (res < frame->size) {
+		size_t readcnt;
+
+		readcnt = platform->pread(f, (char *)frame->data + res,
+					  frame_chunk(frame, res, req_size),
+					  offs + res);
+		if (readcnt == 0 || readcnt == (size_t)-1)
+			break;
+		res += readcnt;
+	}
+	return res;
+}
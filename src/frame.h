@@ -22,6 +22,7 @@
 #define FRAMETEST_FRAME_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include "profile.h"
 #include "platform.h"
@@ -39,9 +40,66 @@ frame_t *frame_from_file(const platform_t *platform, const char *fname,
 void frame_destroy(const platform_t *platform, frame_t *frame);
 size_t frame_fill(frame_t *frame, char val);
 
+/* Granularity of random frame content, as storage dedupes and compresses */
+#define FRAME_BLOCK 4096
+#define FRAME_COMPRESS_MAX 99
+
+/*
+ * Fill size bytes with pseudo-random data of seed, except for the last
+ * compress percent of every FRAME_BLOCK which is left zero. The blocks
+ * then compress about 100 / (100 - compress) times, and no two match.
+ */
+void frame_fill_random(void *buf, size_t size, uint64_t seed,
+		       unsigned int compress);
+/*
+ * Make frame_fill_random() content unique to frame n, by overwriting the
+ * first 16 bytes of every block with a hash of seed, n and the block.
+ * Touches one cache line per block, so it's cheap to do before each write.
+ */
+void frame_stamp(void *buf, size_t size, uint64_t seed, uint64_t n);
+
+/*
+ * Copies of one frame carved from a single aligned arena, so that every
+ * thread or request in flight transfers to memory of its own.
+ */
+typedef struct frame_pool_t {
+	char *arena;
+	size_t stride; /* Frame size rounded up to ALIGN_SIZE */
+	size_t cnt; /* Buffers in the arena */
+	int mapped; /* From platform->page_alloc() */
+	platform_pages_t pages; /* Backing obtained */
+} frame_pool_t;
+
+/*
+ * Room for up to cnt copies of frame, as many as fit in budget bytes (0
+ * for no limit) but at least one, on pages of at most the size asked
+ * for. Returns non-zero if allocation failed.
+ */
+int frame_pool_create(const platform_t *platform, frame_pool_t *pool,
+		      const frame_t *frame, size_t cnt, size_t budget,
+		      platform_pages_t pages);
+/* Buffer n, a pool smaller than asked hands them out round-robin */
+void *frame_pool_buf(const frame_pool_t *pool, size_t n);
+/*
+ * Copy frame into buffer n. The first touch faults its pages in, on the
+ * NUMA node of the calling thread.
+ */
+void frame_pool_fill(frame_pool_t *pool, const frame_t *frame, size_t n);
+void frame_pool_destroy(const platform_t *platform, frame_pool_t *pool);
+
 size_t frame_write(const platform_t *platform, platform_handle_t f,
 		   frame_t *frame);
 size_t frame_read(const platform_t *platform, platform_handle_t f,
 		  frame_t *frame);
+/* Split the frame in requests of req_size bytes, 0 for one request */
+size_t frame_write_chunked(const platform_t *platform, platform_handle_t f,
+			   frame_t *frame, size_t req_size);
+size_t frame_read_chunked(const platform_t *platform, platform_handle_t f,
+			  frame_t *frame, size_t req_size);
+/* Positional variants, several threads may share the handle */
+size_t frame_pwrite(const platform_t *platform, platform_handle_t f,
+		    frame_t *frame, platform_off_t offs, size_t req_size);
+size_t frame_pread(const platform_t *platform, platform_handle_t f,
+		   frame_t *frame, platform_off_t offs, size_t req_size);
 
 #endif
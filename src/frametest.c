@@ -33,6 +33,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <dirent.h>
 #include <limits.h>
 
@@ -47,7 +48,9 @@
 #include "histogram.h"
 #include "frametest.h"
 #include "report.h"
+#include "search.h"
 #include "platform.h"
+#include "numa.h"
 #include "tui.h"
 
 #ifndef NO_TUI
@@ -59,6 +62,11 @@
 #include "screen.h"
 #endif
 
+/* Exit code when --playback qualification dropped frames */
+#define EXIT_PLAYBACK_FAILED 2
+/* Frame buffers of a run, beyond that requests in flight share them */
+#define DEFAULT_BUFFER_BUDGET (1024 * 1024 * 1024UL)
+
 /* Shared progress state for TUI updates (volatile for thread safety) */
 typedef struct tui_progress_t {
 	volatile size_t frames_completed;
@@ -81,33 +89,177 @@ typedef struct thread_info_t {
 	size_t start_frame;
 	size_t frames;
 	size_t fps;
+	uint64_t begin; /* Start of the run */
+	uint64_t end; /* End of a --duration run, 0 for frame count */
 
 	/* TUI shared progress pointer (NULL if TUI disabled) */
 	tui_progress_t *tui_progress;
+
+	/* Shared frame cursor, NULL for the static range above */
+	tester_dispatch_t *dispatch;
+
+	/* Virtual streams driven by this thread, NULL for a plain worker */
+	tester_vstream_t *vstreams;
+	size_t vstream_cnt;
+
+	complog_t *log; /* Completion log of this worker, NULL for none */
+
+	/* Frame buffers of the slots in flight, NULL for opts->frm */
+	void **bufs;
+	size_t buf_cnt;
+	int stamp; /* The buffers are its own, frames written get stamped */
+
+	const numa_node_t *node; /* Pinned to its CPUs, NULL to float */
 } thread_info_t;
 
+static test_mode_t opts_test_mode(const opts_t *opts)
+{
+	if (opts->reverse)
+		return TEST_MODE_REVERSE;
+	if (opts->random)
+		return TEST_MODE_RANDOM;
+	return TEST_MODE_NORM;
+}
+
+/*
+ * Per-frame records only back --frametimes and the --times breakdown,
+ * everything else is in the counters and histograms. Without them the
+ * records go as soon as a run is over instead of being concatenated.
+ */
+static inline int opts_keep_records(const opts_t *opts)
+{
+	return opts->frametimes || opts->times;
+}
+
+/* Build the tester parameters of a worker thread from the options */
+static void thread_tester_params(const thread_info_t *info,
+				 tester_params_t *params)
+{
+	const opts_t *opts = info->opts;
+
+	memset(params, 0, sizeof(*params));
+	params->path = opts->path;
+	params->frame = opts->frm;
+	params->start_frame = info->start_frame;
+	params->frames = info->frames;
+	params->fps = info->fps;
+	params->pace_spin = opts->pace_spin;
+	params->playback = opts->playback;
+	params->prebuffer = opts->prebuffer;
+	params->begin = info->begin;
+	params->end = info->end;
+	params->warmup_frames = opts->warmup_frames;
+	params->cooldown_frames = opts->cooldown_frames;
+	params->warmup = opts->warmup;
+	params->cooldown = opts->cooldown;
+	params->hist_digits = opts->hist_digits;
+	params->mode = opts_test_mode(opts);
+	if (info->dispatch) {
+		size_t share = info->dispatch->frames / opts->threads + 1;
+
+		params->dispatch = info->dispatch;
+		params->start_frame = info->dispatch->start_frame;
+		params->frames = info->dispatch->frames;
+		/*
+		 * Unless they are reported, records for about the share of
+		 * this worker, not the whole run. One taking more than half
+		 * again keeps its last ones.
+		 */
+		if (!opts_keep_records(opts))
+			params->records = share + share / 2;
+		if (params->records > params->frames)
+			params->records = params->frames;
+	}
+
+	params->files = opts->single_file ? TEST_FILES_SINGLE :
+					    TEST_FILES_MULTIPLE;
+	params->engine = opts->engine;
+	params->queue_depth = opts->queue_depth;
+	params->preopen = opts->preopen;
+	params->request_size = opts->request_size;
+	params->stripes = opts->stripes;
+	params->stream = opts->stream;
+	params->stream_io_mode = (io_mode_t)opts->stream_io_mode;
+	params->log = info->log;
+	params->bufs = info->bufs;
+	params->buf_cnt = info->buf_cnt;
+	params->stamp = info->stamp;
+	params->seed = opts->seed;
+}
+
+static void thread_result_trim(const thread_info_t *info, test_result_t *res)
+{
+	if (!opts_keep_records(info->opts))
+		test_result_drop_records(info->platform, res);
+}
+
+/*
+ * Event loop of a worker driving virtual streams, its result is their
+ * aggregate. Returns non-zero if no asynchronous engine could be set up.
+ */
+static int run_vstreams(thread_info_t *info, test_op_t op)
+{
+	const opts_t *opts = info->opts;
+	platform_engine_t engine = opts->engine;
+	test_result_t hists = { 0 };
+	size_t depth = 0;
+	size_t i;
+
+	if (engine == PLATFORM_ENGINE_SYNC)
+		engine = platform_engine_available(PLATFORM_ENGINE_URING) ?
+				 PLATFORM_ENGINE_URING :
+				 PLATFORM_ENGINE_THREADS;
+	/* Helper threads cost an OS thread per frame in flight, cap them */
+	if (engine == PLATFORM_ENGINE_THREADS)
+		depth = opts->queue_depth;
+
+	memset(&info->res, 0, sizeof(info->res));
+	if (tester_run_vstreams(info->platform, op, info->vstreams,
+				info->vstream_cnt, engine, depth, &hists)) {
+		info->res.hist = hists.hist;
+		info->res.hist_intended = hists.hist_intended;
+		return 1;
+	}
+	/*
+	 * Frame times are weighted by the steady frames of the records, so
+	 * aggregate before trimming and attach the shared histograms last.
+	 */
+	for (i = 0; i < info->vstream_cnt; i++) {
+		test_result_aggregate(&info->res, &info->vstreams[i].res);
+		thread_result_trim(info, &info->vstreams[i].res);
+	}
+	thread_result_trim(info, &info->res);
+	info->res.hist = hists.hist;
+	info->res.hist_intended = hists.hist_intended;
+
+	return 0;
+}
+
+/* Pin the calling worker to its node before it allocates anything */
+static void thread_place(const thread_info_t *info)
+{
+	if (info->node && numa_bind(info->node))
+		fprintf(stderr,
+			"WARNING: Can't pin thread %zu to NUMA node %d\n",
+			info->id, info->node->id);
+}
+
 void *run_write_test_thread(void *arg)
 {
 	thread_info_t *info = (thread_info_t *)arg;
-	test_mode_t mode = TEST_MODE_NORM;
-	test_files_t files;
+	tester_params_t params;
 
 	if (!arg)
 		return NULL;
 	if (!info->opts)
 		return NULL;
+	thread_place(info);
+	if (info->vstreams)
+		return run_vstreams(info, TEST_OP_WRITE) ? arg : NULL;
 
-	if (info->opts->reverse)
-		mode = TEST_MODE_REVERSE;
-	else if (info->opts->random)
-		mode = TEST_MODE_RANDOM;
-
-	files = info->opts->single_file ? TEST_FILES_SINGLE :
-					  TEST_FILES_MULTIPLE;
-
-	info->res = tester_run_write(info->platform, info->opts->path,
-				     info->opts->frm, info->start_frame,
-				     info->frames, info->fps, mode, files);
+	thread_tester_params(info, &params);
+	info->res = tester_run(info->platform, TEST_OP_WRITE, &params);
+	thread_result_trim(info, &info->res);
 
 	return NULL;
 }
@@ -115,25 +267,19 @@ void *run_write_test_thread(void *arg)
 void *run_read_test_thread(void *arg)
 {
 	thread_info_t *info = (thread_info_t *)arg;
-	test_mode_t mode = TEST_MODE_NORM;
-	test_files_t files;
+	tester_params_t params;
 
 	if (!arg)
 		return NULL;
 	if (!info->opts)
 		return NULL;
+	thread_place(info);
+	if (info->vstreams)
+		return run_vstreams(info, TEST_OP_READ) ? arg : NULL;
 
-	if (info->opts->reverse)
-		mode = TEST_MODE_REVERSE;
-	else if (info->opts->random)
-		mode = TEST_MODE_RANDOM;
-
-	files = info->opts->single_file ? TEST_FILES_SINGLE :
-					  TEST_FILES_MULTIPLE;
-
-	info->res = tester_run_read(info->platform, info->opts->path,
-				    info->opts->frm, info->start_frame,
-				    info->frames, info->fps, mode, files);
+	thread_tester_params(info, &params);
+	info->res = tester_run(info->platform, TEST_OP_READ, &params);
+	thread_result_trim(info, &info->res);
 
 	return NULL;
 }
@@ -166,27 +312,18 @@ static void tui_progress_callback(void *ctx, size_t frames_done,
 void *run_write_test_thread_tui(void *arg)
 {
 	thread_info_t *info = (thread_info_t *)arg;
-	test_mode_t mode = TEST_MODE_NORM;
-	test_files_t files;
+	tester_params_t params;
 
 	if (!arg)
 		return NULL;
 	if (!info->opts)
 		return NULL;
 
-	if (info->opts->reverse)
-		mode = TEST_MODE_REVERSE;
-	else if (info->opts->random)
-		mode = TEST_MODE_RANDOM;
-
-	files = info->opts->single_file ? TEST_FILES_SINGLE :
-					  TEST_FILES_MULTIPLE;
-
-	info->res = tester_run_write_cb(info->platform, info->opts->path,
-					info->opts->frm, info->start_frame,
-					info->frames, info->fps, mode, files,
-					tui_progress_callback,
-					info->tui_progress);
+	thread_tester_params(info, &params);
+	params.cb = tui_progress_callback;
+	params.cb_ctx = info->tui_progress;
+	info->res = tester_run(info->platform, TEST_OP_WRITE, &params);
+	thread_result_trim(info, &info->res);
 
 	return NULL;
 }
@@ -195,27 +332,18 @@ void *run_write_test_thread_tui(void *arg)
 void *run_read_test_thread_tui(void *arg)
 {
 	thread_info_t *info = (thread_info_t *)arg;
-	test_mode_t mode = TEST_MODE_NORM;
-	test_files_t files;
+	tester_params_t params;
 
 	if (!arg)
 		return NULL;
 	if (!info->opts)
 		return NULL;
 
-	if (info->opts->reverse)
-		mode = TEST_MODE_REVERSE;
-	else if (info->opts->random)
-		mode = TEST_MODE_RANDOM;
-
-	files = info->opts->single_file ? TEST_FILES_SINGLE :
-					  TEST_FILES_MULTIPLE;
-
-	info->res = tester_run_read_cb(info->platform, info->opts->path,
-				       info->opts->frm, info->start_frame,
-				       info->frames, info->fps, mode, files,
-				       tui_progress_callback,
-				       info->tui_progress);
+	thread_tester_params(info, &params);
+	params.cb = tui_progress_callback;
+	params.cb_ctx = info->tui_progress;
+	info->res = tester_run(info->platform, TEST_OP_READ, &params);
+	thread_result_trim(info, &info->res);
 
 	return NULL;
 }
@@ -236,7 +364,7 @@ void calculate_frame_range(thread_info_t *threads, const opts_t *opts)
 	fps_per_thread = opts->fps / opts->threads;
 	fps_left = opts->fps % opts->threads;
 
-	start_frame = 0;
+	start_frame = opts->first_frame;
 
 	for (i = 0; i < opts->threads; i++) {
 		threads[i].start_frame = start_frame;
@@ -254,26 +382,564 @@ void calculate_frame_range(thread_info_t *threads, const opts_t *opts)
 	}
 }
 
-int run_test_threads(const platform_t *platform, const char *tst,
-		     const opts_t *opts, void *(*tfunc)(void *))
+/*
+ * Single-file mode on the sync engine: open the stream once and let all
+ * workers share the descriptor with positional I/O. If it can't be opened
+ * the workers open it per frame and report the failures themselves.
+ */
+static void stream_open(const platform_t *platform, opts_t *opts,
+			test_op_t op)
+{
+	io_mode_t io_mode = IO_MODE_UNKNOWN;
+
+	opts->stream = 0;
+	if (!opts->single_file || opts->engine != PLATFORM_ENGINE_SYNC ||
+	    opts->stripes > 1 || opts->vstreams)
+		return;
+
+	opts->stream = tester_stream_open(platform, opts->path, op, &io_mode);
+	if (opts->stream < 0)
+		opts->stream = 0;
+	opts->stream_io_mode = io_mode;
+}
+
+static void stream_close(const platform_t *platform, opts_t *opts)
+{
+	if (opts->stream > 0)
+		platform->close(opts->stream);
+	opts->stream = 0;
+}
+
+/*
+ * Dynamic scheduling, the default with several threads: all workers pull
+ * frames from one shared cursor. The handle cache needs to know the
+ * frames of a worker up front, so it keeps the static ranges.
+ */
+static int dispatch_setup(const platform_t *platform, const opts_t *opts,
+			  thread_info_t *threads, tester_dispatch_t *dispatch)
+{
+	size_t i;
+
+	if (opts->static_schedule || opts->preopen || opts->vstreams ||
+	    opts->threads < 2)
+		return 0;
+	if (tester_dispatch_init(platform, dispatch, opts->first_frame,
+				 opts->frames, opts_test_mode(opts)))
+		return 1;
+	for (i = 0; i < opts->threads; i++)
+		threads[i].dispatch = dispatch;
+
+	return 0;
+}
+
+/*
+ * Virtual streams split the frames and the frame rate like threads do,
+ * then every thread gets a contiguous share of the streams to drive.
+ */
+static tester_vstream_t *vstreams_setup(const platform_t *platform,
+					const opts_t *opts,
+					thread_info_t *threads)
+{
+	tester_vstream_t *vstreams;
+	size_t start_frame = opts->first_frame;
+	size_t first = 0;
+	size_t i;
+
+	vstreams = platform->calloc(opts->vstreams, sizeof(*vstreams));
+	if (!vstreams)
+		return NULL;
+
+	for (i = 0; i < opts->vstreams; i++) {
+		thread_info_t info = { 0 };
+
+		info.opts = opts;
+		info.start_frame = start_frame;
+		info.frames = opts->frames / opts->vstreams +
+			      (i < opts->frames % opts->vstreams);
+		info.fps = opts->fps / opts->vstreams +
+			   (i < opts->fps % opts->vstreams);
+		thread_tester_params(&info, &vstreams[i].params);
+		/* Spread the first frames over one period, like real clients */
+		if (info.fps)
+			vstreams[i].offset_ns =
+				SEC_IN_NS / info.fps * i / opts->vstreams;
+		start_frame += info.frames;
+	}
+
+	for (i = 0; i < opts->threads; i++) {
+		threads[i].vstreams = vstreams + first;
+		threads[i].vstream_cnt = opts->vstreams / opts->threads +
+					 (i < opts->vstreams % opts->threads);
+		first += threads[i].vstream_cnt;
+	}
+
+	return vstreams;
+}
+
+static void vstreams_collect(const opts_t *opts, tester_vstream_t *vstreams,
+			     test_result_t *tres)
+{
+	const platform_t *platform = platform_get();
+	size_t i;
+
+	tres->stream_stats = calloc(opts->vstreams, sizeof(*tres->stream_stats));
+	tres->stream_count = tres->stream_stats ? opts->vstreams : 0;
+	for (i = 0; i < opts->vstreams; i++) {
+		if (tres->stream_stats)
+			tester_vstream_stats(&vstreams[i],
+					     &tres->stream_stats[i]);
+		result_free(platform, &vstreams[i].res);
+	}
+}
+
+/* Frame buffers of a case, carved from one pool */
+typedef struct framebufs_t {
+	frame_pool_t pool;
+	void **bufs; /* Slots of every worker back to back */
+	size_t workers;
+	size_t per; /* Slots per worker */
+} framebufs_t;
+
+/* Frames a worker (or virtual stream) keeps in flight */
+static size_t opts_worker_slots(const opts_t *opts)
+{
+	if (opts->vstreams || opts->engine == PLATFORM_ENGINE_SYNC ||
+	    opts->stripes > 1 || !opts->queue_depth)
+		return 1;
+	return opts->queue_depth;
+}
+
+static void framebufs_free(const platform_t *platform, framebufs_t *fb)
+{
+	if (fb->bufs)
+		platform->free(fb->bufs);
+	frame_pool_destroy(platform, &fb->pool);
+	memset(fb, 0, sizeof(*fb));
+}
+
+/* Node of worker n, a virtual stream runs on the node of its thread */
+static const numa_node_t *worker_node(const opts_t *opts,
+				      const thread_info_t *threads,
+				      const tester_vstream_t *vstreams,
+				      size_t n)
+{
+	size_t i;
+
+	if (!vstreams)
+		return threads[n].node;
+	for (i = 0; i < opts->threads; i++) {
+		if (&vstreams[n] >= threads[i].vstreams &&
+		    &vstreams[n] < threads[i].vstreams + threads[i].vstream_cnt)
+			return threads[i].node;
+	}
+
+	return NULL;
+}
+
+/* Fill the buffers of the workers on node, or of all for NULL */
+typedef struct framebufs_fill_t {
+	const opts_t *opts;
+	framebufs_t *fb;
+	const thread_info_t *threads;
+	const tester_vstream_t *vstreams;
+	const numa_node_t *node;
+} framebufs_fill_t;
+
+static void framebufs_fill_workers(const framebufs_fill_t *ff)
+{
+	size_t w;
+	size_t n;
+
+	for (w = 0; w < ff->fb->workers; w++) {
+		if (ff->node && worker_node(ff->opts, ff->threads,
+					    ff->vstreams, w) != ff->node)
+			continue;
+		/* Buffers wrapped around from the start belong to others */
+		for (n = w * ff->fb->per;
+		     n < (w + 1) * ff->fb->per && n < ff->fb->pool.cnt; n++)
+			frame_pool_fill(&ff->fb->pool, ff->opts->frm, n);
+	}
+}
+
+static void *framebufs_fill_thread(void *arg)
+{
+	framebufs_fill_t *ff = (framebufs_fill_t *)arg;
+
+	(void)numa_bind(ff->node);
+	framebufs_fill_workers(ff);
+
+	return NULL;
+}
+
+/*
+ * Copy the frame into the buffers. With --numa a thread pinned to each
+ * node touches the buffers of its workers first, so their pages are
+ * local to them. One node at a time, buffers shared across nodes are
+ * only ever written by one thread.
+ */
+static void framebufs_fill(const platform_t *platform, const opts_t *opts,
+			   const thread_info_t *threads,
+			   const tester_vstream_t *vstreams, const numa_t *numa,
+			   framebufs_t *fb)
+{
+	framebufs_fill_t ff = { opts, fb, threads, vstreams, NULL };
+	size_t i;
+
+	if (!fb->bufs)
+		return;
+	if (!numa) {
+		framebufs_fill_workers(&ff);
+		return;
+	}
+
+	for (i = 0; i < numa->node_cnt; i++) {
+		uint64_t thread;
+
+		ff.node = &numa->nodes[i];
+		if (platform->thread_create(&thread, framebufs_fill_thread,
+					    &ff))
+			framebufs_fill_workers(&ff);
+		else
+			platform->thread_join(thread, NULL);
+	}
+}
+
+/*
+ * Give every frame in flight a buffer of its own, threads x slots x
+ * frame size within --buffer-budget. Short of it the slots of a worker
+ * share buffers first, then the workers. Without memory for the pool
+ * everyone keeps sharing opts->frm.
+ */
+static void framebufs_setup(const platform_t *platform, const opts_t *opts,
+			    thread_info_t *threads, tester_vstream_t *vstreams,
+			    const numa_t *numa, framebufs_t *fb)
+{
+	size_t workers = vstreams ? opts->vstreams : opts->threads;
+	size_t slots = opts_worker_slots(opts);
+	size_t per;
+	size_t i;
+	int stamp;
+
+	memset(fb, 0, sizeof(*fb));
+	if (!opts->frm || !opts->frm->size || !workers ||
+	    slots > SIZE_MAX / workers)
+		return;
+	if (frame_pool_create(platform, &fb->pool, opts->frm, workers * slots,
+			      opts->buffer_budget, opts->huge_pages))
+		return;
+
+	per = fb->pool.cnt / workers;
+	if (!per)
+		per = 1;
+	if (per > slots)
+		per = slots;
+	fb->bufs = platform->calloc(workers * per, sizeof(*fb->bufs));
+	if (!fb->bufs) {
+		framebufs_free(platform, fb);
+		return;
+	}
+	for (i = 0; i < workers * per; i++)
+		fb->bufs[i] = frame_pool_buf(&fb->pool, i);
+	fb->workers = workers;
+	fb->per = per;
+
+	/* Random frames are stamped in place, that takes private buffers */
+	stamp = opts->fill_random && per == slots &&
+		fb->pool.cnt >= workers * per;
+	if (opts->fill_random && !stamp)
+		fprintf(stderr, "WARNING: Frame buffers are shared within "
+				"--buffer-budget, random frames aren't "
+				"unique\n");
+
+	for (i = 0; i < workers; i++) {
+		if (vstreams) {
+			vstreams[i].params.bufs = fb->bufs + i * per;
+			vstreams[i].params.buf_cnt = per;
+			vstreams[i].params.stamp = stamp;
+		} else {
+			threads[i].bufs = fb->bufs + i * per;
+			threads[i].buf_cnt = per;
+			threads[i].stamp = stamp;
+		}
+	}
+	framebufs_fill(platform, opts, threads, vstreams, numa, fb);
+}
+
+/*
+ * With --numa, pin every worker thread to a node: round-robin, the node
+ * of the device under the test path or the one given. Without topology
+ * the workers float as before. The nodes in use get an entry in tres.
+ * Returns non-zero if the given node can't run workers.
+ */
+static int numa_setup(const platform_t *platform, const opts_t *opts,
+		      thread_info_t *threads, numa_t **res,
+		      test_result_t *tres)
+{
+	const numa_node_t *node = NULL;
+	numa_t *numa;
+	size_t i;
+	size_t k;
+
+	*res = NULL;
+	if (opts->numa == NUMA_PLACE_OFF)
+		return 0;
+	numa = platform->calloc(1, sizeof(*numa));
+	if (!numa || numa_read(numa, NUMA_SYSFS)) {
+		fprintf(stderr, "WARNING: No NUMA topology, threads are not "
+				"pinned\n");
+		if (numa)
+			platform->free(numa);
+		return 0;
+	}
+
+	if (opts->numa == NUMA_PLACE_NODE) {
+		node = numa_node(numa, opts->numa_node);
+		if (!node) {
+			fprintf(stderr, "NUMA node %d has no CPUs\n",
+				opts->numa_node);
+			platform->free(numa);
+			return 1;
+		}
+	} else if (opts->numa == NUMA_PLACE_NEAR) {
+		int id = numa_path_node(opts->path);
+
+		node = numa_node(numa, id);
+		if (!node)
+			fprintf(stderr, "WARNING: NUMA node of %s unknown, "
+					"placing threads round-robin\n",
+				opts->path);
+	}
+
+	tres->node_stats = calloc(numa->node_cnt, sizeof(*tres->node_stats));
+	for (i = 0; i < opts->threads; i++)
+		threads[i].node = node ? node : &numa->nodes[i % numa->node_cnt];
+	/* Report the nodes in use only, in node order */
+	for (i = 0, k = 0; tres->node_stats && i < numa->node_cnt; i++) {
+		size_t j;
+		size_t cnt = 0;
+
+		for (j = 0; j < opts->threads; j++)
+			cnt += threads[j].node == &numa->nodes[i];
+		if (!cnt)
+			continue;
+		tres->node_stats[k].node = numa->nodes[i].id;
+		tres->node_stats[k].threads = cnt;
+		++k;
+	}
+	tres->node_count = k;
+	*res = numa;
+
+	return 0;
+}
+
+static int cpuset_overlap(const platform_cpuset_t *a,
+			  const platform_cpuset_t *b)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(a->bits); i++) {
+		if (a->bits[i] & b->bits[i])
+			return 1;
+	}
+
+	return 0;
+}
+
+static inline int opts_worker_attr_set(const opts_t *opts)
+{
+	const platform_thread_attr_t *attr = &opts->worker_attr;
+
+	return attr->cpus.cnt || attr->sched != PLATFORM_SCHED_OTHER ||
+	       attr->nice || attr->ioprio != PLATFORM_IOPRIO_NONE;
+}
+
+/* Start a worker thread placed and scheduled as the options ask */
+static int worker_start(const platform_t *platform, const opts_t *opts,
+			thread_info_t *info, void *(*tfunc)(void *))
+{
+	int res;
+
+	if (!opts_worker_attr_set(opts))
+		return platform->thread_create(&info->thread, tfunc, info);
+
+	res = platform->thread_create_attr(&info->thread, &opts->worker_attr,
+					   tfunc, info);
+	if (res)
+		fprintf(stderr,
+			"Can't apply --cpus/--sched/--nice/--ioprio to "
+			"thread %zu: %s\n",
+			info->id, strerror(res));
+
+	return res;
+}
+
+/* The node of --numa N can run workers, or there's no topology at all */
+static int numa_node_usable(const opts_t *opts)
+{
+	numa_t *numa = calloc(1, sizeof(*numa));
+	int res;
+
+	if (!numa)
+		return 1;
+	res = numa_read(numa, NUMA_SYSFS) ||
+	      numa_node(numa, opts->numa_node) != NULL;
+	free(numa);
+
+	return res;
+}
+
+/* Account the frames of a finished worker to its node */
+static void node_stats_add(test_result_t *tres, const thread_info_t *info)
+{
+	size_t i;
+
+	for (i = 0; info->node && i < tres->node_count; i++) {
+		if (tres->node_stats[i].node != info->node->id)
+			continue;
+		tres->node_stats[i].frames += info->res.frames_written;
+		tres->node_stats[i].bytes += info->res.bytes_written;
+		break;
+	}
+}
+
+/* Completion logs of a case, one per worker or virtual stream */
+typedef struct complogs_t {
+	complog_writer_t *writer;
+	complog_t **logs;
+	size_t cnt;
+} complogs_t;
+
+/* Completion log n of a case, <prefix>-<case>-<n>.vfl */
+static void complog_path(char *path, size_t size, const char *prefix,
+			 const char *tst, size_t n)
+{
+	snprintf(path, size, "%s-%s-%zu" COMPLOG_SUFFIX, prefix, tst, n);
+}
+
+static int complogs_close(const platform_t *platform, const opts_t *opts,
+			  complogs_t *cl)
+{
+	char path[PATH_MAX];
+	size_t i;
+	int res = 0;
+
+	for (i = 0; cl->logs && i < cl->cnt; i++) {
+		if (!complog_close(cl->logs[i]))
+			continue;
+		complog_path(path, sizeof(path), opts->complog,
+			     opts->complog_case, i);
+		fprintf(stderr, "Can't write completion log %s\n", path);
+		res = 1;
+	}
+	complog_writer_destroy(cl->writer);
+	if (cl->logs)
+		platform->free(cl->logs);
+	memset(cl, 0, sizeof(*cl));
+
+	return res;
+}
+
+/*
+ * With --log, give every worker (or virtual stream) its own completion
+ * log, all written by one logger thread. Returns non-zero on failure.
+ */
+static int complogs_open(const platform_t *platform, const opts_t *opts,
+			 thread_info_t *threads, tester_vstream_t *vstreams,
+			 uint64_t begin, complogs_t *cl)
+{
+	complog_header_t hdr = { { 0 } };
+	char path[PATH_MAX];
+	size_t i;
+
+	memset(cl, 0, sizeof(*cl));
+	if (!opts->complog || !opts->complog_case)
+		return 0;
+
+	cl->cnt = vstreams ? opts->vstreams : opts->threads;
+	cl->logs = platform->calloc(cl->cnt, sizeof(*cl->logs));
+	cl->writer = complog_writer_create(platform);
+	if (!cl->logs || !cl->writer) {
+		complogs_close(platform, opts, cl);
+		return 1;
+	}
+
+	hdr.frame_size = opts->frm->size;
+	hdr.begin = begin;
+	snprintf(hdr.profile, sizeof(hdr.profile), "%s", opts->profile.name);
+	for (i = 0; i < cl->cnt; i++) {
+		hdr.fps = vstreams ? vstreams[i].params.fps : threads[i].fps;
+		complog_path(path, sizeof(path), opts->complog,
+			     opts->complog_case, i);
+		cl->logs[i] = complog_open(cl->writer, path, &hdr);
+		if (!cl->logs[i]) {
+			fprintf(stderr, "Can't create completion log %s\n",
+				path);
+			complogs_close(platform, opts, cl);
+			return 1;
+		}
+		if (vstreams)
+			vstreams[i].params.log = cl->logs[i];
+		else
+			threads[i].log = cl->logs[i];
+	}
+
+	return 0;
+}
+
+/*
+ * Run opts->threads workers of tfunc to completion and aggregate their
+ * results in tres. Returns non-zero if a worker failed.
+ */
+static int collect_test_threads(const platform_t *platform,
+				const opts_t *opts, void *(*tfunc)(void *),
+				test_result_t *tres)
 {
 	size_t i;
 	int res;
 	thread_info_t *threads;
-	test_result_t tres = { 0 };
+	tester_dispatch_t dispatch = { 0 };
+	tester_vstream_t *vstreams = NULL;
+	framebufs_t bufs;
+	complogs_t logs;
+	numa_t *numa;
 	uint64_t start;
+	uint64_t elapsed;
 
+	memset(tres, 0, sizeof(*tres));
 	threads = platform->calloc(opts->threads, sizeof(*threads));
 	if (!threads)
 		return 1;
+	tres->thread_frames =
+		calloc(opts->threads, sizeof(*tres->thread_frames));
+	tres->thread_count = tres->thread_frames ? opts->threads : 0;
 
 	calculate_frame_range(threads, opts);
+	if (numa_setup(platform, opts, threads, &numa, tres)) {
+		result_free(platform, tres);
+		platform->free(threads);
+		return 1;
+	}
+	if (dispatch_setup(platform, opts, threads, &dispatch)) {
+		platform->free(numa);
+		result_free(platform, tres);
+		platform->free(threads);
+		return 1;
+	}
+	if (opts->vstreams) {
+		vstreams = vstreams_setup(platform, opts, threads);
+		if (!vstreams) {
+			platform->free(numa);
+			result_free(platform, tres);
+			platform->free(threads);
+			return 1;
+		}
+	}
 
 	/* Phase 1: Detect filesystem type and warn if remote */
-	tres.filesystem_type = platform_detect_filesystem(opts->path);
-	if (tres.filesystem_type != 0) {
-		const char *fs_name = (tres.filesystem_type == 1) ? "SMB" :
-				      (tres.filesystem_type == 2) ? "NFS" :
+	tres->filesystem_type = platform_detect_filesystem(opts->path);
+	if (tres->filesystem_type != 0) {
+		const char *fs_name = (tres->filesystem_type == 1) ? "SMB" :
+				      (tres->filesystem_type == 2) ? "NFS" :
 								    "Unknown";
 		fprintf(stderr,
 			"WARNING: Test path is on a remote filesystem (%s)\n"
@@ -281,15 +947,37 @@ int run_test_threads(const platform_t *platform, const char *tst,
 			fs_name);
 	}
 
+	framebufs_setup(platform, opts, threads, vstreams, numa, &bufs);
+	tres->buffer_cnt = bufs.pool.cnt;
+	tres->buffer_pages = bufs.pool.pages;
 	start = timing_start();
+	if (complogs_open(platform, opts, threads, vstreams, start, &logs)) {
+		framebufs_free(platform, &bufs);
+		platform->free(numa);
+		tester_dispatch_free(platform, &dispatch);
+		if (vstreams) {
+			vstreams_collect(opts, vstreams, tres);
+			platform->free(vstreams);
+		}
+		result_free(platform, tres);
+		platform->free(threads);
+		return 1;
+	}
+	/* Time-bounded runs share one deadline, throughput uses the real end */
+	for (i = 0; vstreams && i < opts->vstreams; i++) {
+		vstreams[i].params.begin = start;
+		if (opts->duration)
+			vstreams[i].params.end = start + opts->duration;
+	}
 	for (i = 0; i < opts->threads; i++) {
 		int thread_res;
 
 		threads[i].id = i;
 		threads[i].platform = platform;
 		threads[i].opts = opts;
-		thread_res = platform->thread_create(&threads[i].thread, tfunc,
-						     (void *)&threads[i]);
+		threads[i].begin = start;
+		threads[i].end = opts->duration ? start + opts->duration : 0;
+		thread_res = worker_start(platform, opts, &threads[i], tfunc);
 		if (thread_res) {
 			size_t j;
 			void *ret;
@@ -298,6 +986,15 @@ int run_test_threads(const platform_t *platform, const char *tst,
 				platform->thread_cancel(threads[j].thread);
 			for (j = 0; j < i; j++)
 				platform->thread_join(threads[j].thread, &ret);
+			complogs_close(platform, opts, &logs);
+			framebufs_free(platform, &bufs);
+			platform->free(numa);
+			tester_dispatch_free(platform, &dispatch);
+			if (vstreams) {
+				vstreams_collect(opts, vstreams, tres);
+				platform->free(vstreams);
+			}
+			result_free(platform, tres);
 			platform->free(threads);
 			return 1;
 		}
@@ -311,74 +1008,516 @@ int run_test_threads(const platform_t *platform, const char *tst,
 			res = 1;
 		if (ret)
 			res = 1;
-
+	}
+	/* The run ends with the last worker, not with collecting results */
+	elapsed = timing_elapsed(start);
+	for (i = 0; i < opts->threads; i++) {
 #if 0
 		print_results(&threads[i].res);
 #endif
-		if (test_result_aggregate(&tres, &threads[i].res))
+		if (test_result_aggregate(tres, &threads[i].res))
 			res = 1;
+		if (i < tres->thread_count)
+			tres->thread_frames[i] = threads[i].res.frames_written;
+		node_stats_add(tres, &threads[i]);
 		result_free(platform, &threads[i].res);
 	}
-	tres.time_taken_ns = timing_elapsed(start);
-	if (!res) {
-		if (opts->json) {
-			if (!opts->no_csv_header)
-				print_header_json();
-			print_results_json(tst, opts, &tres);
-			if (!opts->no_csv_header)
-				print_footer_json();
-		} else if (opts->csv) {
-			print_results_csv(tst, opts, &tres);
-		} else {
-			print_results(tst, opts, &tres);
-			/* Phase 1: Always display error/success summary */
-			fprintf(stdout, "Frames failed: %d\n",
-				tres.frames_failed);
-			fprintf(stdout, "Frames succeeded: %d\n",
-				tres.frames_succeeded);
-			fprintf(stdout, "Success rate: %.2f%%\n",
-				tres.success_rate_percent);
-			/* Phase 1: Display filesystem type and warnings */
-			const char *fs_types[] = { "LOCAL", "SMB", "NFS",
-						   "OTHER" };
-			int fs_idx = (tres.filesystem_type >= 0 &&
-				      tres.filesystem_type <= 3) ?
-					     tres.filesystem_type :
-					     3;
-			fprintf(stdout, "Filesystem: %s\n", fs_types[fs_idx]);
-			if (tres.filesystem_type != 0) {
-				fprintf(stdout,
-					"WARNING: Test path is on a remote filesystem\n");
-				fprintf(stdout,
-					"Direct I/O may not be available. Results may not be accurate.\n");
-			}
+	tester_dispatch_free(platform, &dispatch);
+	tres->time_taken_ns = elapsed;
+	if (complogs_close(platform, opts, &logs))
+		res = 1;
+	framebufs_free(platform, &bufs);
+	platform->free(numa);
+	if (vstreams) {
+		vstreams_collect(opts, vstreams, tres);
+		platform->free(vstreams);
+	}
+	platform->free(threads);
+	return res;
+}
+
+/* Write one histogram of --hist-export, <prefix>-<case><suffix>.hgrm */
+static int export_histogram(const char *tst, const char *suffix,
+			    const opts_t *opts, const hist_t *hist)
+{
+	char path[PATH_MAX];
+	FILE *f;
+	int res;
+
+	if (!hist)
+		return 0;
+	snprintf(path, sizeof(path), "%s-%s%s.hgrm", opts->hist_export, tst,
+		 suffix);
+	f = fopen(path, "w");
+	if (!f) {
+		fprintf(stderr, "Can't write histogram to %s\n", path);
+		return 1;
+	}
+	res = hist_export(hist, f);
+	if (fclose(f) || res) {
+		fprintf(stderr, "Can't write histogram to %s\n", path);
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Report one aggregated result, returns EXIT_PLAYBACK_FAILED on drops */
+static int print_test_results(const char *tst, const opts_t *opts,
+			      const test_result_t *tres)
+{
+	if (opts->json) {
+		print_results_json(tst, opts, tres);
+	} else if (opts->csv) {
+		print_results_csv(tst, opts, tres);
+	} else {
+		print_results(tst, opts, tres);
+		/* Phase 1: Always display error/success summary */
+		fprintf(stdout, "Frames failed: %d\n",
+			tres->frames_failed);
+		fprintf(stdout, "Frames succeeded: %d\n",
+			tres->frames_succeeded);
+		fprintf(stdout, "Success rate: %.2f%%\n",
+			tres->success_rate_percent);
+		/* Phase 1: Display filesystem type and warnings */
+		const char *fs_types[] = { "LOCAL", "SMB", "NFS",
+					   "OTHER" };
+		int fs_idx = (tres->filesystem_type >= 0 &&
+			      tres->filesystem_type <= 3) ?
+				     tres->filesystem_type :
+				     3;
+		fprintf(stdout, "Filesystem: %s\n", fs_types[fs_idx]);
+		if (tres->filesystem_type != 0) {
+			fprintf(stdout,
+				"WARNING: Test path is on a remote filesystem\n");
+			fprintf(stdout,
+				"Direct I/O may not be available. Results may not be accurate.\n");
+		}
+
+		/* Phase 2: Display I/O fallback statistics */
+		if (tres->frames_direct_io > 0 ||
+		    tres->frames_buffered_io > 0) {
+			fprintf(stdout,
+				"\n--- Phase 2: I/O Mode Statistics ---\n");
+			fprintf(stdout, "Frames with Direct I/O: %d\n",
+				tres->frames_direct_io);
+			fprintf(stdout,
+				"Frames with Buffered I/O (fallback): %d\n",
+				tres->frames_buffered_io);
+			fprintf(stdout,
+				"Direct I/O success rate: %.2f%%\n",
+				tres->direct_io_success_rate);
+			if (tres->fallback_count > 0) {
+				fprintf(stdout, "Fallback events: %d\n",
+					tres->fallback_count);
+			}
+		}
+
+		if (opts->histogram)
+			print_histogram(tres);
+	}
+	if (opts->hist_export &&
+	    (export_histogram(tst, "", opts, tres->hist) ||
+	     export_histogram(tst, "-intended", opts, tres->hist_intended)))
+		return 1;
+	if (tres->playback && !test_result_playback_ok(tres))
+		return EXIT_PLAYBACK_FAILED;
+
+	return 0;
+}
+
+int run_test_threads(const platform_t *platform, const char *tst,
+		     const opts_t *opts, void *(*tfunc)(void *))
+{
+	opts_t lopts = *opts;
+	test_result_t tres;
+	int res;
+
+	lopts.complog_case = tst;
+	res = collect_test_threads(platform, &lopts, tfunc, &tres);
+	if (!res) {
+		if (opts->json && !opts->no_csv_header)
+			print_header_json();
+		res = print_test_results(tst, opts, &tres);
+		if (opts->json && !opts->no_csv_header)
+			print_footer_json();
+	}
+	result_free(platform, &tres);
+
+	return res;
+}
+
+/*
+ * Rebuild the result of one case from its logs <prefix>-<tst>-<n>.vfl,
+ * n from 0 up to the first missing one, and its profile name from the
+ * first one. Returns -1 if there are none and 1 if a log can't be read.
+ */
+static int analyze_case(const platform_t *platform, opts_t *opts,
+			const char *tst, char *profile, test_result_t *tres)
+{
+	char path[PATH_MAX];
+	uint64_t end = 0;
+	size_t n;
+	int res = 0;
+
+	memset(tres, 0, sizeof(*tres));
+	for (n = 0;; n++) {
+		thread_info_t info = { 0 };
+		tester_params_t params;
+		complog_reader_t rd;
+		test_result_t r;
+
+		complog_path(path, sizeof(path), opts->analyze_log, tst, n);
+		if (complog_reader_open(platform, &rd, path))
+			break;
+
+		info.platform = platform;
+		info.opts = opts;
+		info.frames = opts->frames;
+		thread_tester_params(&info, &params);
+		if (!params.path)
+			params.path = path;
+		if (tester_run_load(platform, &rd, &params, &r)) {
+			fprintf(stderr, "Can't read completion log %s\n", path);
+			res = 1;
+		} else if (rd.truncated) {
+			fprintf(stderr,
+				"%s: partial record at the end, ignored\n",
+				path);
+		}
+		if (r.frames_written &&
+		    r.first_start + r.time_taken_ns > end)
+			end = r.first_start + r.time_taken_ns;
+		if (!n)
+			memcpy(profile, rd.hdr.profile, sizeof(rd.hdr.profile));
+		complog_reader_close(&rd);
+
+		thread_result_trim(&info, &r);
+		if (test_result_aggregate(tres, &r))
+			res = 1;
+		result_free(platform, &r);
+	}
+	if (!n)
+		return -1;
+
+	opts->threads = n;
+	opts->profile.name = profile;
+	if (tres->frames_written)
+		tres->time_taken_ns = end - tres->first_start;
+
+	return res;
+}
+
+/*
+ * --analyze-log: report on the completion logs of an earlier (or
+ * crashed) run as if it had just finished, one result per case found.
+ */
+static int run_analyze(opts_t *opts)
+{
+	static const char *const cases[] = { "write", "read" };
+	const platform_t *platform = platform_get();
+	char profile[COMPLOG_PROFILE_MAX];
+	test_result_t tres;
+	size_t found = 0;
+	size_t i;
+	int res = 0;
+
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		int ret = analyze_case(platform, opts, cases[i], profile,
+				       &tres);
+
+		if (ret < 0)
+			continue;
+		if (ret)
+			res = 1;
+		if (!found && opts->csv && !opts->no_csv_header)
+			print_header_csv(opts);
+		if (!found && opts->json && !opts->no_csv_header)
+			print_header_json();
+		else if (found && opts->json)
+			print_separator_json();
+		if (!opts->csv && !opts->json)
+			printf("Profile: %s\n", opts->profile.name);
+		ret = print_test_results(cases[i], opts, &tres);
+		if (ret && !res)
+			res = ret;
+		result_free(platform, &tres);
+		++found;
+	}
+	if (!found) {
+		fprintf(stderr, "No completion logs at %s-<case>-0%s\n",
+			opts->analyze_log, COMPLOG_SUFFIX);
+		return 1;
+	}
+	if (opts->json && !opts->no_csv_header)
+		print_footer_json();
+
+	return res;
+}
+
+/* One class of workers of a mixed run, driven by its own thread */
+typedef struct mixed_class_t {
+	uint64_t thread;
+	const platform_t *platform;
+	const opts_t *opts;
+	void *(*tfunc)(void *);
+	test_result_t res;
+	int ret;
+} mixed_class_t;
+
+static void *run_mixed_class(void *arg)
+{
+	mixed_class_t *mc = (mixed_class_t *)arg;
+
+	mc->ret = collect_test_threads(mc->platform, mc->opts, mc->tfunc,
+				       &mc->res);
+
+	return NULL;
+}
+
+/*
+ * Mixed mode: writers ingest frames [frames, 2 * frames) while readers
+ * play back frames [0, frames) at the same time, so reads are measured
+ * under write load. Missing reader frames are written first, untimed.
+ */
+static int run_test_mixed(const platform_t *platform, const opts_t *opts)
+{
+	opts_t wopts = *opts;
+	opts_t ropts = *opts;
+	opts_t aopts = *opts;
+	mixed_class_t classes[2] = { { 0 } };
+	test_result_t tres = { 0 };
+	uint64_t start;
+	size_t i, started;
+	int res = 0;
+
+	wopts.first_frame = opts->frames;
+	wopts.complog_case = "write";
+	ropts.complog_case = "read";
+	ropts.threads = opts->read_threads ? opts->read_threads : opts->threads;
+	ropts.fps = opts->read_fps ? opts->read_fps : opts->fps;
+	ropts.reverse = opts->read_reverse;
+	ropts.random = opts->read_random;
+	/* Only a class with a frame rate has display deadlines */
+	wopts.playback = opts->playback && wopts.fps;
+	ropts.playback = opts->playback && ropts.fps;
+	aopts.threads = wopts.threads + ropts.threads;
+	aopts.fps = wopts.fps + ropts.fps;
+
+	if (!tester_frames_present(platform, opts->path, 0, opts->frames,
+				   opts->frm->size)) {
+		opts_t popts = *opts;
+
+		popts.fps = 0;
+		popts.playback = 0;
+		if (!opts->csv && !opts->json)
+			printf("Preparing %zu frames for the readers\n",
+			       opts->frames);
+		res = collect_test_threads(platform, &popts,
+					   &run_write_test_thread, &tres);
+		result_free(platform, &tres);
+		if (res)
+			return 1;
+		memset(&tres, 0, sizeof(tres));
+	}
+
+	classes[0].opts = &wopts;
+	classes[0].tfunc = &run_write_test_thread;
+	classes[1].opts = &ropts;
+	classes[1].tfunc = &run_read_test_thread;
+
+	start = timing_start();
+	for (started = 0; started < 2; started++) {
+		classes[started].platform = platform;
+		if (platform->thread_create(&classes[started].thread,
+					    &run_mixed_class,
+					    &classes[started]))
+			break;
+	}
+	for (i = 0; i < started; i++) {
+		void *ret;
+
+		if (platform->thread_join(classes[i].thread, &ret))
+			res = 1;
+	}
+	if (started < 2)
+		res = 1;
+	for (i = 0; i < started; i++) {
+		if (classes[i].ret)
+			res = 1;
+		else if (test_result_aggregate(&tres, &classes[i].res))
+			res = 1;
+	}
+	tres.time_taken_ns = timing_elapsed(start);
+	tres.filesystem_type = classes[0].res.filesystem_type;
+
+	if (!res) {
+		int ret;
+
+		if (opts->json && !opts->no_csv_header)
+			print_header_json();
+		res = print_test_results("write", &wopts, &classes[0].res);
+		if (opts->json)
+			print_separator_json();
+		ret = print_test_results("read", &ropts, &classes[1].res);
+		if (ret)
+			res = ret;
+		if (opts->json)
+			print_separator_json();
+		ret = print_test_results("mixed", &aopts, &tres);
+		if (ret)
+			res = ret;
+		if (opts->json && !opts->no_csv_header)
+			print_footer_json();
+	}
+	for (i = 0; i < 2; i++)
+		result_free(platform, &classes[i].res);
+	result_free(platform, &tres);
+
+	return res;
+}
+
+/*
+ * Saturation search: step the load up until a step drops frames, fails
+ * frames or misses the p99 budget, then bisect to the highest level that
+ * passes. With streams every virtual stream plays -n frames at -f.
+ */
+static int run_search(const platform_t *platform, const opts_t *opts)
+{
+	const char *what = opts->search == SEARCH_STREAMS ? "streams" : "fps";
+	void *(*tfunc)(void *) = (opts->mode & TEST_WRITE) ?
+					 &run_write_test_thread :
+					 &run_read_test_thread;
+	search_point_t *curve = NULL;
+	size_t cnt = 0;
+	search_t search;
+	size_t level;
+
+	if (opts->search == SEARCH_STREAMS)
+		search_init(&search, opts->vstreams, opts->search_max);
+	else
+		search_init(&search, opts->fps ? opts->fps : 24,
+			    opts->search_max);
+
+	for (level = search.level; level;) {
+		opts_t sopts = *opts;
+		test_result_t tres;
+		search_point_t *point;
+		search_point_t *tmp;
+
+		sopts.fps = level;
+		if (opts->search == SEARCH_STREAMS) {
+			sopts.vstreams = level;
+			sopts.fps = opts->fps * level;
+			sopts.frames = opts->frames * level;
+		}
+		/* Every thread needs a share of the frame rate to be paced */
+		if (sopts.threads > level)
+			sopts.threads = level;
+		sopts.playback = 1;
+
+		tmp = realloc(curve, sizeof(*curve) * (cnt + 1));
+		if (!tmp || collect_test_threads(platform, &sopts, tfunc,
+						 &tres)) {
+			free(tmp ? tmp : curve);
+			return 1;
+		}
+		curve = tmp;
+		point = &curve[cnt++];
+		memset(point, 0, sizeof(*point));
+		point->level = level;
+		point->frames = tres.frames_written;
+		if (tres.time_taken_ns)
+			point->fps = (double)tres.frames_written * SEC_IN_NS /
+				     tres.time_taken_ns;
+		point->late = tres.playback_stats.late;
+		point->dropped = tres.playback_stats.dropped;
+		point->failed = tres.frames_failed;
+		point->p99_ns = search_percentile(&tres, 99);
+		point->pass = test_result_playback_ok(&tres) &&
+			      !tres.frames_failed &&
+			      (!opts->search_p99 ||
+			       point->p99_ns <= opts->search_p99);
+		result_free(platform, &tres);
+
+		print_search_step(what, opts, point);
+		level = search_next(&search, point->pass);
+	}
+	print_search(what, opts, curve, cnt, search.pass);
+	free(curve);
+
+	return search.pass ? 0 : EXIT_PLAYBACK_FAILED;
+}
+
+/* I/O requests per frame, for the IOPS of a sweep */
+static size_t frame_requests(const opts_t *opts)
+{
+	size_t stripes = opts->stripes > 1 ? opts->stripes : 1;
+	size_t size = (opts->frm->size + stripes - 1) / stripes;
+
+	if (opts->request_size && size > opts->request_size)
+		return stripes * ((size + opts->request_size - 1) /
+				  opts->request_size);
+	return stripes;
+}
+
+/*
+ * Scaling sweep: one full run per combination of the thread counts and
+ * queue depths, each with fresh results, reported as a single table.
+ */
+static int run_sweep(const platform_t *platform, const opts_t *opts)
+{
+	const size_t *threads = opts->sweep_threads;
+	const size_t *depths = opts->sweep_depths;
+	size_t threads_cnt = opts->sweep_threads_cnt;
+	size_t depths_cnt = opts->sweep_depths_cnt;
+	void *(*tfunc)(void *) = (opts->mode & TEST_WRITE) ?
+					 &run_write_test_thread :
+					 &run_read_test_thread;
+	sweep_point_t *points;
+	size_t cnt = 0;
+	size_t i, j;
+
+	if (!threads_cnt) {
+		threads = &opts->threads;
+		threads_cnt = 1;
+	}
+	if (!depths_cnt) {
+		depths = &opts->queue_depth;
+		depths_cnt = 1;
+	}
+	points = calloc(threads_cnt * depths_cnt, sizeof(*points));
+	if (!points)
+		return 1;
 
-			/* Phase 2: Display I/O fallback statistics */
-			if (tres.frames_direct_io > 0 ||
-			    tres.frames_buffered_io > 0) {
-				fprintf(stdout,
-					"\n--- Phase 2: I/O Mode Statistics ---\n");
-				fprintf(stdout, "Frames with Direct I/O: %d\n",
-					tres.frames_direct_io);
-				fprintf(stdout,
-					"Frames with Buffered I/O (fallback): %d\n",
-					tres.frames_buffered_io);
-				fprintf(stdout,
-					"Direct I/O success rate: %.2f%%\n",
-					tres.direct_io_success_rate);
-				if (tres.fallback_count > 0) {
-					fprintf(stdout, "Fallback events: %d\n",
-						tres.fallback_count);
-				}
+	for (i = 0; i < threads_cnt; i++) {
+		for (j = 0; j < depths_cnt; j++) {
+			opts_t sopts = *opts;
+			test_result_t tres;
+			sweep_point_t *point = &points[cnt];
+
+			sopts.threads = threads[i];
+			sopts.queue_depth = depths[j];
+			if (collect_test_threads(platform, &sopts, tfunc,
+						 &tres)) {
+				free(points);
+				return 1;
 			}
-
-			if (opts->histogram)
-				print_histogram(&tres);
+			point->threads = sopts.threads;
+			point->depth = opts->engine == PLATFORM_ENGINE_SYNC ?
+					       1 :
+					       sopts.queue_depth;
+			sweep_point_fill(point, &tres, frame_requests(opts));
+			result_free(platform, &tres);
+			print_sweep_step(opts, point);
+			++cnt;
 		}
 	}
-	result_free(platform, &tres);
-	platform->free(threads);
-	return res;
+	sweep_efficiency(points, cnt);
+	print_sweep(opts, points, cnt);
+	free(points);
+
+	return 0;
 }
 
 #ifndef NO_TUI
@@ -390,6 +1529,7 @@ int run_test_threads_tui(const platform_t *platform, const char *tst,
 	int res;
 	thread_info_t *threads;
 	test_result_t tres = { 0 };
+	tester_dispatch_t dispatch = { 0 };
 	tui_progress_t progress = { 0 };
 	tui_metrics_t metrics;
 	uint64_t start;
@@ -412,6 +1552,11 @@ int run_test_threads_tui(const platform_t *platform, const char *tst,
 		platform->free(threads);
 		return run_test_threads(platform, tst, opts, tfunc);
 	}
+	if (dispatch_setup(platform, opts, threads, &dispatch)) {
+		tui_cleanup();
+		platform->free(threads);
+		return 1;
+	}
 
 	/* Initialize TUI metrics */
 	tui_metrics_init(&metrics, opts->profile.name, opts->path,
@@ -432,8 +1577,7 @@ int run_test_threads_tui(const platform_t *platform, const char *tst,
 		threads[i].opts = opts;
 		threads[i].tui_progress = &progress;
 
-		thread_res = platform->thread_create(&threads[i].thread, tfunc,
-						     (void *)&threads[i]);
+		thread_res = worker_start(platform, opts, &threads[i], tfunc);
 		if (thread_res) {
 			size_t j;
 			void *ret;
@@ -443,11 +1587,21 @@ int run_test_threads_tui(const platform_t *platform, const char *tst,
 			for (j = 0; j < i; j++)
 				platform->thread_join(threads[j].thread, &ret);
 			tui_cleanup();
+			tester_dispatch_free(platform, &dispatch);
 			platform->free(threads);
 			return 1;
 		}
 	}
 
+	/* Keep rendering off the worker CPUs, the workers are placed already */
+	if (opts->tui_cpus.cnt) {
+		platform_thread_attr_t attr = { .cpus = opts->tui_cpus };
+
+		if (platform->thread_set_attr(&attr))
+			fprintf(stderr, "WARNING: Can't pin the TUI to "
+					"--tui-cpus\n");
+	}
+
 	/* TUI update loop - poll progress and render until all threads complete */
 	while (progress.running) {
 		uint64_t now = timing_start();
@@ -502,6 +1656,7 @@ int run_test_threads_tui(const platform_t *platform, const char *tst,
 			res = 1;
 		result_free(platform, &threads[i].res);
 	}
+	tester_dispatch_free(platform, &dispatch);
 
 	tres.time_taken_ns = timing_elapsed(start);
 
@@ -514,29 +1669,20 @@ int run_test_threads_tui(const platform_t *platform, const char *tst,
 	metrics.frames_direct_io = tres.frames_direct_io;
 	metrics.frames_buffered_io = tres.frames_buffered_io;
 
-	/* Calculate percentiles from completion data */
-	if (tres.completion && tres.frames_written > 0) {
-		uint64_t *frame_times = platform->malloc(tres.frames_written *
-							 sizeof(uint64_t));
-		if (frame_times) {
-			for (i = 0; i < tres.frames_written; i++) {
-				frame_times[i] = tres.completion[i].frame -
-						 tres.completion[i].start;
-			}
-			tui_percentiles_t percs = tui_calculate_percentiles(
-				frame_times, tres.frames_written);
-			metrics.latency_p50_ns = percs.p50;
-			metrics.latency_p95_ns = percs.p95;
-			metrics.latency_p99_ns = percs.p99;
-			metrics.latency_min_ns = tres.min_frame_time_ns;
-			metrics.latency_max_ns = tres.max_frame_time_ns;
-			platform->free(frame_times);
-		}
+	/* Percentiles from the histogram recorded during the run */
+	if (tres.hist && tres.hist->total) {
+		metrics.latency_p50_ns = hist_percentile(tres.hist, 50);
+		metrics.latency_p95_ns = hist_percentile(tres.hist, 95);
+		metrics.latency_p99_ns = hist_percentile(tres.hist, 99);
+		metrics.latency_min_ns = tres.hist->min;
+		metrics.latency_max_ns = tres.hist->max;
 	}
 
 	/* Cleanup TUI and show final summary */
 	tui_cleanup();
 	tui_render_summary(&metrics, &tres);
+	if (!res && tres.playback && !test_result_playback_ok(&tres))
+		res = EXIT_PLAYBACK_FAILED;
 
 	result_free(platform, &tres);
 	platform->free(threads);
@@ -544,9 +1690,19 @@ int run_test_threads_tui(const platform_t *platform, const char *tst,
 }
 #endif /* NO_TUI */
 
+/* Header line of a --warmup/--cooldown window */
+static void print_window(const char *what, size_t frames, uint64_t ns)
+{
+	if (frames)
+		printf("%s: %zu frames excluded\n", what, frames);
+	else
+		printf("%s: %.3f s excluded\n", what, (double)ns / SEC_IN_NS);
+}
+
 int run_tests(opts_t *opts)
 {
 	const platform_t *platform = NULL;
+	int ret = 0;
 
 	if (!opts)
 		return 1;
@@ -597,9 +1753,12 @@ int run_tests(opts_t *opts)
 		return 1;
 	}
 
-	if (opts->mode & TEST_WRITE)
+	if (opts->mode & TEST_WRITE) {
 		opts->frm = frame_gen(platform, opts->profile);
-	else if (opts->mode & TEST_READ) {
+		if (opts->frm && opts->fill_random)
+			frame_fill_random(opts->frm->data, opts->frm->size,
+					  opts->seed, opts->fill_compress);
+	} else if (opts->mode & TEST_READ) {
 		if (opts->single_file || opts->profile.prof != PROF_INVALID)
 			opts->frm = frame_gen(platform, opts->profile);
 		if (!opts->frm) {
@@ -613,12 +1772,177 @@ int run_tests(opts_t *opts)
 		}
 		opts->profile = opts->frm->profile;
 	}
-	if (!opts->csv && !opts->json && !opts->tui)
+	if (!platform_engine_available(opts->engine)) {
+		fprintf(stderr, "I/O engine '%s' is not available\n",
+			platform_engine_name(opts->engine));
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->preopen &&
+	    (opts->engine != PLATFORM_ENGINE_SYNC || opts->stripes > 1)) {
+		fprintf(stderr,
+			"--preopen requires the sync I/O engine without stripes\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	/* A stream without its share of -f would run unpaced */
+	if (opts->vstreams &&
+	    (opts->preopen || opts->stripes > 1 || opts->tui ||
+	     opts->vstreams > opts->frames ||
+	     (opts->fps && opts->vstreams > opts->fps))) {
+		fprintf(stderr, "--streams needs at least one frame and one "
+				"fps per stream and can't be combined with "
+				"--preopen, --stripes or --tui\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	/* Event loops beyond one per stream would sit idle */
+	if (opts->vstreams && opts->threads > opts->vstreams)
+		opts->threads = opts->vstreams;
+	if (opts->mixed &&
+	    (!(opts->mode & TEST_WRITE) || opts->single_file || opts->tui ||
+	     opts->vstreams)) {
+		fprintf(stderr, "--mixed needs a write profile (-w) and can't "
+				"be combined with --streaming, --streams "
+				"or --tui\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->duration && opts->tui) {
+		fprintf(stderr, "--duration can't be combined with --tui\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->numa && opts->tui) {
+		fprintf(stderr, "--numa can't be combined with --tui\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->numa == NUMA_PLACE_NODE && !numa_node_usable(opts)) {
+		fprintf(stderr, "NUMA node %d has no CPUs\n", opts->numa_node);
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->fill_random && opts->tui) {
+		fprintf(stderr, "--fill random can't be combined with --tui\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->worker_attr.cpus.cnt && opts->numa) {
+		fprintf(stderr, "--cpus can't be combined with --numa\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->tui_cpus.cnt && (!opts->tui || !opts->worker_attr.cpus.cnt ||
+				   cpuset_overlap(&opts->tui_cpus,
+						  &opts->worker_attr.cpus))) {
+		fprintf(stderr, "--tui-cpus needs --tui and a --cpus list it "
+				"doesn't overlap\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if ((opts_worker_attr_set(opts) && !platform->thread_create_attr) ||
+	    (opts->tui_cpus.cnt && !platform->thread_set_attr)) {
+		fprintf(stderr, "--cpus, --tui-cpus, --sched, --nice and "
+				"--ioprio aren't supported on this platform\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if ((opts->sweep_threads_cnt || opts->sweep_depths_cnt) &&
+	    (opts->mixed || opts->tui || opts->search || opts->vstreams ||
+	     (opts->sweep_depths_cnt &&
+	      opts->engine == PLATFORM_ENGINE_SYNC))) {
+		fprintf(stderr, "--sweep-threads/--sweep-queue-depth can't be "
+				"combined with --mixed, --search, --streams or "
+				"--tui, queue depths need an async --io-engine\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->search &&
+	    (opts->mixed || opts->tui ||
+	     (opts->search == SEARCH_STREAMS &&
+	      (!opts->fps || opts->preopen || opts->stripes > 1)))) {
+		fprintf(stderr, "--search can't be combined with --mixed or "
+				"--tui, --search streams needs the per-stream "
+				"frame rate (--fps) and no --preopen or "
+				"--stripes\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->complog &&
+	    (opts->tui || opts->search || opts->sweep_threads_cnt ||
+	     opts->sweep_depths_cnt)) {
+		fprintf(stderr, "--log can't be combined with --tui, --search "
+				"or --sweep-threads/--sweep-queue-depth\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (opts->playback && !opts->fps && !(opts->mixed && opts->read_fps)) {
+		fprintf(stderr, "--playback requires a frame rate (--fps)\n");
+		frame_destroy(platform, opts->frm);
+		return 1;
+	}
+	if (!opts->csv && !opts->json && !opts->tui) {
 		printf("Profile: %s\n", opts->profile.name);
+		if (opts->engine != PLATFORM_ENGINE_SYNC)
+			printf("I/O engine: %s (queue depth %zu)\n",
+			       platform_engine_name(opts->engine),
+			       opts->queue_depth);
+		if (opts->request_size)
+			printf("Request size: %zu\n", opts->request_size);
+		if (opts->stripes > 1)
+			printf("Stripes: %zu per frame\n", opts->stripes);
+		if (opts->fill_random && (opts->mode & TEST_WRITE))
+			printf("Frame content: random, %u%% compressible, "
+			       "seed %" PRIu64 "\n",
+			       opts->fill_compress, opts->seed);
+		if (opts->duration)
+			printf("Duration: %.3f s over %zu frames\n",
+			       (double)opts->duration / SEC_IN_NS,
+			       opts->frames);
+		if (opts->warmup_frames || opts->warmup)
+			print_window("Warm-up", opts->warmup_frames,
+				     opts->warmup);
+		if (opts->cooldown_frames || opts->cooldown)
+			print_window("Cool-down", opts->cooldown_frames,
+				     opts->cooldown);
+		if (opts->vstreams)
+			printf("Virtual streams: %zu on %zu threads\n",
+			       opts->vstreams, opts->threads);
+		if (opts->search)
+			printf("Search: %s\n", opts->search == SEARCH_STREAMS ?
+							"streams" :
+							"fps");
+		if (opts->search_p99)
+			printf("Search p99 budget: %.3f ms\n",
+			       opts->search_p99 / SEC_IN_MS);
+		if (opts->mixed)
+			printf("Mixed: %zu writer and %zu reader threads\n",
+			       opts->threads,
+			       opts->read_threads ? opts->read_threads :
+						    opts->threads);
+	}
 
-	if (opts->csv && !opts->no_csv_header)
+	if (opts->csv && !opts->no_csv_header && !opts->search &&
+	    !opts->sweep_threads_cnt && !opts->sweep_depths_cnt)
 		print_header_csv(opts);
 
+	if (opts->sweep_threads_cnt || opts->sweep_depths_cnt) {
+		ret = run_sweep(platform, opts);
+		frame_destroy(platform, opts->frm);
+		return ret;
+	}
+	if (opts->search) {
+		ret = run_search(platform, opts);
+		frame_destroy(platform, opts->frm);
+		return ret;
+	}
+	if (opts->mixed) {
+		ret = run_test_mixed(platform, opts);
+		frame_destroy(platform, opts->frm);
+		return ret;
+	}
+
 	/* Select appropriate test runner based on TUI mode */
 #ifndef NO_TUI
 	if (opts->tui) {
@@ -628,12 +1952,20 @@ int run_tests(opts_t *opts)
 				fprintf(stderr, "Can't allocate frame\n");
 				return 1;
 			}
-			run_test_threads_tui(platform, "write", opts,
-					     &run_write_test_thread_tui);
+			stream_open(platform, opts, TEST_OP_WRITE);
+			if (run_test_threads_tui(platform, "write", opts,
+						 &run_write_test_thread_tui) ==
+			    EXIT_PLAYBACK_FAILED)
+				ret = EXIT_PLAYBACK_FAILED;
+			stream_close(platform, opts);
 		}
 		if (opts->mode & TEST_READ) {
-			run_test_threads_tui(platform, "read", opts,
-					     &run_read_test_thread_tui);
+			stream_open(platform, opts, TEST_OP_READ);
+			if (run_test_threads_tui(platform, "read", opts,
+						 &run_read_test_thread_tui) ==
+			    EXIT_PLAYBACK_FAILED)
+				ret = EXIT_PLAYBACK_FAILED;
+			stream_close(platform, opts);
 		}
 	} else
 #endif
@@ -644,124 +1976,617 @@ int run_tests(opts_t *opts)
 				fprintf(stderr, "Can't allocate frame\n");
 				return 1;
 			}
-			run_test_threads(platform, "write", opts,
-					 &run_write_test_thread);
+			stream_open(platform, opts, TEST_OP_WRITE);
+			if (run_test_threads(platform, "write", opts,
+					     &run_write_test_thread) ==
+			    EXIT_PLAYBACK_FAILED)
+				ret = EXIT_PLAYBACK_FAILED;
+			stream_close(platform, opts);
 		}
 		if (opts->mode & TEST_READ) {
-			run_test_threads(platform, "read", opts,
-					 &run_read_test_thread);
+			stream_open(platform, opts, TEST_OP_READ);
+			if (run_test_threads(platform, "read", opts,
+					     &run_read_test_thread) ==
+			    EXIT_PLAYBACK_FAILED)
+				ret = EXIT_PLAYBACK_FAILED;
+			stream_close(platform, opts);
 		}
 	}
-	frame_destroy(platform, opts->frm);
+	frame_destroy(platform, opts->frm);
+
+	return ret;
+}
+
+int opt_parse_frame_size_helper(opts_t *opt, const char *arg,
+				enum ProfileType *prof, size_t *sz)
+{
+	char *endp = NULL;
+
+	if (!strcmp(arg, "sd") || !strcmp(arg, "SD")) {
+		*prof = PROF_SD;
+		return 0;
+	} else if (!strcmp(arg, "hd") || !strcmp(arg, "HD")) {
+		*prof = PROF_HD;
+		return 0;
+	} else if (!strcmp(arg, "fullhd") || !strcmp(arg, "FULLHD")) {
+		*prof = PROF_FULLHD;
+		return 0;
+	} else if (!strcmp(arg, "2k") || !strcmp(arg, "2K")) {
+		*prof = PROF_2K;
+		return 0;
+	} else if (!strcmp(arg, "4k") || !strcmp(arg, "4K")) {
+		*prof = PROF_4K;
+		return 0;
+	} else if (!strcmp(arg, "8k") || !strcmp(arg, "8K")) {
+		*prof = PROF_8K;
+		return 0;
+	}
+
+	*sz = strtoll(arg, &endp, 10);
+	if (!endp || *endp != 0 || !*sz)
+		return 1;
+
+	return 0;
+}
+
+int opt_parse_write(opts_t *opt, const char *arg)
+{
+	return opt_parse_frame_size_helper(opt, arg, &opt->prof,
+					   &opt->write_size);
+}
+
+int opt_parse_profile(opts_t *opt, const char *arg)
+{
+	profile_t prof;
+
+	if (!arg)
+		return 1;
+
+	/* Try to get profile by name first */
+	prof = profile_get_by_name(arg);
+	if (prof.prof != PROF_INVALID) {
+		opt->profile = prof;
+		return 0;
+	}
+
+	/* Try to parse as custom resolution (WIDTHxHEIGHTxBITS) */
+	prof = profile_parse_custom(arg);
+	if (prof.width > 0 && prof.height > 0) {
+		opt->profile = prof;
+		return 0;
+	}
+
+	return 1;
+}
+
+static inline int parse_arg_size_t(const char *arg, size_t *res, int zero_ok)
+{
+	char *endp = NULL;
+	size_t val;
+
+	if (!arg || !res)
+		return 1;
+
+	val = strtoll(arg, &endp, 10);
+	if (!endp || *endp != 0)
+		return 1;
+	if (!zero_ok && !val)
+		return 1;
+
+	*res = val;
+
+	return 0;
+}
+
+int opt_parse_threads(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->threads, 0);
+}
+
+int opt_parse_num_frames(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->frames, 0);
+}
+
+int opt_parse_limit_fps(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->fps, 0);
+}
+
+int opt_parse_header_size(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->header_size, 1);
+}
+
+int opt_parse_frame_size(opts_t *opt, const char *arg)
+{
+	return opt_parse_frame_size_helper(opt, arg, &opt->stream_prof,
+					   &opt->frame_size);
+}
+
+int opt_parse_io_engine(opts_t *opt, const char *arg)
+{
+	if (!arg)
+		return 1;
+	if (!strcmp(arg, "sync"))
+		opt->engine = PLATFORM_ENGINE_SYNC;
+	else if (!strcmp(arg, "uring") || !strcmp(arg, "io_uring"))
+		opt->engine = PLATFORM_ENGINE_URING;
+	else if (!strcmp(arg, "threads"))
+		opt->engine = PLATFORM_ENGINE_THREADS;
+	else
+		return 1;
+
+	return 0;
+}
+
+/* Byte count with an optional k, M or G suffix */
+static int parse_arg_bytes(const char *arg, size_t *res)
+{
+	char *endp = NULL;
+	size_t val;
+
+	if (!arg)
+		return 1;
+
+	val = strtoull(arg, &endp, 10);
+	if (!endp)
+		return 1;
+	switch (*endp) {
+	case 'k':
+	case 'K':
+		val *= 1024;
+		++endp;
+		break;
+	case 'm':
+	case 'M':
+		val *= 1024 * 1024;
+		++endp;
+		break;
+	case 'g':
+	case 'G':
+		val *= 1024 * 1024 * 1024UL;
+		++endp;
+		break;
+	default:
+		break;
+	}
+	if (*endp != 0)
+		return 1;
+
+	*res = val;
+
+	return 0;
+}
+
+int opt_parse_request_size(opts_t *opt, const char *arg)
+{
+	size_t val;
+
+	if (parse_arg_bytes(arg, &val))
+		return 1;
+	/* Sub-requests have to stay aligned for direct I/O */
+	if (val % ALIGN_SIZE)
+		return 1;
+
+	opt->request_size = val;
+
+	return 0;
+}
+
+int opt_parse_buffer_budget(opts_t *opt, const char *arg)
+{
+	return parse_arg_bytes(arg, &opt->buffer_budget);
+}
+
+int opt_parse_numa(opts_t *opt, const char *arg)
+{
+	char *endp = NULL;
+	long node;
+
+	if (!arg)
+		return 1;
+
+	if (!strcmp(arg, "off")) {
+		opt->numa = NUMA_PLACE_OFF;
+	} else if (!strcmp(arg, "rr")) {
+		opt->numa = NUMA_PLACE_RR;
+	} else if (!strcmp(arg, "near")) {
+		opt->numa = NUMA_PLACE_NEAR;
+	} else {
+		node = strtol(arg, &endp, 10);
+		if (endp == arg || *endp || node < 0 || node > INT_MAX)
+			return 1;
+		opt->numa = NUMA_PLACE_NODE;
+		opt->numa_node = (int)node;
+	}
+
+	return 0;
+}
+
+int opt_parse_cpus(platform_cpuset_t *set, const char *arg)
+{
+	if (!arg || numa_parse_cpulist(arg, set) || !set->cnt)
+		return 1;
+
+	return 0;
+}
+
+/* Split "name:N" into name and N, def without the number */
+static int opt_parse_class(const char *arg, const char *name, long min,
+			   long max, long def, long *res)
+{
+	size_t len = strlen(name);
+	char *endp = NULL;
+
+	if (strncmp(arg, name, len))
+		return 0;
+	if (!arg[len]) {
+		*res = def;
+		return 1;
+	}
+	if (arg[len] != ':')
+		return 0;
+	*res = strtol(arg + len + 1, &endp, 10);
+	if (endp == arg + len + 1 || *endp || *res < min || *res > max)
+		return -1;
+
+	return 1;
+}
+
+int opt_parse_sched(opts_t *opt, const char *arg)
+{
+	platform_thread_attr_t *attr = &opt->worker_attr;
+	long prio = 0;
+	int res;
+
+	if (!arg)
+		return 1;
+
+	if (!strcmp(arg, "other")) {
+		attr->sched = PLATFORM_SCHED_OTHER;
+		attr->priority = 0;
+		return 0;
+	}
+	res = opt_parse_class(arg, "fifo", 1, 99, 1, &prio);
+	if (res > 0) {
+		attr->sched = PLATFORM_SCHED_FIFO;
+	} else if (!res) {
+		res = opt_parse_class(arg, "rr", 1, 99, 1, &prio);
+		if (res > 0)
+			attr->sched = PLATFORM_SCHED_RR;
+	}
+	if (res <= 0)
+		return 1;
+	attr->priority = (int)prio;
 
 	return 0;
 }
 
-int opt_parse_frame_size_helper(opts_t *opt, const char *arg,
-				enum ProfileType *prof, size_t *sz)
+int opt_parse_nice(opts_t *opt, const char *arg)
 {
 	char *endp = NULL;
+	long nice;
 
-	if (!strcmp(arg, "sd") || !strcmp(arg, "SD")) {
-		*prof = PROF_SD;
-		return 0;
-	} else if (!strcmp(arg, "hd") || !strcmp(arg, "HD")) {
-		*prof = PROF_HD;
-		return 0;
-	} else if (!strcmp(arg, "fullhd") || !strcmp(arg, "FULLHD")) {
-		*prof = PROF_FULLHD;
-		return 0;
-	} else if (!strcmp(arg, "2k") || !strcmp(arg, "2K")) {
-		*prof = PROF_2K;
-		return 0;
-	} else if (!strcmp(arg, "4k") || !strcmp(arg, "4K")) {
-		*prof = PROF_4K;
-		return 0;
-	} else if (!strcmp(arg, "8k") || !strcmp(arg, "8K")) {
-		*prof = PROF_8K;
+	if (!arg)
+		return 1;
+
+	nice = strtol(arg, &endp, 10);
+	if (endp == arg || *endp || nice < -20 || nice > 19)
+		return 1;
+	opt->worker_attr.nice = (int)nice;
+
+	return 0;
+}
+
+int opt_parse_ioprio(opts_t *opt, const char *arg)
+{
+	platform_thread_attr_t *attr = &opt->worker_attr;
+	long level = 0;
+	int res;
+
+	if (!arg)
+		return 1;
+
+	if (!strcmp(arg, "idle")) {
+		attr->ioprio = PLATFORM_IOPRIO_IDLE;
+		attr->ioprio_level = 0;
 		return 0;
 	}
+	res = opt_parse_class(arg, "rt", 0, 7, 4, &level);
+	if (res > 0) {
+		attr->ioprio = PLATFORM_IOPRIO_RT;
+	} else if (!res) {
+		res = opt_parse_class(arg, "be", 0, 7, 4, &level);
+		if (res > 0)
+			attr->ioprio = PLATFORM_IOPRIO_BE;
+	}
+	if (res <= 0)
+		return 1;
+	attr->ioprio_level = (int)level;
 
-	*sz = strtoll(arg, &endp, 10);
-	if (!endp || *endp != 0 || !*sz)
+	return 0;
+}
+
+int opt_parse_fill(opts_t *opt, const char *arg)
+{
+	long compress = 0;
+
+	if (!arg)
+		return 1;
+
+	if (!strcmp(arg, "const")) {
+		opt->fill_random = 0;
+		return 0;
+	}
+	if (opt_parse_class(arg, "random", 0, FRAME_COMPRESS_MAX, 0,
+			    &compress) <= 0)
 		return 1;
+	opt->fill_random = 1;
+	opt->fill_compress = (unsigned int)compress;
 
 	return 0;
 }
 
-int opt_parse_write(opts_t *opt, const char *arg)
+int opt_parse_seed(opts_t *opt, const char *arg)
 {
-	return opt_parse_frame_size_helper(opt, arg, &opt->prof,
-					   &opt->write_size);
+	char *endp = NULL;
+
+	if (!arg || *arg < '0' || *arg > '9')
+		return 1;
+
+	errno = 0;
+	opt->seed = (uint64_t)strtoull(arg, &endp, 0);
+	if (*endp || errno)
+		return 1;
+
+	return 0;
 }
 
-int opt_parse_profile(opts_t *opt, const char *arg)
+int opt_parse_huge_pages(opts_t *opt, const char *arg)
 {
-	profile_t prof;
+	if (!arg)
+		return 1;
+
+	if (!strcmp(arg, "off"))
+		opt->huge_pages = PLATFORM_PAGES_DEFAULT;
+	else if (!strcmp(arg, "thp"))
+		opt->huge_pages = PLATFORM_PAGES_THP;
+	else if (!strcmp(arg, "2m") || !strcmp(arg, "2M"))
+		opt->huge_pages = PLATFORM_PAGES_HUGE_2M;
+	else if (!strcmp(arg, "1g") || !strcmp(arg, "1G"))
+		opt->huge_pages = PLATFORM_PAGES_HUGE_1G;
+	else
+		return 1;
 
+	return 0;
+}
+
+int opt_parse_schedule(opts_t *opt, const char *arg)
+{
 	if (!arg)
 		return 1;
+	if (!strcmp(arg, "dynamic"))
+		opt->static_schedule = 0;
+	else if (!strcmp(arg, "static"))
+		opt->static_schedule = 1;
+	else
+		return 1;
 
-	/* Try to get profile by name first */
-	prof = profile_get_by_name(arg);
-	if (prof.prof != PROF_INVALID) {
-		opt->profile = prof;
-		return 0;
+	return 0;
+}
+
+int opt_parse_stripes(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->stripes, 0);
+}
+
+int opt_parse_pace_spin(opts_t *opt, const char *arg)
+{
+	size_t usec;
+
+	if (parse_arg_size_t(arg, &usec, 1))
+		return 1;
+	opt->pace_spin = (uint64_t)usec * 1000;
+
+	return 0;
+}
+
+/*
+ * Seconds with an optional s, m or h suffix into ns. With suffixed set a
+ * bare number is rejected, the caller reads it as something else.
+ */
+static int parse_arg_time(const char *arg, uint64_t *ns, int suffixed)
+{
+	char *endp = NULL;
+	double val;
+
+	if (!arg)
+		return 1;
+	val = strtod(arg, &endp);
+	if (!endp || endp == arg || val <= 0)
+		return 1;
+	switch (*endp) {
+	case 'h':
+		val *= 60;
+		/* fallthrough */
+	case 'm':
+		val *= 60;
+		/* fallthrough */
+	case 's':
+		++endp;
+		break;
+	default:
+		if (suffixed)
+			return 1;
+		break;
 	}
+	if (*endp != 0)
+		return 1;
+	*ns = (uint64_t)(val * SEC_IN_NS);
 
-	/* Try to parse as custom resolution (WIDTHxHEIGHTxBITS) */
-	prof = profile_parse_custom(arg);
-	if (prof.width > 0 && prof.height > 0) {
-		opt->profile = prof;
+	return 0;
+}
+
+int opt_parse_duration(opts_t *opt, const char *arg)
+{
+	return parse_arg_time(arg, &opt->duration, 0);
+}
+
+/* A frame count, or a time with a suffix */
+static int parse_arg_window(const char *arg, size_t *frames, uint64_t *ns)
+{
+	char *endp = NULL;
+	size_t val;
+
+	if (!arg)
+		return 1;
+	val = strtoul(arg, &endp, 10);
+	if (endp != arg && *endp == 0) {
+		*frames = val;
+		*ns = 0;
 		return 0;
 	}
+	*frames = 0;
 
-	return 1;
+	return parse_arg_time(arg, ns, 1);
 }
 
-static inline int parse_arg_size_t(const char *arg, size_t *res, int zero_ok)
+int opt_parse_hist_digits(opts_t *opt, const char *arg)
 {
 	char *endp = NULL;
-	size_t val;
+	unsigned long val;
 
-	if (!arg || !res)
+	if (!arg)
+		return 1;
+	val = strtoul(arg, &endp, 10);
+	if (!endp || *endp != 0 || !val || val > HIST_DIGITS_MAX)
 		return 1;
+	opt->hist_digits = val;
 
-	val = strtoll(arg, &endp, 10);
-	if (!endp || *endp != 0)
+	return 0;
+}
+
+int opt_parse_warmup(opts_t *opt, const char *arg)
+{
+	return parse_arg_window(arg, &opt->warmup_frames, &opt->warmup);
+}
+
+int opt_parse_cooldown(opts_t *opt, const char *arg)
+{
+	return parse_arg_window(arg, &opt->cooldown_frames, &opt->cooldown);
+}
+
+int opt_parse_vstreams(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->vstreams, 0);
+}
+
+int opt_parse_prebuffer(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->prebuffer, 1);
+}
+
+int opt_parse_read_threads(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->read_threads, 0);
+}
+
+int opt_parse_read_fps(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->read_fps, 0);
+}
+
+int opt_parse_read_order(opts_t *opt, const char *arg)
+{
+	if (!arg)
 		return 1;
-	if (!zero_ok && !val)
+	opt->read_reverse = 0;
+	opt->read_random = 0;
+	if (!strcmp(arg, "reverse"))
+		opt->read_reverse = 1;
+	else if (!strcmp(arg, "random"))
+		opt->read_random = 1;
+	else if (strcmp(arg, "normal"))
 		return 1;
 
-	*res = val;
+	return 0;
+}
+
+int opt_parse_search(opts_t *opt, const char *arg)
+{
+	if (!arg)
+		return 1;
+	if (!strcmp(arg, "fps"))
+		opt->search = SEARCH_FPS;
+	else if (!strcmp(arg, "streams"))
+		opt->search = SEARCH_STREAMS;
+	else
+		return 1;
 
 	return 0;
 }
 
-int opt_parse_threads(opts_t *opt, const char *arg)
+int opt_parse_search_max(opts_t *opt, const char *arg)
 {
-	return parse_arg_size_t(arg, &opt->threads, 0);
+	return parse_arg_size_t(arg, &opt->search_max, 0);
 }
 
-int opt_parse_num_frames(opts_t *opt, const char *arg)
+int opt_parse_search_p99(opts_t *opt, const char *arg)
 {
-	return parse_arg_size_t(arg, &opt->frames, 0);
+	char *endp = NULL;
+	double ms;
+
+	if (!arg)
+		return 1;
+	ms = strtod(arg, &endp);
+	if (!endp || *endp != 0 || ms <= 0)
+		return 1;
+	opt->search_p99 = (uint64_t)(ms * SEC_IN_MS);
+
+	return 0;
 }
 
-int opt_parse_limit_fps(opts_t *opt, const char *arg)
+/* Comma separated list of positive sizes, e.g. 1,2,4,8 */
+static int parse_arg_size_list(const char *arg, size_t *res, size_t *cnt)
 {
-	return parse_arg_size_t(arg, &opt->fps, 0);
+	const char *p = arg;
+	char *endp = NULL;
+
+	if (!arg)
+		return 1;
+	*cnt = 0;
+	while (*p) {
+		size_t val = strtoul(p, &endp, 10);
+
+		if (endp == p || !val || *cnt == SWEEP_MAX)
+			return 1;
+		res[(*cnt)++] = val;
+		if (*endp == ',')
+			++endp;
+		else if (*endp)
+			return 1;
+		p = endp;
+	}
+
+	return *cnt ? 0 : 1;
 }
 
-int opt_parse_header_size(opts_t *opt, const char *arg)
+int opt_parse_sweep_threads(opts_t *opt, const char *arg)
 {
-	return parse_arg_size_t(arg, &opt->header_size, 1);
+	return parse_arg_size_list(arg, opt->sweep_threads,
+				   &opt->sweep_threads_cnt);
 }
 
-int opt_parse_frame_size(opts_t *opt, const char *arg)
+int opt_parse_sweep_depths(opts_t *opt, const char *arg)
 {
-	return opt_parse_frame_size_helper(opt, arg, &opt->stream_prof,
-					   &opt->frame_size);
+	return parse_arg_size_list(arg, opt->sweep_depths,
+				   &opt->sweep_depths_cnt);
+}
+
+int opt_parse_queue_depth(opts_t *opt, const char *arg)
+{
+	return parse_arg_size_t(arg, &opt->queue_depth, 0);
 }
 
 void list_profiles(const char *filter)
@@ -804,6 +2629,26 @@ static struct option long_opts[] = {
 	{ "threads", required_argument, 0, 't' },
 	{ "num-frames", required_argument, 0, 'n' },
 	{ "fps", required_argument, 0, 'f' },
+	{ "duration", required_argument, 0, 0 },
+	{ "warmup", required_argument, 0, 0 },
+	{ "hist-digits", required_argument, 0, 0 },
+	{ "hist-export", required_argument, 0, 0 },
+	{ "log", required_argument, 0, 0 },
+	{ "analyze-log", required_argument, 0, 0 },
+	{ "cooldown", required_argument, 0, 0 },
+	{ "pace-spin", required_argument, 0, 0 },
+	{ "playback", no_argument, 0, 0 },
+	{ "streams", required_argument, 0, 0 },
+	{ "prebuffer", required_argument, 0, 0 },
+	{ "mixed", no_argument, 0, 0 },
+	{ "read-threads", required_argument, 0, 0 },
+	{ "read-fps", required_argument, 0, 0 },
+	{ "read-order", required_argument, 0, 0 },
+	{ "search", required_argument, 0, 0 },
+	{ "search-max", required_argument, 0, 0 },
+	{ "search-p99", required_argument, 0, 0 },
+	{ "sweep-threads", required_argument, 0, 0 },
+	{ "sweep-queue-depth", required_argument, 0, 0 },
 	{ "reverse", no_argument, 0, 'v' },
 	{ "random", no_argument, 0, 'm' },
 	{ "csv", no_argument, 0, 'c' },
@@ -813,6 +2658,22 @@ static struct option long_opts[] = {
 	{ "times", no_argument, 0, 0 },
 	{ "frametimes", no_argument, 0, 0 },
 	{ "histogram", no_argument, 0, 0 },
+	{ "io-engine", required_argument, 0, 0 },
+	{ "queue-depth", required_argument, 0, 0 },
+	{ "preopen", no_argument, 0, 0 },
+	{ "request-size", required_argument, 0, 0 },
+	{ "stripes", required_argument, 0, 0 },
+	{ "buffer-budget", required_argument, 0, 0 },
+	{ "huge-pages", required_argument, 0, 0 },
+	{ "numa", required_argument, 0, 0 },
+	{ "cpus", required_argument, 0, 0 },
+	{ "tui-cpus", required_argument, 0, 0 },
+	{ "sched", required_argument, 0, 0 },
+	{ "nice", required_argument, 0, 0 },
+	{ "ioprio", required_argument, 0, 0 },
+	{ "fill", required_argument, 0, 0 },
+	{ "seed", required_argument, 0, 0 },
+	{ "schedule", required_argument, 0, 0 },
 	{ "tui", no_argument, 0, 0 },
 	{ "no-metrics", no_argument, 0, 0 },
 	{ "interactive", no_argument, 0, 'i' },
@@ -834,6 +2695,26 @@ static struct long_opt_desc long_opt_descs[] = {
 	{ "threads", "Use number of threads (default 1)" },
 	{ "num-frames", "Write number of frames (default 1800)" },
 	{ "fps", "Limit frame rate to frames per second" },
+	{ "duration", "Run for this long (e.g. 90, 30m, 2h), looping over the frames" },
+	{ "warmup", "Leave the first N frames (or e.g. 5s) out of the statistics" },
+	{ "hist-digits", "Significant digits of the completion histograms (1-5, default 3)" },
+	{ "hist-export", "Write the percentile distributions to PREFIX-<case>.hgrm" },
+	{ "log", "Stream every completion to PREFIX-<case>-<worker>.vfl" },
+	{ "analyze-log", "Report on the --log files at PREFIX instead of testing" },
+	{ "cooldown", "Leave the last N frames (or e.g. 5s) out of the statistics" },
+	{ "pace-spin", "With --fps, busy-wait the last N microseconds before each frame" },
+	{ "playback", "With --fps, qualify playback: count frames late for display, exit 2 on drops" },
+	{ "streams", "Simulate N virtual streams multiplexed on the threads (event loops)" },
+	{ "prebuffer", "Frames buffered before playback starts (default 0)" },
+	{ "mixed", "With -w, read other frames concurrently to the writers" },
+	{ "read-threads", "Reader threads of --mixed (default -t)" },
+	{ "read-fps", "Reader frame rate of --mixed (default -f)" },
+	{ "read-order", "Reader order of --mixed: normal, reverse or random" },
+	{ "search", "Find the highest sustainable level: fps (total) or streams (at -f each)" },
+	{ "search-max", "Highest level --search tries (default unlimited)" },
+	{ "search-p99", "With --search, a step also fails above this p99 latency in ms" },
+	{ "sweep-threads", "Run once per thread count, e.g. 1,2,4,8, and report scaling" },
+	{ "sweep-queue-depth", "Run once per queue depth (async engines), e.g. 1,8,32" },
 	{ "reverse", "Access files in reverse order" },
 	{ "random", "Access files in random order" },
 	{ "csv", "Output results in CSV format" },
@@ -843,6 +2724,22 @@ static struct long_opt_desc long_opt_descs[] = {
 	{ "times", "Show breakdown of completion times (open/io/close)" },
 	{ "frametimes", "Show detailed timings of every frames in CSV format" },
 	{ "histogram", "Show histogram of completion times at the end" },
+	{ "io-engine", "I/O engine: sync (default), uring or threads" },
+	{ "queue-depth", "In-flight frame window per thread with async engines (default 32)" },
+	{ "preopen", "Open all frame files before timing, report open-exclusive rate" },
+	{ "request-size", "Split frames in I/O requests of this size, multiple of 4k (e.g. 4M)" },
+	{ "stripes", "Stripe every frame over N parallel requests, per thread" },
+	{ "buffer-budget", "Memory for per-thread frame buffers (default 1G, 0 unlimited)" },
+	{ "huge-pages", "Back frame buffers with huge pages: 2m, 1g, thp or off (default)" },
+	{ "numa", "Pin threads and their buffers to NUMA nodes: rr, near (the device) or a node" },
+	{ "cpus", "Run worker threads only on these CPUs, as 0-3,8" },
+	{ "tui-cpus", "Render the TUI on these CPUs, apart from --cpus" },
+	{ "sched", "Worker scheduling: fifo[:PRIO], rr[:PRIO] or other (default)" },
+	{ "nice", "Nice value of the worker threads, -20 to 19" },
+	{ "ioprio", "Worker I/O priority: rt[:LEVEL], be[:LEVEL] or idle" },
+	{ "fill", "Frame content: const (default) or random[:PCT], unique per frame and PCT% compressible" },
+	{ "seed", "Seed of --fill random, random by default" },
+	{ "schedule", "Frame scheduling: dynamic (default, shared cursor) or static ranges" },
 	{ "tui", "Show real-time TUI dashboard during test" },
 	{ "no-metrics", "Disable real-time metrics collection for maximum performance" },
 	{ "interactive", "Launch interactive TTY mode with config menu" },
@@ -861,6 +2758,19 @@ void version(void)
 #undef XSTRING
 #undef VERSION_STRING
 
+/* Description of an option, by name so the tables can't drift apart */
+static const char *long_opt_desc(const char *name)
+{
+	size_t i;
+
+	for (i = 0; long_opt_descs[i].name; i++) {
+		if (!strcmp(long_opt_descs[i].name, name))
+			return long_opt_descs[i].desc;
+	}
+
+	return "";
+}
+
 #define DESC_POS 30
 void usage(const char *name)
 {
@@ -886,7 +2796,8 @@ void usage(const char *name)
 			p = DESC_POS - p;
 		else
 			p = 1;
-		fprintf(stderr, "%*s%s\n", p, " ", long_opt_descs[i].desc);
+		fprintf(stderr, "%*s%s\n", p, " ",
+			long_opt_desc(long_opts[i].name));
 	}
 }
 #undef DESC_POS
@@ -1441,6 +3352,7 @@ static int run_interactive(opts_t *opts)
 						frames_per_thread;
 				threads[i].fps = test_opts.fps;
 				threads[i].tui_progress = &progress;
+				threads[i].dispatch = NULL;
 				memset(&threads[i].res, 0,
 				       sizeof(threads[i].res));
 
@@ -1593,6 +3505,11 @@ int main(int argc, char **argv)
 	opts.threads = 1;
 	opts.frames = 1800;
 	opts.header_size = 65536;
+	opts.queue_depth = 32;
+	opts.buffer_budget = DEFAULT_BUFFER_BUDGET;
+	opts.seed = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^
+		    (uint64_t)getpid();
+	opts.hist_digits = HIST_DIGITS;
 	while (1) {
 		c = getopt_long(argc, argv, "irw:elt:n:f:s:z:vmhVc", long_opts,
 				&opt_index);
@@ -1613,10 +3530,145 @@ int main(int argc, char **argv)
 				opts.times = 1;
 			if (!strcmp(long_opts[opt_index].name, "frametimes"))
 				opts.frametimes = 1;
+			if (!strcmp(long_opts[opt_index].name, "preopen"))
+				opts.preopen = 1;
+			if (!strcmp(long_opts[opt_index].name, "playback"))
+				opts.playback = 1;
+			if (!strcmp(long_opts[opt_index].name, "duration")) {
+				if (opt_parse_duration(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "hist-digits")) {
+				if (opt_parse_hist_digits(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "hist-export"))
+				opts.hist_export = optarg;
+			if (!strcmp(long_opts[opt_index].name, "log"))
+				opts.complog = optarg;
+			if (!strcmp(long_opts[opt_index].name, "analyze-log"))
+				opts.analyze_log = optarg;
+			if (!strcmp(long_opts[opt_index].name, "warmup")) {
+				if (opt_parse_warmup(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "cooldown")) {
+				if (opt_parse_cooldown(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "streams")) {
+				if (opt_parse_vstreams(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "prebuffer")) {
+				if (opt_parse_prebuffer(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "mixed"))
+				opts.mixed = 1;
+			if (!strcmp(long_opts[opt_index].name, "read-threads")) {
+				if (opt_parse_read_threads(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "read-fps")) {
+				if (opt_parse_read_fps(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "read-order")) {
+				if (opt_parse_read_order(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "search")) {
+				if (opt_parse_search(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "search-max")) {
+				if (opt_parse_search_max(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "search-p99")) {
+				if (opt_parse_search_p99(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "sweep-threads")) {
+				if (opt_parse_sweep_threads(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name,
+				    "sweep-queue-depth")) {
+				if (opt_parse_sweep_depths(&opts, optarg))
+					goto invalid_long;
+			}
 			if (!strcmp(long_opts[opt_index].name, "header")) {
 				if (opt_parse_header_size(&opts, optarg))
 					goto invalid_long;
 			}
+			if (!strcmp(long_opts[opt_index].name, "io-engine")) {
+				if (opt_parse_io_engine(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "queue-depth")) {
+				if (opt_parse_queue_depth(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "request-size")) {
+				if (opt_parse_request_size(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name,
+				    "buffer-budget")) {
+				if (opt_parse_buffer_budget(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "huge-pages")) {
+				if (opt_parse_huge_pages(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "numa")) {
+				if (opt_parse_numa(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "cpus")) {
+				if (opt_parse_cpus(&opts.worker_attr.cpus,
+						   optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "tui-cpus")) {
+				if (opt_parse_cpus(&opts.tui_cpus, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "sched")) {
+				if (opt_parse_sched(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "nice")) {
+				if (opt_parse_nice(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "ioprio")) {
+				if (opt_parse_ioprio(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "fill")) {
+				if (opt_parse_fill(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "seed")) {
+				if (opt_parse_seed(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "stripes")) {
+				if (opt_parse_stripes(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "pace-spin")) {
+				if (opt_parse_pace_spin(&opts, optarg))
+					goto invalid_long;
+			}
+			if (!strcmp(long_opts[opt_index].name, "schedule")) {
+				if (opt_parse_schedule(&opts, optarg))
+					goto invalid_long;
+			}
 			if (!strcmp(long_opts[opt_index].name, "list-profiles-filter")) {
 				opts.list_profiles_filter = optarg;
 			}
@@ -1728,6 +3780,8 @@ int main(int argc, char **argv)
 #endif
 	}
 
+	if (opts.analyze_log)
+		return run_analyze(&opts);
 	if (!opts.path) {
 		usage(argv[0]);
 		return 1;
@@ -44,6 +44,24 @@ enum TestMode {
 	TEST_EMPTY = 1 << 2,
 };
 
+/* Most points of one --sweep list */
+#define SWEEP_MAX 32
+
+/* Load level stepped by --search */
+enum SearchMode {
+	SEARCH_NONE = 0,
+	SEARCH_FPS,
+	SEARCH_STREAMS,
+};
+
+/* Worker placement of --numa */
+enum NumaPlace {
+	NUMA_PLACE_OFF = 0,
+	NUMA_PLACE_RR, /* Round-robin over the nodes */
+	NUMA_PLACE_NEAR, /* Node of the device under the test path */
+	NUMA_PLACE_NODE, /* One given node */
+};
+
 typedef struct opts_t {
 	enum TestMode mode;
 
@@ -59,8 +77,52 @@ typedef struct opts_t {
 	size_t threads;
 	size_t frames;
 	size_t fps;
+	uint64_t pace_spin; /* Busy-wait before each fps deadline, ns */
+	size_t prebuffer; /* Frames a player buffers before display starts */
+	size_t vstreams; /* Virtual streams multiplexed on the threads, 0 off */
+	size_t first_frame; /* Index of the first frame file */
+	size_t read_threads; /* Reader threads of a mixed run, 0 for -t */
+	size_t read_fps; /* Reader frame rate of a mixed run, 0 for -f */
+	uint64_t duration; /* Loop over the frames for this long in ns, 0 off */
+	/* Frames of each thread left out of the statistics at either end */
+	size_t warmup_frames;
+	size_t cooldown_frames;
+	uint64_t warmup; /* ns from the start of the run, 0 off */
+	uint64_t cooldown; /* ns before the last frame of a thread, 0 off */
+	unsigned int hist_digits; /* Significant digits of the histograms */
+	const char *hist_export; /* Write the percentile distribution here */
+	const char *complog; /* Completion log prefix, NULL off */
+	const char *complog_case; /* Test case of the logs, NULL for none */
+	const char *analyze_log; /* Report on these logs instead of testing */
+	enum SearchMode search; /* Saturation search, SEARCH_NONE off */
+	size_t search_max; /* Highest level to try, 0 for no limit */
+	uint64_t search_p99; /* Latency budget of a search step in ns, 0 off */
+	size_t sweep_threads[SWEEP_MAX]; /* Thread counts of --sweep-threads */
+	size_t sweep_threads_cnt;
+	size_t sweep_depths[SWEEP_MAX]; /* Queue depths of --sweep-queue-depth */
+	size_t sweep_depths_cnt;
 	size_t header_size;
 
+	platform_engine_t engine; /* I/O engine (--io-engine) */
+	size_t queue_depth; /* Frames in flight per thread, async engines */
+	size_t request_size; /* Bytes per I/O request, 0 for whole frames */
+	size_t stripes; /* Parallel byte ranges per frame, 0/1 disables */
+	size_t buffer_budget; /* Bytes of frame buffers, 0 for no limit */
+	platform_pages_t huge_pages; /* Backing asked for (--huge-pages) */
+	enum NumaPlace numa; /* Worker placement (--numa) */
+	int numa_node; /* Node of NUMA_PLACE_NODE */
+	/* --cpus, --sched, --nice and --ioprio of every worker */
+	platform_thread_attr_t worker_attr;
+	platform_cpuset_t tui_cpus; /* Of the render thread, empty to float */
+	/* Content of written frames (--fill), constant unless random */
+	int fill_random; /* frame_fill_random(), stamped unique per frame */
+	unsigned int fill_compress; /* Percent of every block compressible */
+	uint64_t seed; /* Of the random content (--seed) */
+
+	/* Single-file stream shared by all workers, 0 if not open */
+	platform_handle_t stream;
+	int stream_io_mode; /* io_mode_t of the stream */
+
 	const char *list_profiles_filter;  /* Filter for --list-profiles */
 
 	unsigned int reverse : 1;
@@ -75,6 +137,12 @@ typedef struct opts_t {
 	unsigned int tui : 1;  /* Enable Terminal User Interface (Phase 4A) */
 	unsigned int interactive : 1; /* Launch interactive config menu */
 	unsigned int no_metrics : 1; /* Disable metrics collection for peak performance */
+	unsigned int preopen : 1; /* Open frame files before the measured loop */
+	unsigned int static_schedule : 1; /* Fixed frame range per thread */
+	unsigned int playback : 1; /* Qualify against display deadlines */
+	unsigned int mixed : 1; /* Writers and readers run concurrently */
+	unsigned int read_reverse : 1; /* Reader order of a mixed run */
+	unsigned int read_random : 1;
 	size_t history_size; /* Frame history depth for interactive mode */
 } opts_t;
 
@@ -85,13 +153,40 @@ typedef enum io_mode_t {
 	IO_MODE_BUFFERED = 2,
 } io_mode_t;
 
-typedef struct test_completion_t {
+/* Absolute timestamps of a frame in flight, packed once it completes */
+typedef struct test_frame_timing_t {
 	uint64_t start;
 	uint64_t open;
 	uint64_t io;
 	uint64_t close;
-	uint64_t frame;
+	/*
+	 * Scheduled start with fps pacing, 0 otherwise. A late start of
+	 * frame k no longer hides the backlog when measured from here.
+	 */
+	uint64_t intended;
 	io_mode_t io_mode; /* Which I/O mode was used for this frame */
+} test_frame_timing_t;
+
+/* Record flags, in the top bits of test_completion_t.late */
+#define COMPLETION_FLAG_BITS 4
+#define COMPLETION_IO_MODE_MASK 0x3u /* io_mode_t */
+#define COMPLETION_PACED 0x4u /* Has an intended start */
+#define COMPLETION_EXCLUDED 0x8u /* Warm-up or cool-down, out of stats */
+
+/*
+ * Record of a completed frame, kept for every frame of long runs so it
+ * is packed: the absolute start and the time of each phase after it.
+ * Durations are in ns as a 5-bit shift over a mantissa, exact below
+ * 2^27 ns (134 ms) and within 2^-27 of the value above it. The late
+ * start shares its word with the flags, so it's exact below 2^23 ns.
+ * Read them through the test_completion_*() accessors in tester.h.
+ */
+typedef struct test_completion_t {
+	uint64_t start;
+	uint32_t open; /* Start to open done */
+	uint32_t io; /* Open done to I/O done */
+	uint32_t close; /* I/O done to close done */
+	uint32_t late; /* Intended start to start, and the flags */
 } test_completion_t;
 
 /* Filesystem type enumeration */
@@ -113,11 +208,60 @@ typedef struct error_info_t {
 	uint64_t timestamp; /* When error occurred (nanoseconds) */
 } error_info_t;
 
+/*
+ * Playback qualification (--playback): frame k of a worker must have
+ * arrived by its intended start plus prebuffer + 1 frame periods.
+ */
+typedef struct playback_stats_t {
+	uint64_t frames; /* Frames due for display */
+	uint64_t late; /* Arrived after their display deadline */
+	uint64_t dropped; /* Late or never arrived */
+	uint64_t miss_run; /* Current run of consecutive misses */
+	uint64_t max_miss_run; /* Longest run of consecutive misses */
+	int64_t min_slack_ns; /* Smallest deadline slack, negative if late */
+	uint64_t startup_ns; /* Earliest start delay without any drop */
+	uint64_t startup_frames; /* Same as a prebuffer depth in frames */
+} playback_stats_t;
+
+/* Workers placed on one NUMA node (--numa) */
+typedef struct node_stats_t {
+	int node; /* Node number of the system */
+	size_t threads;
+	uint64_t frames;
+	uint64_t bytes;
+} node_stats_t;
+
+/* Summary of one virtual stream (--streams) */
+typedef struct stream_stats_t {
+	uint64_t frames; /* Frames completed */
+	uint64_t failed; /* Frames failed */
+	uint64_t bytes;
+	uint64_t time_ns; /* First frame start to last completion */
+	uint64_t avg_frame_ns;
+	uint64_t max_frame_ns;
+	uint64_t dropped; /* Playback drops, 0 without --playback */
+} stream_stats_t;
+
 typedef struct test_result_t {
 	uint64_t frames_written;
 	uint64_t bytes_written;
 	uint64_t time_taken_ns;
+	/*
+	 * Records of the latest successful frames, oldest first once the
+	 * run is over. Bounded by the frame range, so long runs keep a
+	 * window instead of growing.
+	 */
 	test_completion_t *completion;
+	size_t completion_cnt; /* Valid records */
+	size_t completion_cap; /* Allocated records */
+	size_t completion_excluded; /* Records flagged as warm-up/cool-down */
+	uint64_t first_start; /* Start of the first successful frame */
+	/*
+	 * Completion times of every steady-state frame, recorded as they
+	 * complete: frame time, and with pacing from the intended start.
+	 */
+	struct hist_t *hist;
+	struct hist_t *hist_intended;
 
 	/* Error tracking (Phase 1) */
 	int frames_failed; /* Count of failed frames */
@@ -145,6 +289,30 @@ typedef struct test_result_t {
 	uint64_t avg_frame_time_ns; /* Average frame completion time */
 	float performance_trend; /* Performance trend over frames (-1=degrading, 0=stable, 1=improving) */
 	uint64_t network_timeout_ns; /* Timeout for network operations in nanoseconds */
+
+	/* Handle cache (--preopen) */
+	uint64_t handle_time_ns; /* Opening and closing outside of the measured loop */
+
+	/* Frame buffers of the run, buffer_cnt 0 if workers shared opts->frm */
+	size_t buffer_cnt;
+	platform_pages_t buffer_pages; /* Backing obtained */
+
+	/* Scheduling balance */
+	uint64_t *thread_frames; /* Frames completed by each worker thread */
+	size_t thread_count;
+
+	/* NUMA nodes the workers were pinned to, one entry each */
+	node_stats_t *node_stats;
+	size_t node_count;
+
+	/* Virtual streams, one entry each */
+	stream_stats_t *stream_stats;
+	size_t stream_count;
+
+	/* Playback qualification, valid if playback is set */
+	int playback;
+	size_t prebuffer;
+	playback_stats_t playback_stats;
 } test_result_t;
 
 #endif
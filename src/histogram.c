@@ -18,147 +18,293 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "histogram.h"
 #include "tester.h"
 
-/* Histogram buckets in ns */
-static uint64_t buckets[] = {
-	0,	   200000,    500000,	  1000000,  2000000,
-	5000000,   10000000,  20000000,	  50000000, 100000000,
-	200000000, 500000000, 1000000000,
-};
-static char *bucket_label[] = {
-	" 0 ", ".2 ", ".5 ", " 1 ", " 2 ", " 5 ", "10 ",
-	"20 ", "50 ", "100", "200", "500", ">1s", "ovf",
-};
-#define buckets_cnt (sizeof(buckets) / sizeof(*buckets))
-#define SUB_BUCKET_CNT 5
-#define HISTOGRAM_HEIGHT 10
-
-static inline size_t time_get_bucket(uint64_t time)
+#define HISTOGRAM_WIDTH 40
+#define HISTOGRAM_SPLIT 4 /* Rows per power of two range */
+
+/*
+ * Layout of HdrHistogram: 2 * 10^digits sub buckets give single unit
+ * resolution up to that value, every further power of two range reuses
+ * the upper half of them at twice the unit.
+ */
+hist_t *hist_create(uint64_t lowest, uint64_t highest, unsigned int digits)
 {
-	size_t i;
+	uint64_t single = 2;
+	uint64_t untrackable;
+	unsigned int sub_magnitude = 0;
+	size_t buckets = 1;
+	hist_t *hist;
+	unsigned int i;
 
-	for (i = 0; i < buckets_cnt; i++) {
-		if (time <= buckets[i])
-			return i > 0 ? i - 1 : i;
+	if (!lowest || highest < 2 * lowest || !digits ||
+	    digits > HIST_DIGITS_MAX)
+		return NULL;
+	for (i = 0; i < digits; i++)
+		single *= 10;
+	while ((1ULL << sub_magnitude) < single)
+		++sub_magnitude;
+
+	hist = calloc(1, sizeof(*hist));
+	if (!hist)
+		return NULL;
+	hist->lowest = lowest;
+	hist->highest = highest;
+	hist->digits = digits;
+	while ((2ULL << hist->unit_magnitude) <= lowest)
+		++hist->unit_magnitude;
+	hist->half_magnitude = sub_magnitude - 1;
+	hist->sub_mask = ((1ULL << sub_magnitude) - 1) << hist->unit_magnitude;
+
+	untrackable = 1ULL << (sub_magnitude + hist->unit_magnitude);
+	while (untrackable <= highest && untrackable <= UINT64_MAX / 2) {
+		untrackable <<= 1;
+		++buckets;
+	}
+	hist->counts_len = (buckets + 1) << hist->half_magnitude;
+	hist->counts = calloc(hist->counts_len, sizeof(*hist->counts));
+	if (!hist->counts) {
+		free(hist);
+		return NULL;
 	}
 
-	return buckets_cnt - 1;
+	return hist;
 }
 
-static inline size_t time_get_sub_bucket(size_t bucket, uint64_t time)
+void hist_destroy(hist_t *hist)
 {
-	uint64_t min;
-	uint64_t max;
+	if (!hist)
+		return;
+	free(hist->counts);
+	free(hist);
+}
+
+/* Lowest value counted in idx */
+uint64_t hist_value_at(const hist_t *hist, size_t idx)
+{
+	size_t half = (size_t)1 << hist->half_magnitude;
+	size_t bucket = idx >> hist->half_magnitude;
+	size_t sub = (idx & (half - 1)) + half;
 
-	min = buckets[bucket];
-	if (bucket + 1 < buckets_cnt)
-		max = buckets[bucket + 1];
+	if (!bucket)
+		sub -= half;
 	else
-		max = min;
+		--bucket;
 
-	if (max - min == 0)
-		return 0;
-	if (time < min)
-		return 0;
-	if (time >= max)
-		return SUB_BUCKET_CNT - 1;
+	return (uint64_t)sub << (bucket + hist->unit_magnitude);
+}
 
-	time = time - min;
+/* Highest value counted together with val */
+uint64_t hist_highest_equivalent(const hist_t *hist, uint64_t val)
+{
+	size_t idx = hist_index(hist, val);
+	size_t bucket = idx >> hist->half_magnitude;
 
-	return (time * SUB_BUCKET_CNT) / (max - min + 1);
+	return hist_value_at(hist, idx) +
+	       (1ULL << ((bucket ? bucket - 1 : 0) + hist->unit_magnitude)) -
+	       1;
 }
 
-static inline void hist_collect_cnts(const test_result_t *res, uint64_t *cnts)
+void hist_remove(hist_t *hist, uint64_t val)
 {
+	size_t idx;
 	size_t i;
 
-	/*
-	 * Categorize the completion times in buckets and sub buckets.
-	 * Every bucket has SUB_BUCKET_CNT sub buckets, so divide the result
-	 * into proper one.
-	 */
-	for (i = 0; i < res->frames_written; i++) {
-		size_t frametime =
-			res->completion[i].frame - res->completion[i].start;
-		size_t b = time_get_bucket(frametime);
-		size_t sb = time_get_sub_bucket(b, frametime);
-
-		++cnts[b * SUB_BUCKET_CNT + sb];
+	if (val > hist->highest)
+		val = hist->highest;
+	idx = hist_index(hist, val);
+	if (!hist->counts[idx])
+		return;
+	--hist->counts[idx];
+	--hist->total;
+	hist->sum -= val;
+	if (!hist->total) {
+		hist->min = 0;
+		hist->max = 0;
+		return;
+	}
+	if (hist->counts[idx])
+		return;
+
+	/* The extremes are only known to the precision of their buckets now */
+	if (idx == hist_index(hist, hist->min)) {
+		for (i = idx; !hist->counts[i]; i++)
+			;
+		hist->min = hist_value_at(hist, i);
+	}
+	if (idx == hist_index(hist, hist->max)) {
+		for (i = idx; !hist->counts[i]; i--)
+			;
+		hist->max = hist_highest_equivalent(hist,
+						    hist_value_at(hist, i));
 	}
 }
 
-static inline uint64_t hist_cnts_max(uint64_t *cnts, size_t sbcnt)
+int hist_merge(hist_t **dst, const hist_t *src)
 {
-	uint64_t max = 0;
+	hist_t *d;
 	size_t i;
 
-	for (i = 0; i < sbcnt; i++) {
-		if (cnts[i] > max)
-			max = cnts[i];
+	if (!dst || !src)
+		return 1;
+	if (!*dst) {
+		*dst = hist_create(src->lowest, src->highest, src->digits);
+		if (!*dst)
+			return 1;
+	}
+	d = *dst;
+
+	if (d->counts_len == src->counts_len &&
+	    d->unit_magnitude == src->unit_magnitude &&
+	    d->half_magnitude == src->half_magnitude) {
+		for (i = 0; i < src->counts_len; i++)
+			d->counts[i] += src->counts[i];
+	} else {
+		/* Another layout, each bucket lands on its lowest value */
+		for (i = 0; i < src->counts_len; i++) {
+			uint64_t val = hist_value_at(src, i);
+
+			if (!src->counts[i])
+				continue;
+			if (val > d->highest)
+				val = d->highest;
+			d->counts[hist_index(d, val)] += src->counts[i];
+		}
 	}
+	if (src->total && (!d->total || src->min < d->min))
+		d->min = src->min;
+	if (src->max > d->max)
+		d->max = src->max;
+	d->total += src->total;
+	d->sum += src->sum;
 
-	return max;
+	return 0;
 }
 
-static inline size_t hist_cnts(void)
+uint64_t hist_percentile(const hist_t *hist, double pct)
 {
-	return SUB_BUCKET_CNT * buckets_cnt;
+	uint64_t rank;
+	uint64_t cnt = 0;
+	size_t i;
+
+	if (!hist || !hist->total)
+		return 0;
+	if (pct >= 100)
+		return hist->max;
+	rank = (uint64_t)(pct * hist->total / 100 + 0.5);
+	if (!rank)
+		rank = 1;
+	for (i = 0; i < hist->counts_len; i++) {
+		cnt += hist->counts[i];
+		if (cnt >= rank)
+			break;
+	}
+	if (i == hist->counts_len)
+		return hist->max;
+	if (i == hist_index(hist, hist->min))
+		return hist->min;
+	if (i == hist_index(hist, hist->max))
+		return hist->max;
+
+	return hist_highest_equivalent(hist, hist_value_at(hist, i));
 }
 
-void print_histogram(const test_result_t *res)
+int hist_export(const hist_t *hist, FILE *f)
 {
-	uint64_t cnts[SUB_BUCKET_CNT * (buckets_cnt + 1)] = { 0 };
-	uint64_t max;
-	size_t i, j;
-	size_t sbcnt;
-
-	if (!res->completion)
-		return;
+	uint64_t cnt = 0;
+	size_t i;
 
-	sbcnt = hist_cnts();
-	hist_collect_cnts(res, cnts);
+	if (!hist || !f)
+		return 1;
+	fprintf(f, "%12s %14s %10s %14s\n\n", "Value", "Percentile",
+		"TotalCount", "1/(1-Percentile)");
+	for (i = 0; i < hist->counts_len; i++) {
+		double pct;
 
-	/* Resolve the maximum value for scale */
-	max = hist_cnts_max(cnts, sbcnt);
+		if (!hist->counts[i])
+			continue;
+		cnt += hist->counts[i];
+		pct = (double)cnt / hist->total;
+		if (cnt < hist->total)
+			fprintf(f, "%12.3lf %2.12lf %10" PRIu64 " %14.2lf\n",
+				(double)hist_highest_equivalent(
+					hist, hist_value_at(hist, i)) /
+					SEC_IN_MS,
+				pct, cnt, 1 / (1 - pct));
+		else
+			fprintf(f, "%12.3lf %2.12lf %10" PRIu64 "\n",
+				(double)hist->max / SEC_IN_MS, pct, cnt);
+	}
+	fprintf(f, "#[Mean    = %12.3lf, Max            = %12.3lf]\n",
+		(double)hist_mean(hist) / SEC_IN_MS,
+		(double)hist->max / SEC_IN_MS);
+	fprintf(f, "#[Total count    = %12" PRIu64 ", Digits = %u]\n",
+		hist->total, hist->digits);
 
-	printf("\nCompletion times:\n");
-	for (j = 0; j < HISTOGRAM_HEIGHT; j++) {
-		printf("|");
-		for (i = 0; i < sbcnt; i++) {
-			uint64_t th;
-			uint64_t rth;
+	return ferror(f) ? 1 : 0;
+}
 
-			th = cnts[i] * HISTOGRAM_HEIGHT / (max + 1);
-			rth = HISTOGRAM_HEIGHT - 1 - th;
+/* Bars over quarters of the power of two ranges holding values */
+static void print_histogram_of(const hist_t *hist, const char *title)
+{
+	size_t rows_len = ((size_t)1 << hist->half_magnitude) / HISTOGRAM_SPLIT;
+	size_t row_cnt = hist->counts_len / rows_len;
+	uint64_t row_max = 0;
+	uint64_t *rows;
+	size_t first = row_cnt;
+	size_t last = 0;
+	size_t i;
 
-			if (j > rth)
-				printf("*");
-			else if (cnts[i] && j == HISTOGRAM_HEIGHT - 1)
-				printf("*");
-			else
-				printf(" ");
-		}
-		printf("\n");
+	printf("\n%s:\n", title);
+	if (!hist->total) {
+		printf(" no data\n");
+		return;
 	}
-	printf("|");
-	for (i = 0; i < sbcnt; i++) {
-		if (i % SUB_BUCKET_CNT == 0)
-			printf("|");
-		else
-			printf("-");
+
+	rows = calloc(row_cnt, sizeof(*rows));
+	if (!rows)
+		return;
+	for (i = 0; i < hist->counts_len; i++) {
+		size_t r = i / rows_len;
+
+		if (!hist->counts[i])
+			continue;
+		rows[r] += hist->counts[i];
+		if (rows[r] > row_max)
+			row_max = rows[r];
+		if (r < first)
+			first = r;
+		last = r;
 	}
-	printf("\n");
-	for (i = 0; i < sbcnt; i++) {
-		size_t b;
-
-		b = i / SUB_BUCKET_CNT;
-		if (i % SUB_BUCKET_CNT == 0)
-			printf("%s", bucket_label[b]);
-		else if (i % SUB_BUCKET_CNT >= 3)
-			printf(" ");
+	for (i = first; i <= last; i++) {
+		size_t w = rows[i] * HISTOGRAM_WIDTH / row_max;
+		size_t j;
+
+		printf(" %12.6lf - %12.6lf ms |",
+		       (double)hist_value_at(hist, i * rows_len) / SEC_IN_MS,
+		       (double)(hist_value_at(hist, (i + 1) * rows_len) - 1) /
+			       SEC_IN_MS);
+		for (j = 0; j < HISTOGRAM_WIDTH; j++)
+			printf("%c", j < w || (!j && rows[i]) ? '*' : ' ');
+		printf("| %" PRIu64 "\n", rows[i]);
 	}
-	printf("\n");
+	free(rows);
+}
+
+void print_histogram(const test_result_t *res)
+{
+	if (!res->hist)
+		return;
+
+	print_histogram_of(res->hist, "Completion times");
+	/* Paced runs: the latency a player sees, backlog included */
+	if (res->hist_intended)
+		print_histogram_of(res->hist_intended,
+				   "Completion times from intended start");
 }
@@ -21,7 +21,79 @@
 #ifndef FRAMETEST_HISTOGRAM_H
 #define FRAMETEST_HISTOGRAM_H
 
-#include "tester.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "frametest.h"
+
+/* Tracked range and default precision of the latency histograms */
+#define HIST_LOWEST 1000ULL /* 1 us */
+#define HIST_HIGHEST (3600ULL * SEC_IN_NS) /* 1 h */
+#define HIST_DIGITS 3
+#define HIST_DIGITS_MAX 5
+
+/*
+ * Log-linear (HDR) histogram: every power of two range is split in the
+ * same number of linear sub buckets, enough to tell values apart by
+ * digits significant decimal digits. Recording is a couple of shifts and
+ * an increment. Values above highest are counted as highest.
+ */
+typedef struct hist_t {
+	uint64_t lowest;
+	uint64_t highest;
+	unsigned int digits;
+	unsigned int unit_magnitude; /* log2 of the smallest unit */
+	unsigned int half_magnitude; /* log2 of half the sub buckets */
+	uint64_t sub_mask;
+	size_t counts_len;
+	uint64_t *counts;
+
+	uint64_t total;
+	uint64_t sum; /* Of the recorded values, for the mean */
+	uint64_t min;
+	uint64_t max;
+} hist_t;
+
+hist_t *hist_create(uint64_t lowest, uint64_t highest, unsigned int digits);
+void hist_destroy(hist_t *hist);
+void hist_remove(hist_t *hist, uint64_t val);
+/* Add src to *dst, created with the configuration of src when NULL */
+int hist_merge(hist_t **dst, const hist_t *src);
+/* Nearest-rank percentile, within the precision of the histogram */
+uint64_t hist_percentile(const hist_t *hist, double pct);
+uint64_t hist_value_at(const hist_t *hist, size_t idx);
+uint64_t hist_highest_equivalent(const hist_t *hist, uint64_t val);
+/* Percentile distribution in the HdrHistogram .hgrm text format, ms */
+int hist_export(const hist_t *hist, FILE *f);
+
+static inline size_t hist_index(const hist_t *hist, uint64_t val)
+{
+	unsigned int pow2 = 64 - __builtin_clzll(val | hist->sub_mask);
+	unsigned int bucket = pow2 - hist->unit_magnitude -
+			      (hist->half_magnitude + 1);
+	size_t sub = val >> (bucket + hist->unit_magnitude);
+
+	return ((size_t)(bucket + 1) << hist->half_magnitude) + sub -
+	       ((size_t)1 << hist->half_magnitude);
+}
+
+static inline void hist_record(hist_t *hist, uint64_t val)
+{
+	if (val > hist->highest)
+		val = hist->highest;
+	++hist->counts[hist_index(hist, val)];
+	if (!hist->total || val < hist->min)
+		hist->min = val;
+	if (val > hist->max)
+		hist->max = val;
+	++hist->total;
+	hist->sum += val;
+}
+
+static inline uint64_t hist_mean(const hist_t *hist)
+{
+	return hist->total ? hist->sum / hist->total : 0;
+}
 
 extern void print_histogram(const test_result_t *res);
 
@@ -0,0 +1,201 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef __linux__
+/* For pthread_setaffinity_np */
+#define _GNU_SOURCE
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/sysmacros.h>
+#endif
+
+#include "numa.h"
+
+int numa_parse_cpulist(const char *list, platform_cpuset_t *set)
+{
+	const char *p = list;
+
+	memset(set, 0, sizeof(*set));
+	while (*p && *p != '\n') {
+		unsigned long first;
+		unsigned long last;
+		unsigned long cpu;
+		char *endp;
+
+		if (*p < '0' || *p > '9')
+			return 1;
+		first = strtoul(p, &endp, 10);
+		last = first;
+		p = endp;
+		if (*p == '-') {
+			++p;
+			if (*p < '0' || *p > '9')
+				return 1;
+			last = strtoul(p, &endp, 10);
+			p = endp;
+		}
+		if (last < first || last >= PLATFORM_CPUS_MAX)
+			return 1;
+		for (cpu = first; cpu <= last; cpu++)
+			platform_cpuset_add(set, cpu);
+		if (*p == ',')
+			++p;
+		else if (*p && *p != '\n')
+			return 1;
+	}
+
+	return 0;
+}
+
+static int numa_node_cmp(const void *a, const void *b)
+{
+	const numa_node_t *na = (const numa_node_t *)a;
+	const numa_node_t *nb = (const numa_node_t *)b;
+
+	return (na->id > nb->id) - (na->id < nb->id);
+}
+
+int numa_read(numa_t *numa, const char *root)
+{
+	struct dirent *de;
+	DIR *dir;
+
+	numa->node_cnt = 0;
+	dir = opendir(root);
+	if (!dir)
+		return 1;
+
+	while ((de = readdir(dir)) && numa->node_cnt < NUMA_NODES_MAX) {
+		numa_node_t *node = &numa->nodes[numa->node_cnt];
+		char path[PATH_MAX];
+		char list[4096];
+		char *endp;
+		FILE *f;
+		long id;
+
+		if (strncmp(de->d_name, "node", 4) || de->d_name[4] < '0' ||
+		    de->d_name[4] > '9')
+			continue;
+		id = strtol(de->d_name + 4, &endp, 10);
+		if (*endp || id > INT_MAX)
+			continue;
+
+		snprintf(path, sizeof(path), "%s/%s/cpulist", root, de->d_name);
+		f = fopen(path, "r");
+		if (!f)
+			continue;
+		if (!fgets(list, sizeof(list), f))
+			list[0] = 0;
+		fclose(f);
+
+		if (numa_parse_cpulist(list, &node->cpus) || !node->cpus.cnt)
+			continue;
+		node->id = (int)id;
+		++numa->node_cnt;
+	}
+	closedir(dir);
+
+	/* Directory order is arbitrary, round-robin goes by node number */
+	qsort(numa->nodes, numa->node_cnt, sizeof(numa->nodes[0]),
+	      numa_node_cmp);
+
+	return !numa->node_cnt;
+}
+
+const numa_node_t *numa_node(const numa_t *numa, int id)
+{
+	size_t i;
+
+	for (i = 0; i < numa->node_cnt; i++) {
+		if (numa->nodes[i].id == id)
+			return &numa->nodes[i];
+	}
+
+	return NULL;
+}
+
+int numa_path_node(const char *path)
+{
+#ifdef __linux__
+	/*
+	 * The PCI function of the disk has the node. Partitions only link
+	 * to it through their disk, NVMe namespaces through the controller.
+	 */
+	static const char *const links[] = {
+		"device/numa_node",
+		"device/device/numa_node",
+		"../device/numa_node",
+		"../device/device/numa_node",
+	};
+	struct stat st;
+	size_t i;
+
+	if (stat(path, &st))
+		return -1;
+
+	for (i = 0; i < sizeof(links) / sizeof(links[0]); i++) {
+		char sys[PATH_MAX];
+		int node;
+		FILE *f;
+
+		snprintf(sys, sizeof(sys), "/sys/dev/block/%u:%u/%s",
+			 major(st.st_dev), minor(st.st_dev), links[i]);
+		f = fopen(sys, "r");
+		if (!f)
+			continue;
+		if (fscanf(f, "%d", &node) != 1)
+			node = -1;
+		fclose(f);
+		return node;
+	}
+#else
+	(void)path;
+#endif
+
+	return -1;
+}
+
+int numa_bind(const numa_node_t *node)
+{
+#ifdef __linux__
+	cpu_set_t set;
+	size_t cpu;
+
+	CPU_ZERO(&set);
+	for (cpu = 0; cpu < PLATFORM_CPUS_MAX && cpu < CPU_SETSIZE; cpu++) {
+		if (platform_cpuset_isset(&node->cpus, cpu))
+			CPU_SET(cpu, &set);
+	}
+
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void)node;
+	return 1;
+#endif
+}
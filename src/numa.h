@@ -0,0 +1,53 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FRAMETEST_NUMA_H
+#define FRAMETEST_NUMA_H
+
+#include <stddef.h>
+#include "platform.h"
+
+/* NUMA topology of the machine, as Linux exports it */
+#define NUMA_SYSFS "/sys/devices/system/node"
+#define NUMA_NODES_MAX 64
+
+typedef struct numa_node_t {
+	int id; /* Node number of the system */
+	platform_cpuset_t cpus;
+} numa_node_t;
+
+/* Nodes with CPUs, memory-only nodes can't run workers */
+typedef struct numa_t {
+	size_t node_cnt;
+	numa_node_t nodes[NUMA_NODES_MAX];
+} numa_t;
+
+/* Parse a cpulist such as "0-3,8-11" into set, non-zero if malformed */
+int numa_parse_cpulist(const char *list, platform_cpuset_t *set);
+/* Read the nodes under root, usually NUMA_SYSFS. Non-zero without any */
+int numa_read(numa_t *numa, const char *root);
+/* Node n of numa, NULL if there is no such node */
+const numa_node_t *numa_node(const numa_t *numa, int id);
+/* Node of the block device holding path, -1 if unknown */
+int numa_path_node(const char *path);
+/* Restrict the calling thread to the CPUs of node */
+int numa_bind(const numa_node_t *node);
+
+#endif
@@ -24,17 +24,28 @@
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
 
+#include "frametest.h"
 #include "platform.h"
+#include "platform_aio.h"
+#include "timing.h"
 
 #if defined(_WIN32)
 #include <windows.h>
 #endif
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sched.h>
+#endif
 
 /* Define O_DIRECT for platforms that don't have it */
 #if !defined(O_DIRECT) && !defined(__APPLE__)
@@ -114,6 +125,37 @@ static inline size_t win_read(platform_handle_t handle, char *buf, size_t size)
 	return read(handle, buf, size);
 }
 
+static inline size_t win_pwrite(platform_handle_t handle, const char *buf,
+				size_t size, platform_off_t offs)
+{
+	OVERLAPPED ov = { 0 };
+	DWORD done = 0;
+
+	ov.Offset = (DWORD)((uint64_t)offs & 0xffffffffUL);
+	ov.OffsetHigh = (DWORD)((uint64_t)offs >> 32);
+	if (!WriteFile((HANDLE)_get_osfhandle(handle), buf, (DWORD)size, &done,
+		       &ov))
+		return (size_t)-1;
+	return done;
+}
+
+static inline size_t win_pread(platform_handle_t handle, char *buf,
+			       size_t size, platform_off_t offs)
+{
+	OVERLAPPED ov = { 0 };
+	DWORD done = 0;
+
+	ov.Offset = (DWORD)((uint64_t)offs & 0xffffffffUL);
+	ov.OffsetHigh = (DWORD)((uint64_t)offs >> 32);
+	if (!ReadFile((HANDLE)_get_osfhandle(handle), buf, (DWORD)size, &done,
+		      &ov)) {
+		if (GetLastError() == ERROR_HANDLE_EOF)
+			return 0;
+		return (size_t)-1;
+	}
+	return done;
+}
+
 static inline platform_off_t win_seek(platform_handle_t handle,
 				      platform_off_t offs,
 				      platform_seek_flags_t whence)
@@ -154,6 +196,15 @@ static inline int win_usleep(uint64_t us)
 	return usleep((useconds_t)us);
 }
 
+static inline int win_sleep_until(uint64_t deadline)
+{
+	uint64_t now = timing_time();
+
+	if (deadline <= now)
+		return 0;
+	return usleep((useconds_t)((deadline - now) / 1000));
+}
+
 static inline int win_stat(const char *fname, platform_stat_t *st)
 {
 	struct stat sb;
@@ -239,6 +290,18 @@ static inline size_t generic_read(platform_handle_t handle, char *buf,
 	return read(handle, buf, size);
 }
 
+static inline size_t generic_pwrite(platform_handle_t handle, const char *buf,
+				    size_t size, platform_off_t offs)
+{
+	return pwrite(handle, buf, size, offs);
+}
+
+static inline size_t generic_pread(platform_handle_t handle, char *buf,
+				   size_t size, platform_off_t offs)
+{
+	return pread(handle, buf, size, offs);
+}
+
 static inline platform_off_t generic_seek(platform_handle_t handle,
 					  platform_off_t offs,
 					  platform_seek_flags_t whence)
@@ -267,6 +330,30 @@ static inline int generic_usleep(uint64_t us)
 	return usleep((useconds_t)us);
 }
 
+/* Sleep until an absolute deadline on the timing_time() clock */
+static inline int generic_sleep_until(uint64_t deadline)
+{
+#ifdef __linux__
+	struct timespec ts;
+	int res;
+
+	ts.tv_sec = deadline / SEC_IN_NS;
+	ts.tv_nsec = deadline % SEC_IN_NS;
+	do {
+		res = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts,
+				      NULL);
+	} while (res == EINTR);
+
+	return res;
+#else
+	uint64_t now = timing_time();
+
+	if (deadline <= now)
+		return 0;
+	return usleep((useconds_t)((deadline - now) / 1000));
+#endif
+}
+
 #ifdef __APPLE__
 /* macOS posix_memalign wrapper with proper error handling */
 static inline int macos_aligned_alloc(void **res, size_t align, size_t size)
@@ -292,6 +379,107 @@ static inline int generic_aligned_alloc(void **res, size_t align, size_t size)
 }
 #endif
 
+#ifdef __linux__
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+/* Bytes per page of a backing, mappings are multiples of it */
+static inline size_t linux_page_size(platform_pages_t pages)
+{
+	switch (pages) {
+	case PLATFORM_PAGES_HUGE_1G:
+		return 1UL << 30;
+	case PLATFORM_PAGES_HUGE_2M:
+	case PLATFORM_PAGES_THP:
+		return 2UL << 20;
+	default:
+		return 4096;
+	}
+}
+
+static inline size_t linux_page_round(size_t size, platform_pages_t pages)
+{
+	size_t page = linux_page_size(pages);
+
+	return (size + page - 1) & ~(page - 1);
+}
+
+static inline void *linux_map(size_t size, int flags)
+{
+	void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+
+	return mem == MAP_FAILED ? NULL : mem;
+}
+
+/* Regular pages, with THP on a huge page aligned range if advice sticks */
+static int linux_map_thp(void **res, size_t size, int advise,
+			 platform_pages_t *got)
+{
+	size_t page = linux_page_size(PLATFORM_PAGES_THP);
+	size_t len = linux_page_round(size, PLATFORM_PAGES_THP);
+	char *mem;
+	char *start;
+
+	mem = linux_map(len + page, 0);
+	if (!mem)
+		return 1;
+	/* Trim to a huge page boundary, or the edges can't be collapsed */
+	start = (char *)(((uintptr_t)mem + page - 1) & ~((uintptr_t)page - 1));
+	if (start > mem)
+		munmap(mem, start - mem);
+	munmap(start + len, mem + len + page - (start + len));
+
+	*got = PLATFORM_PAGES_DEFAULT;
+#ifdef MADV_HUGEPAGE
+	if (advise && !madvise(start, len, MADV_HUGEPAGE))
+		*got = PLATFORM_PAGES_THP;
+#else
+	(void)advise;
+#endif
+	*res = start;
+
+	return 0;
+}
+
+/*
+ * Reserved huge pages of the wanted size or the next smaller one, then
+ * transparent huge pages, then regular pages.
+ */
+static int linux_page_alloc(void **res, size_t size, platform_pages_t want,
+			    platform_pages_t *got)
+{
+#ifdef MAP_HUGETLB
+	platform_pages_t pages;
+
+	for (pages = want; pages >= PLATFORM_PAGES_HUGE_2M; pages--) {
+		int shift = pages == PLATFORM_PAGES_HUGE_1G ? 30 : 21;
+		void *mem;
+
+		mem = linux_map(linux_page_round(size, pages),
+				MAP_HUGETLB | (shift << MAP_HUGE_SHIFT));
+		if (mem) {
+			*res = mem;
+			*got = pages;
+			return 0;
+		}
+	}
+#endif
+
+	return linux_map_thp(res, size, want != PLATFORM_PAGES_DEFAULT, got);
+}
+
+static void linux_page_free(void *mem, size_t size, platform_pages_t pages)
+{
+	/* Everything but reserved huge pages is a THP sized mapping */
+	if (pages != PLATFORM_PAGES_HUGE_2M && pages != PLATFORM_PAGES_HUGE_1G)
+		pages = PLATFORM_PAGES_THP;
+	if (mem)
+		munmap(mem, linux_page_round(size, pages));
+}
+#endif
+
 static inline int generic_stat(const char *fname, platform_stat_t *st)
 {
 	struct stat sb;
@@ -322,6 +510,111 @@ int generic_thread_create(uint64_t *thread_id, void *(*start)(void *),
 	return pthread_create((pthread_t *)thread_id, NULL, start, arg);
 }
 
+#ifdef __linux__
+static int linux_thread_set_attr(const platform_thread_attr_t *attr)
+{
+	pid_t tid = (pid_t)syscall(SYS_gettid);
+	int res;
+
+	if (attr->cpus.cnt) {
+		cpu_set_t set;
+		size_t cpu;
+
+		CPU_ZERO(&set);
+		for (cpu = 0; cpu < PLATFORM_CPUS_MAX && cpu < CPU_SETSIZE;
+		     cpu++) {
+			if (platform_cpuset_isset(&attr->cpus, cpu))
+				CPU_SET(cpu, &set);
+		}
+		res = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+		if (res)
+			return res;
+	}
+	if (attr->sched != PLATFORM_SCHED_OTHER) {
+		struct sched_param param = { .sched_priority = attr->priority };
+		int policy = attr->sched == PLATFORM_SCHED_FIFO ? SCHED_FIFO :
+								   SCHED_RR;
+
+		res = pthread_setschedparam(pthread_self(), policy, &param);
+		if (res)
+			return res;
+	} else if (attr->nice) {
+		/* Linux keeps nice per thread, not per process */
+		if (setpriority(PRIO_PROCESS, (id_t)tid, attr->nice))
+			return errno;
+	}
+	if (attr->ioprio != PLATFORM_IOPRIO_NONE) {
+		/* IOPRIO_WHO_PROCESS, class in the bits above the level */
+		if (syscall(SYS_ioprio_set, 1, (int)tid,
+			    (int)attr->ioprio << 13 | attr->ioprio_level))
+			return errno;
+	}
+
+	return 0;
+}
+
+typedef struct linux_thread_start_t {
+	const platform_thread_attr_t *attr;
+	void *(*start)(void *);
+	void *arg;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int done;
+	int res;
+} linux_thread_start_t;
+
+/* Apply the attributes in the new thread and report back before starting */
+static void *linux_thread_start(void *data)
+{
+	linux_thread_start_t *ts = (linux_thread_start_t *)data;
+	void *(*start)(void *) = ts->start;
+	void *arg = ts->arg;
+	int res;
+
+	res = linux_thread_set_attr(ts->attr);
+	pthread_mutex_lock(&ts->lock);
+	ts->res = res;
+	ts->done = 1;
+	pthread_cond_signal(&ts->cond);
+	/* ts lives on the stack of the creator, gone after this */
+	pthread_mutex_unlock(&ts->lock);
+	if (res)
+		return NULL;
+
+	return start(arg);
+}
+
+static int linux_thread_create_attr(uint64_t *thread_id,
+				    const platform_thread_attr_t *attr,
+				    void *(*start)(void *), void *arg)
+{
+	linux_thread_start_t ts = {
+		.attr = attr,
+		.start = start,
+		.arg = arg,
+	};
+	int res;
+
+	pthread_mutex_init(&ts.lock, NULL);
+	pthread_cond_init(&ts.cond, NULL);
+	res = pthread_create((pthread_t *)thread_id, NULL, linux_thread_start,
+			     &ts);
+	if (!res) {
+		pthread_mutex_lock(&ts.lock);
+		while (!ts.done)
+			pthread_cond_wait(&ts.cond, &ts.lock);
+		pthread_mutex_unlock(&ts.lock);
+		res = ts.res;
+		if (res)
+			pthread_join((pthread_t)*thread_id, NULL);
+	}
+	pthread_cond_destroy(&ts.cond);
+	pthread_mutex_destroy(&ts.lock);
+
+	return res;
+}
+#endif
+
 int generic_thread_cancel(uint64_t thread_id)
 {
 	return pthread_cancel((pthread_t)thread_id);
@@ -341,7 +634,10 @@ static platform_t default_platform = {
 	.write = win_write,
 	.read = win_read,
 	.seek = win_seek,
+	.pwrite = win_pwrite,
+	.pread = win_pread,
 	.usleep = win_usleep,
+	.sleep_until = win_sleep_until,
 	.stat = win_stat,
 	.calloc = calloc,
 	.malloc = malloc,
@@ -351,13 +647,21 @@ static platform_t default_platform = {
 	.thread_create = win_thread_create,
 	.thread_cancel = win_thread_cancel,
 	.thread_join = win_thread_join,
+
+	.aio_create = platform_aio_create,
+	.aio_submit = platform_aio_submit,
+	.aio_reap = platform_aio_reap,
+	.aio_destroy = platform_aio_destroy,
 #elif defined(__APPLE__)
 	.open = macos_open,
 	.close = generic_close,
 	.write = generic_write,
 	.read = generic_read,
 	.seek = generic_seek,
+	.pwrite = generic_pwrite,
+	.pread = generic_pread,
 	.usleep = generic_usleep,
+	.sleep_until = generic_sleep_until,
 	.stat = generic_stat,
 	.calloc = calloc,
 	.malloc = malloc,
@@ -367,22 +671,43 @@ static platform_t default_platform = {
 	.thread_create = generic_thread_create,
 	.thread_cancel = generic_thread_cancel,
 	.thread_join = generic_thread_join,
+
+	.aio_create = platform_aio_create,
+	.aio_submit = platform_aio_submit,
+	.aio_reap = platform_aio_reap,
+	.aio_destroy = platform_aio_destroy,
 #else
 	.open = generic_open,
 	.close = generic_close,
 	.write = generic_write,
 	.read = generic_read,
 	.seek = generic_seek,
+	.pwrite = generic_pwrite,
+	.pread = generic_pread,
 	.usleep = generic_usleep,
+	.sleep_until = generic_sleep_until,
 	.stat = generic_stat,
 	.calloc = calloc,
 	.malloc = malloc,
 	.aligned_alloc = generic_aligned_alloc,
 	.free = free,
+#ifdef __linux__
+	.page_alloc = linux_page_alloc,
+	.page_free = linux_page_free,
+#endif
 
 	.thread_create = generic_thread_create,
+#ifdef __linux__
+	.thread_create_attr = linux_thread_create_attr,
+	.thread_set_attr = linux_thread_set_attr,
+#endif
 	.thread_cancel = generic_thread_cancel,
 	.thread_join = generic_thread_join,
+
+	.aio_create = platform_aio_create,
+	.aio_submit = platform_aio_submit,
+	.aio_reap = platform_aio_reap,
+	.aio_destroy = platform_aio_destroy,
 #endif
 };
 
@@ -536,3 +861,19 @@ uint64_t platform_get_network_timeout(int filesystem_type)
 		return 0; /* No timeout for local filesystems */
 	}
 }
+
+const char *platform_pages_name(platform_pages_t pages)
+{
+	switch (pages) {
+	case PLATFORM_PAGES_DEFAULT:
+		return "4k";
+	case PLATFORM_PAGES_THP:
+		return "thp";
+	case PLATFORM_PAGES_HUGE_2M:
+		return "2m";
+	case PLATFORM_PAGES_HUGE_1G:
+		return "1g";
+	default:
+		return "unknown";
+	}
+}
@@ -41,6 +41,92 @@ typedef enum platform_seek_flags_t {
 	PLATFORM_SEEK_END = 3,
 } platform_seek_flags_t;
 
+/* I/O engines used to move frame data */
+typedef enum platform_engine_t {
+	PLATFORM_ENGINE_SYNC = 0, /* Blocking open/read/write/close */
+	PLATFORM_ENGINE_URING = 1, /* Linux io_uring, linked open/io/close */
+	PLATFORM_ENGINE_THREADS = 2, /* Portable, helper threads per worker */
+} platform_engine_t;
+
+/* Page backing of frame buffers, larger values are larger pages */
+typedef enum platform_pages_t {
+	PLATFORM_PAGES_DEFAULT = 0, /* Regular pages */
+	PLATFORM_PAGES_THP = 1, /* Transparent huge pages, advised */
+	PLATFORM_PAGES_HUGE_2M = 2, /* Reserved 2 MiB huge pages */
+	PLATFORM_PAGES_HUGE_1G = 3, /* Reserved 1 GiB huge pages */
+} platform_pages_t;
+
+#define PLATFORM_PATH_MAX 4096
+#define PLATFORM_CPUS_MAX 1024
+
+/* Set of CPUs, bit n for CPU n */
+typedef struct platform_cpuset_t {
+	size_t cnt; /* CPUs in the set, 0 for none */
+	unsigned char bits[PLATFORM_CPUS_MAX / 8];
+} platform_cpuset_t;
+
+typedef enum platform_sched_t {
+	PLATFORM_SCHED_OTHER = 0, /* Time-sharing, weighted by nice */
+	PLATFORM_SCHED_FIFO = 1, /* Real-time, run until blocked */
+	PLATFORM_SCHED_RR = 2, /* Real-time, time-sliced */
+} platform_sched_t;
+
+/* I/O scheduling classes, the values of Linux ioprio */
+typedef enum platform_ioprio_t {
+	PLATFORM_IOPRIO_NONE = 0, /* Unchanged */
+	PLATFORM_IOPRIO_RT = 1,
+	PLATFORM_IOPRIO_BE = 2,
+	PLATFORM_IOPRIO_IDLE = 3,
+} platform_ioprio_t;
+
+/* Placement and scheduling of a thread, zero for the defaults */
+typedef struct platform_thread_attr_t {
+	platform_cpuset_t cpus; /* Allowed CPUs, empty for any */
+	platform_sched_t sched;
+	int priority; /* Of the real-time policies, 1-99 */
+	int nice; /* With PLATFORM_SCHED_OTHER, -20-19 */
+	platform_ioprio_t ioprio;
+	int ioprio_level; /* 0 (highest) to 7 */
+} platform_thread_attr_t;
+
+typedef enum platform_aio_op_t {
+	PLATFORM_AIO_READ = 0,
+	PLATFORM_AIO_WRITE = 1,
+} platform_aio_op_t;
+
+/*
+ * One asynchronous frame transfer: open the file, read or write the buffer
+ * at the given offset and close it again. The caller owns the request and
+ * must keep it alive until it is returned by aio_reap().
+ */
+typedef struct platform_aio_req_t {
+	/* Filled in by the caller */
+	char name[PLATFORM_PATH_MAX + 1];
+	platform_open_flags_t flags;
+	int mode;
+	platform_aio_op_t op;
+	char *buf;
+	size_t size;
+	platform_off_t offset;
+	size_t chunk; /* Split the I/O in requests of this size, 0 for one */
+	size_t tag;
+
+	/* Filled in by the engine on completion */
+	int64_t res; /* Bytes transferred */
+	int error; /* errno of the first failed step, 0 on success */
+	int open_failed; /* The open step itself failed */
+	uint64_t open_ns; /* Completion time of open */
+	uint64_t io_ns; /* Completion time of read/write */
+	uint64_t close_ns; /* Completion time of close */
+
+	/* Engine private */
+	size_t slot;
+	int pending;
+	struct platform_aio_req_t *next;
+} platform_aio_req_t;
+
+typedef struct platform_aio_t platform_aio_t;
+
 typedef struct platform_stat_t {
 	uint64_t dev;
 	uint64_t rdev;
@@ -62,19 +148,52 @@ typedef struct platform_t {
 	size_t (*read)(platform_handle_t handle, char *buf, size_t size);
 	platform_off_t (*seek)(platform_handle_t handle, platform_off_t offs,
 			       platform_seek_flags_t whence);
+	/* Positional I/O, does not move the file offset */
+	size_t (*pwrite)(platform_handle_t handle, const char *buf, size_t size,
+			 platform_off_t offs);
+	size_t (*pread)(platform_handle_t handle, char *buf, size_t size,
+			platform_off_t offs);
 	int (*usleep)(uint64_t usec);
+	/*
+	 * Sleep until deadline, in nanoseconds of the timing_time() clock.
+	 * Optional, callers fall back to usleep when NULL.
+	 */
+	int (*sleep_until)(uint64_t deadline);
 	int (*stat)(const char *fname, platform_stat_t *statbuf);
 
 	void *(*calloc)(size_t nmemb, size_t size);
 	void *(*malloc)(size_t size);
 	int (*aligned_alloc)(void **res, size_t align, size_t size);
 	void (*free)(void *mem);
+	/*
+	 * Page aligned memory backed by pages of at most the want size,
+	 * got is the backing obtained. Freed with page_free() of the same
+	 * size and got. Optional, aligned_alloc() when NULL.
+	 */
+	int (*page_alloc)(void **res, size_t size, platform_pages_t want,
+			  platform_pages_t *got);
+	void (*page_free)(void *mem, size_t size, platform_pages_t pages);
 
 	int (*thread_create)(uint64_t *thread_id, void *(*start)(void *),
 			     void *arg);
+	/*
+	 * Create a thread with attr applied before start runs, apply attr to
+	 * the calling thread. Return an errno value if it can't be applied.
+	 * Optional, NULL where threads can't be placed or scheduled.
+	 */
+	int (*thread_create_attr)(uint64_t *thread_id,
+				  const platform_thread_attr_t *attr,
+				  void *(*start)(void *), void *arg);
+	int (*thread_set_attr)(const platform_thread_attr_t *attr);
 	int (*thread_cancel)(uint64_t thread_id);
 	int (*thread_join)(uint64_t thread_id, void **retval);
 
+	/* Asynchronous frame I/O, aio_create returns NULL if unsupported */
+	platform_aio_t *(*aio_create)(platform_engine_t engine, size_t depth);
+	int (*aio_submit)(platform_aio_t *aio, platform_aio_req_t *req);
+	platform_aio_req_t *(*aio_reap)(platform_aio_t *aio, int wait);
+	void (*aio_destroy)(platform_aio_t *aio);
+
 	void *priv;
 } platform_t;
 
@@ -103,4 +222,30 @@ const char *platform_strerror(int error_code);
  */
 uint64_t platform_get_network_timeout(int filesystem_type);
 
+/* I/O engine helpers
+ * platform_engine_available: 1 if the engine can be used on this system
+ * platform_engine_name: short engine name as used on the command line
+ */
+int platform_engine_available(platform_engine_t engine);
+const char *platform_engine_name(platform_engine_t engine);
+
+/* Short page backing name as used on the command line */
+const char *platform_pages_name(platform_pages_t pages);
+
+/* CPU n is in the set */
+static inline int platform_cpuset_isset(const platform_cpuset_t *set,
+					size_t cpu)
+{
+	return cpu < PLATFORM_CPUS_MAX &&
+	       (set->bits[cpu / 8] & (1 << (cpu % 8)));
+}
+
+static inline void platform_cpuset_add(platform_cpuset_t *set, size_t cpu)
+{
+	if (cpu >= PLATFORM_CPUS_MAX || platform_cpuset_isset(set, cpu))
+		return;
+	set->bits[cpu / 8] |= 1 << (cpu % 8);
+	++set->cnt;
+}
+
 #endif
@@ -0,0 +1,837 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef __linux__
+/* For syscall() and MAP_POPULATE */
+#define _GNU_SOURCE
+#endif
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "platform_aio.h"
+#include "timing.h"
+
+/*
+ * io_uring is driven through the raw system calls so that no liburing is
+ * needed at build time. Direct descriptors (openat into a fixed file slot)
+ * appeared in Linux 5.15; the header check below keys off a constant that
+ * was added shortly after, so older headers simply build without the engine.
+ */
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#ifdef IORING_FILE_INDEX_ALLOC
+#define PLATFORM_HAVE_URING 1
+#endif
+#endif
+#endif
+
+#ifdef PLATFORM_HAVE_URING
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Every frame is submitted as a chain of open, read/write and close */
+#define URING_SQES_PER_REQ 3
+#define URING_STAGE_MASK 3UL
+
+enum uring_stage {
+	URING_STAGE_OPEN = 0,
+	URING_STAGE_IO = 1,
+	URING_STAGE_CLOSE = 2,
+};
+
+typedef struct uring_t {
+	int fd;
+	unsigned int to_submit;
+
+	void *sq_ptr;
+	size_t sq_len;
+	void *cq_ptr;
+	size_t cq_len;
+	struct io_uring_sqe *sqes;
+	size_t sqes_len;
+
+	unsigned int *sq_head;
+	unsigned int *sq_tail;
+	unsigned int *sq_mask;
+	unsigned int *sq_entries;
+	unsigned int *sq_array;
+	unsigned int *cq_head;
+	unsigned int *cq_tail;
+	unsigned int *cq_mask;
+	struct io_uring_cqe *cqes;
+} uring_t;
+#endif
+
+/*
+ * Portable engine: every worker gets its own pool of helper threads, one
+ * per request in flight, which run the blocking platform calls.
+ */
+typedef struct aio_threads_t {
+	pthread_mutex_t lock;
+	pthread_cond_t submit_cond;
+	pthread_cond_t done_cond;
+	int stop;
+
+	/* Submitted, not yet picked up by a helper */
+	platform_aio_req_t *queue_head;
+	platform_aio_req_t *queue_tail;
+	/* Finished by a helper, not yet collected by the worker */
+	platform_aio_req_t *finished_head;
+	platform_aio_req_t *finished_tail;
+
+	uint64_t *threads;
+	size_t thread_cnt;
+} aio_threads_t;
+
+struct platform_aio_t {
+	platform_engine_t engine;
+	size_t depth;
+	size_t inflight;
+
+	/* Fixed file slots not used by any request in flight */
+	size_t *free_slots;
+	size_t free_cnt;
+
+	/* Completed requests not yet handed out by platform_aio_reap */
+	platform_aio_req_t *done_head;
+	platform_aio_req_t *done_tail;
+
+	aio_threads_t threads;
+#ifdef PLATFORM_HAVE_URING
+	uring_t uring;
+#endif
+};
+
+static inline void aio_list_append(platform_aio_req_t **head,
+				   platform_aio_req_t **tail,
+				   platform_aio_req_t *req)
+{
+	req->next = NULL;
+	if (*tail)
+		(*tail)->next = req;
+	else
+		*head = req;
+	*tail = req;
+}
+
+static inline void aio_complete(platform_aio_t *aio, platform_aio_req_t *req)
+{
+	aio->free_slots[aio->free_cnt++] = req->slot;
+	--aio->inflight;
+
+	aio_list_append(&aio->done_head, &aio->done_tail, req);
+}
+
+static inline platform_aio_req_t *aio_pop_done(platform_aio_t *aio)
+{
+	platform_aio_req_t *req = aio->done_head;
+
+	if (!req)
+		return NULL;
+	aio->done_head = req->next;
+	if (!aio->done_head)
+		aio->done_tail = NULL;
+	req->next = NULL;
+
+	return req;
+}
+
+static void threads_do_io(platform_aio_req_t *req)
+{
+	const platform_t *platform = platform_get();
+	platform_handle_t f;
+	size_t done = 0;
+
+	f = platform->open(req->name, req->flags, req->mode);
+	req->open_ns = timing_time();
+	if (f < 0) {
+		req->error = errno ? errno : EIO;
+		req->open_failed = 1;
+		return;
+	}
+
+	while (done < req->size) {
+		size_t len = req->size - done;
+		size_t cnt;
+
+		if (req->chunk && len > req->chunk)
+			len = req->chunk;
+		if (req->op == PLATFORM_AIO_WRITE)
+			cnt = platform->pwrite(f, req->buf + done, len,
+					       req->offset + done);
+		else
+			cnt = platform->pread(f, req->buf + done, len,
+					      req->offset + done);
+		if (cnt == (size_t)-1) {
+			req->error = errno ? errno : EIO;
+			break;
+		}
+		if (!cnt)
+			break;
+		done += cnt;
+		/* Short write, the device is full */
+		if (req->op == PLATFORM_AIO_WRITE && cnt != len)
+			break;
+	}
+	req->res = done;
+	req->io_ns = timing_time();
+
+	platform->close(f);
+	req->close_ns = timing_time();
+}
+
+static void *threads_helper(void *arg)
+{
+	aio_threads_t *th = arg;
+	platform_aio_req_t *req;
+
+	pthread_mutex_lock(&th->lock);
+	while (1) {
+		while (!th->queue_head && !th->stop)
+			pthread_cond_wait(&th->submit_cond, &th->lock);
+		if (!th->queue_head)
+			break;
+
+		req = th->queue_head;
+		th->queue_head = req->next;
+		if (!th->queue_head)
+			th->queue_tail = NULL;
+		pthread_mutex_unlock(&th->lock);
+
+		errno = 0;
+		threads_do_io(req);
+
+		pthread_mutex_lock(&th->lock);
+		aio_list_append(&th->finished_head, &th->finished_tail, req);
+		pthread_cond_signal(&th->done_cond);
+	}
+	pthread_mutex_unlock(&th->lock);
+
+	return NULL;
+}
+
+static void threads_exit(aio_threads_t *th)
+{
+	const platform_t *platform = platform_get();
+	size_t i;
+
+	pthread_mutex_lock(&th->lock);
+	th->stop = 1;
+	pthread_cond_broadcast(&th->submit_cond);
+	pthread_mutex_unlock(&th->lock);
+
+	for (i = 0; i < th->thread_cnt; i++)
+		platform->thread_join(th->threads[i], NULL);
+	free(th->threads);
+	th->threads = NULL;
+	th->thread_cnt = 0;
+
+	pthread_cond_destroy(&th->done_cond);
+	pthread_cond_destroy(&th->submit_cond);
+	pthread_mutex_destroy(&th->lock);
+}
+
+static int threads_init(aio_threads_t *th, size_t depth)
+{
+	const platform_t *platform = platform_get();
+
+	memset(th, 0, sizeof(*th));
+	th->threads = calloc(depth, sizeof(*th->threads));
+	if (!th->threads)
+		return 1;
+	pthread_mutex_init(&th->lock, NULL);
+	pthread_cond_init(&th->submit_cond, NULL);
+	pthread_cond_init(&th->done_cond, NULL);
+
+	for (th->thread_cnt = 0; th->thread_cnt < depth; th->thread_cnt++) {
+		if (platform->thread_create(&th->threads[th->thread_cnt],
+					    threads_helper, th)) {
+			threads_exit(th);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int threads_submit(platform_aio_t *aio, platform_aio_req_t *req)
+{
+	aio_threads_t *th = &aio->threads;
+
+	pthread_mutex_lock(&th->lock);
+	aio_list_append(&th->queue_head, &th->queue_tail, req);
+	pthread_cond_signal(&th->submit_cond);
+	pthread_mutex_unlock(&th->lock);
+
+	return 0;
+}
+
+static int threads_reap(platform_aio_t *aio, int wait)
+{
+	aio_threads_t *th = &aio->threads;
+	platform_aio_req_t *req;
+
+	pthread_mutex_lock(&th->lock);
+	while (wait && !th->finished_head)
+		pthread_cond_wait(&th->done_cond, &th->lock);
+	req = th->finished_head;
+	th->finished_head = NULL;
+	th->finished_tail = NULL;
+	pthread_mutex_unlock(&th->lock);
+
+	/* Hand over to the worker side lists outside of the lock */
+	while (req) {
+		platform_aio_req_t *next = req->next;
+
+		aio_complete(aio, req);
+		req = next;
+	}
+
+	return 0;
+}
+
+#ifdef PLATFORM_HAVE_URING
+static inline int uring_setup(unsigned int entries, struct io_uring_params *p)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static inline int uring_enter(int fd, unsigned int to_submit,
+			      unsigned int min_complete, unsigned int flags)
+{
+	return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+			    flags, NULL, 0);
+}
+
+static inline int uring_register(int fd, unsigned int opcode, void *arg,
+				 unsigned int nr_args)
+{
+	return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void uring_exit(uring_t *ring)
+{
+	if (ring->sqes)
+		munmap(ring->sqes, ring->sqes_len);
+	if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr)
+		munmap(ring->cq_ptr, ring->cq_len);
+	if (ring->sq_ptr)
+		munmap(ring->sq_ptr, ring->sq_len);
+	if (ring->fd >= 0)
+		close(ring->fd);
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = -1;
+}
+
+static int uring_init(uring_t *ring, size_t depth)
+{
+	struct io_uring_params p;
+	unsigned char *sq;
+	unsigned char *cq;
+	int *fds;
+	size_t i;
+	int res;
+
+	memset(ring, 0, sizeof(*ring));
+	memset(&p, 0, sizeof(p));
+	ring->fd = uring_setup(depth * URING_SQES_PER_REQ, &p);
+	if (ring->fd < 0)
+		return 1;
+
+	ring->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+	ring->cq_len = p.cq_off.cqes +
+		       p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->cq_len > ring->sq_len)
+			ring->sq_len = ring->cq_len;
+		ring->cq_len = ring->sq_len;
+	}
+
+	ring->sq_ptr = mmap(NULL, ring->sq_len, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, ring->fd,
+			    IORING_OFF_SQ_RING);
+	if (ring->sq_ptr == MAP_FAILED) {
+		ring->sq_ptr = NULL;
+		goto fail;
+	}
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->cq_ptr = ring->sq_ptr;
+	} else {
+		ring->cq_ptr = mmap(NULL, ring->cq_len, PROT_READ | PROT_WRITE,
+				    MAP_SHARED | MAP_POPULATE, ring->fd,
+				    IORING_OFF_CQ_RING);
+		if (ring->cq_ptr == MAP_FAILED) {
+			ring->cq_ptr = NULL;
+			goto fail;
+		}
+	}
+	ring->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE,
+			  MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED) {
+		ring->sqes = NULL;
+		goto fail;
+	}
+
+	sq = ring->sq_ptr;
+	cq = ring->cq_ptr;
+	ring->sq_head = (unsigned int *)(sq + p.sq_off.head);
+	ring->sq_tail = (unsigned int *)(sq + p.sq_off.tail);
+	ring->sq_mask = (unsigned int *)(sq + p.sq_off.ring_mask);
+	ring->sq_entries = (unsigned int *)(sq + p.sq_off.ring_entries);
+	ring->sq_array = (unsigned int *)(sq + p.sq_off.array);
+	ring->cq_head = (unsigned int *)(cq + p.cq_off.head);
+	ring->cq_tail = (unsigned int *)(cq + p.cq_off.tail);
+	ring->cq_mask = (unsigned int *)(cq + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+	/* Sparse fixed file table, one slot per request in flight */
+	fds = malloc(sizeof(*fds) * depth);
+	if (!fds)
+		goto fail;
+	for (i = 0; i < depth; i++)
+		fds[i] = -1;
+	res = uring_register(ring->fd, IORING_REGISTER_FILES, fds, depth);
+	free(fds);
+	if (res < 0)
+		goto fail;
+
+	return 0;
+
+fail:
+	uring_exit(ring);
+	return 1;
+}
+
+static inline struct io_uring_sqe *uring_get_sqe(uring_t *ring,
+						 unsigned int *tail)
+{
+	unsigned int head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+	struct io_uring_sqe *sqe;
+	unsigned int idx;
+
+	if (*tail - head >= *ring->sq_entries)
+		return NULL;
+
+	idx = *tail & *ring->sq_mask;
+	sqe = &ring->sqes[idx];
+	memset(sqe, 0, sizeof(*sqe));
+	ring->sq_array[idx] = idx;
+	++*tail;
+
+	return sqe;
+}
+
+/*
+ * Frames larger than the request size are not linked: the open goes
+ * first, then all chunks are queued at once and complete in any order,
+ * and the close follows the last of them.
+ */
+static inline int uring_split(const platform_aio_req_t *req)
+{
+	return req->chunk && req->size > req->chunk;
+}
+
+static inline void uring_prep_open(struct io_uring_sqe *sqe,
+				   platform_aio_req_t *req, uint8_t flags)
+{
+	sqe->opcode = IORING_OP_OPENAT;
+	sqe->flags = flags;
+	sqe->fd = AT_FDCWD;
+	sqe->addr = (uint64_t)(uintptr_t)req->name;
+	sqe->len = req->mode;
+	sqe->open_flags = generic_resolve_flags(req->flags);
+	sqe->file_index = req->slot + 1;
+	sqe->user_data = (uint64_t)(uintptr_t)req | URING_STAGE_OPEN;
+}
+
+static inline void uring_prep_io(struct io_uring_sqe *sqe,
+				 platform_aio_req_t *req, size_t pos,
+				 size_t len, uint8_t flags)
+{
+	sqe->opcode = req->op == PLATFORM_AIO_WRITE ? IORING_OP_WRITE :
+						      IORING_OP_READ;
+	sqe->flags = IOSQE_FIXED_FILE | flags;
+	sqe->fd = req->slot;
+	sqe->addr = (uint64_t)(uintptr_t)(req->buf + pos);
+	sqe->len = (uint32_t)len;
+	sqe->off = req->offset + pos;
+	sqe->user_data = (uint64_t)(uintptr_t)req | URING_STAGE_IO;
+}
+
+static inline void uring_prep_close(struct io_uring_sqe *sqe,
+				    platform_aio_req_t *req)
+{
+	sqe->opcode = IORING_OP_CLOSE;
+	sqe->file_index = req->slot + 1;
+	sqe->user_data = (uint64_t)(uintptr_t)req | URING_STAGE_CLOSE;
+}
+
+/* Queue one SQE from a completion handler, flushing the SQ when full */
+static struct io_uring_sqe *uring_queue_sqe(uring_t *ring)
+{
+	struct io_uring_sqe *sqe;
+	unsigned int tail = *ring->sq_tail;
+	int res;
+
+	sqe = uring_get_sqe(ring, &tail);
+	if (!sqe) {
+		res = uring_enter(ring->fd, ring->to_submit, 0, 0);
+		if (res > 0)
+			ring->to_submit -= res;
+		tail = *ring->sq_tail;
+		sqe = uring_get_sqe(ring, &tail);
+		if (!sqe)
+			return NULL;
+	}
+	__atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+	ring->to_submit++;
+
+	return sqe;
+}
+
+/* Split request: the descriptor is open, queue all of the chunks */
+static void uring_queue_chunks(uring_t *ring, platform_aio_req_t *req)
+{
+	struct io_uring_sqe *sqe;
+	size_t pos;
+
+	for (pos = 0; pos < req->size; pos += req->chunk) {
+		size_t len = req->size - pos;
+
+		if (len > req->chunk)
+			len = req->chunk;
+		sqe = uring_queue_sqe(ring);
+		if (!sqe) {
+			if (!req->error)
+				req->error = EAGAIN;
+			break;
+		}
+		uring_prep_io(sqe, req, pos, len, 0);
+		++req->pending;
+	}
+}
+
+static void uring_queue_close(uring_t *ring, platform_aio_req_t *req)
+{
+	struct io_uring_sqe *sqe = uring_queue_sqe(ring);
+
+	if (!sqe) {
+		/* Slot stays taken until the next open replaces it */
+		if (!req->error)
+			req->error = EAGAIN;
+		return;
+	}
+	uring_prep_close(sqe, req);
+	++req->pending;
+}
+
+static int uring_submit(platform_aio_t *aio, platform_aio_req_t *req)
+{
+	uring_t *ring = &aio->uring;
+	struct io_uring_sqe *sqe[URING_SQES_PER_REQ];
+	unsigned int tail = *ring->sq_tail;
+	size_t i;
+
+	if (uring_split(req)) {
+		if (req->chunk > UINT32_MAX)
+			return 1;
+		sqe[0] = uring_get_sqe(ring, &tail);
+		if (!sqe[0])
+			return 1;
+		uring_prep_open(sqe[0], req, 0);
+
+		__atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+		ring->to_submit++;
+		req->pending = 1;
+
+		return 0;
+	}
+
+	if (req->size > UINT32_MAX)
+		return 1;
+	for (i = 0; i < URING_SQES_PER_REQ; i++) {
+		sqe[i] = uring_get_sqe(ring, &tail);
+		if (!sqe[i])
+			return 1;
+	}
+
+	/* A failed open cancels the rest of the chain */
+	uring_prep_open(sqe[0], req, IOSQE_IO_LINK);
+	/* Hard link, the descriptor must be closed even on short I/O */
+	uring_prep_io(sqe[1], req, 0, req->size, IOSQE_IO_HARDLINK);
+	uring_prep_close(sqe[2], req);
+
+	__atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+	ring->to_submit += URING_SQES_PER_REQ;
+	req->pending = URING_SQES_PER_REQ;
+
+	return 0;
+}
+
+static void uring_handle_cqe(platform_aio_t *aio, const struct io_uring_cqe *cqe)
+{
+	platform_aio_req_t *req;
+	uint64_t now = timing_time();
+
+	req = (platform_aio_req_t *)(uintptr_t)(cqe->user_data &
+						~(uint64_t)URING_STAGE_MASK);
+
+	switch (cqe->user_data & URING_STAGE_MASK) {
+	case URING_STAGE_OPEN:
+		req->open_ns = now;
+		if (cqe->res < 0) {
+			req->error = -cqe->res;
+			req->open_failed = 1;
+		} else if (uring_split(req)) {
+			uring_queue_chunks(&aio->uring, req);
+			if (req->pending == 1)
+				uring_queue_close(&aio->uring, req);
+		}
+		break;
+	case URING_STAGE_IO:
+		req->io_ns = now;
+		if (cqe->res < 0) {
+			if (!req->error)
+				req->error = -cqe->res;
+		} else {
+			req->res += cqe->res;
+		}
+		/* Last chunk of a split request, close follows */
+		if (uring_split(req) && req->pending == 1)
+			uring_queue_close(&aio->uring, req);
+		break;
+	case URING_STAGE_CLOSE:
+	default:
+		req->close_ns = now;
+		if (cqe->res < 0 && !req->error)
+			req->error = -cqe->res;
+		break;
+	}
+
+	if (--req->pending == 0)
+		aio_complete(aio, req);
+}
+
+static int uring_reap(platform_aio_t *aio, int wait)
+{
+	uring_t *ring = &aio->uring;
+	unsigned int head;
+	unsigned int tail;
+	int res;
+
+	if (ring->to_submit || wait) {
+		res = uring_enter(ring->fd, ring->to_submit, wait ? 1 : 0,
+				  wait ? IORING_ENTER_GETEVENTS : 0);
+		if (res < 0) {
+			if (errno != EINTR && errno != EAGAIN &&
+			    errno != EBUSY)
+				return 1;
+		} else {
+			ring->to_submit -= res;
+		}
+	}
+
+	head = *ring->cq_head;
+	tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+	while (head != tail) {
+		uring_handle_cqe(aio, &ring->cqes[head & *ring->cq_mask]);
+		++head;
+	}
+	__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+	return 0;
+}
+#endif
+
+platform_aio_t *platform_aio_create(platform_engine_t engine, size_t depth)
+{
+	platform_aio_t *aio;
+	size_t i;
+
+	if (!depth)
+		depth = 1;
+
+	aio = calloc(1, sizeof(*aio));
+	if (!aio)
+		return NULL;
+	aio->engine = engine;
+	aio->depth = depth;
+	aio->free_slots = malloc(sizeof(*aio->free_slots) * depth);
+	if (!aio->free_slots)
+		goto fail;
+	for (i = 0; i < depth; i++)
+		aio->free_slots[i] = depth - i - 1;
+	aio->free_cnt = depth;
+
+	switch (engine) {
+	case PLATFORM_ENGINE_THREADS:
+		if (threads_init(&aio->threads, depth))
+			goto fail;
+		return aio;
+#ifdef PLATFORM_HAVE_URING
+	case PLATFORM_ENGINE_URING:
+		if (uring_init(&aio->uring, depth))
+			goto fail;
+		return aio;
+#endif
+	default:
+		break;
+	}
+
+fail:
+	free(aio->free_slots);
+	free(aio);
+	return NULL;
+}
+
+int platform_aio_submit(platform_aio_t *aio, platform_aio_req_t *req)
+{
+	int res = 1;
+
+	if (!aio || !req || !aio->free_cnt)
+		return 1;
+
+	req->slot = aio->free_slots[--aio->free_cnt];
+	req->res = 0;
+	req->error = 0;
+	req->open_failed = 0;
+	req->open_ns = 0;
+	req->io_ns = 0;
+	req->close_ns = 0;
+	req->next = NULL;
+
+	switch (aio->engine) {
+	case PLATFORM_ENGINE_THREADS:
+		res = threads_submit(aio, req);
+		break;
+#ifdef PLATFORM_HAVE_URING
+	case PLATFORM_ENGINE_URING:
+		res = uring_submit(aio, req);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	if (res) {
+		aio->free_slots[aio->free_cnt++] = req->slot;
+		return res;
+	}
+	++aio->inflight;
+
+	return 0;
+}
+
+platform_aio_req_t *platform_aio_reap(platform_aio_t *aio, int wait)
+{
+	platform_aio_req_t *req;
+
+	if (!aio)
+		return NULL;
+
+	while (1) {
+		int res = 1;
+
+		req = aio_pop_done(aio);
+		if (req || !aio->inflight)
+			return req;
+
+		switch (aio->engine) {
+		case PLATFORM_ENGINE_THREADS:
+			res = threads_reap(aio, wait);
+			break;
+#ifdef PLATFORM_HAVE_URING
+		case PLATFORM_ENGINE_URING:
+			res = uring_reap(aio, wait);
+			break;
+#endif
+		default:
+			break;
+		}
+		if (res)
+			return NULL;
+		if (!wait)
+			return aio_pop_done(aio);
+	}
+}
+
+void platform_aio_destroy(platform_aio_t *aio)
+{
+	if (!aio)
+		return;
+
+	/* Never unmap the rings under requests still owned by the kernel */
+	while (aio->inflight) {
+		if (!platform_aio_reap(aio, 1))
+			break;
+	}
+
+	switch (aio->engine) {
+	case PLATFORM_ENGINE_THREADS:
+		threads_exit(&aio->threads);
+		break;
+#ifdef PLATFORM_HAVE_URING
+	case PLATFORM_ENGINE_URING:
+		uring_exit(&aio->uring);
+		break;
+#endif
+	default:
+		break;
+	}
+	free(aio->free_slots);
+	free(aio);
+}
+
+int platform_engine_available(platform_engine_t engine)
+{
+	platform_aio_t *aio;
+
+	if (engine == PLATFORM_ENGINE_SYNC)
+		return 1;
+
+	aio = platform_aio_create(engine, 1);
+	if (!aio)
+		return 0;
+	platform_aio_destroy(aio);
+
+	return 1;
+}
+
+const char *platform_engine_name(platform_engine_t engine)
+{
+	switch (engine) {
+	case PLATFORM_ENGINE_SYNC:
+		return "sync";
+	case PLATFORM_ENGINE_URING:
+		return "uring";
+	case PLATFORM_ENGINE_THREADS:
+		return "threads";
+	default:
+		return "unknown";
+	}
+}
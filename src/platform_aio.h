@@ -0,0 +1,34 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FRAMETEST_PLATFORM_AIO_H
+#define FRAMETEST_PLATFORM_AIO_H
+
+#include "platform.h"
+
+/* Shared with platform.c */
+int generic_resolve_flags(platform_open_flags_t flags);
+
+platform_aio_t *platform_aio_create(platform_engine_t engine, size_t depth);
+int platform_aio_submit(platform_aio_t *aio, platform_aio_req_t *req);
+platform_aio_req_t *platform_aio_reap(platform_aio_t *aio, int wait);
+void platform_aio_destroy(platform_aio_t *aio);
+
+#endif
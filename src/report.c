@@ -22,14 +22,44 @@
 #include <stdio.h>
 #include <stdint.h>
 #include "frametest.h"
+#include "tester.h"
+#include "search.h"
 
 enum CompletionStat {
 	COMP_FRAME = 0,
 	COMP_OPEN,
 	COMP_IO,
 	COMP_CLOSE,
+	COMP_INTENDED, /* Completion measured from the intended start */
 };
 
+static inline uint64_t completion_stat(const test_completion_t *comp,
+				       enum CompletionStat stat)
+{
+	switch (stat) {
+	case COMP_OPEN:
+		return test_completion_open(comp);
+	case COMP_IO:
+		return test_completion_io(comp);
+	case COMP_CLOSE:
+		return test_completion_close(comp);
+	case COMP_INTENDED:
+		return test_completion_intended_time(comp);
+	default:
+	case COMP_FRAME:
+		return test_completion_frame(comp);
+	}
+}
+
+/* Frames were paced, so they carry an intended start */
+static inline int completion_paced(const test_result_t *res)
+{
+	if (res->hist_intended)
+		return res->hist_intended->total != 0;
+	return res->completion && res->completion_cnt &&
+	       test_completion_intended(&res->completion[0]);
+}
+
 /* Phase 2: Helper function to get filesystem type name */
 static const char *get_filesystem_name(filesystem_type_t fs_type)
 {
@@ -46,15 +76,71 @@ static const char *get_filesystem_name(filesystem_type_t fs_type)
 	}
 }
 
+/* Histogram recorded for a statistic, NULL for the ones only in records */
+static inline const hist_t *completion_hist(const test_result_t *res,
+					    enum CompletionStat stat)
+{
+	if (stat == COMP_FRAME)
+		return res->hist;
+	if (stat == COMP_INTENDED)
+		return res->hist_intended;
+	return NULL;
+}
+
+static const double report_pcts[] = { 50, 90, 99, 99.9, 99.99 };
+#define REPORT_PCTS_CNT (sizeof(report_pcts) / sizeof(*report_pcts))
+
+/*
+ * Min, max and sum of a statistic over the steady-state frames, from
+ * its histogram when recorded. Returns the number of frames.
+ */
+static size_t completion_summary(const test_result_t *res,
+				 enum CompletionStat stat, uint64_t *min,
+				 uint64_t *max, uint64_t *total)
+{
+	const hist_t *hist = completion_hist(res, stat);
+	size_t cnt = 0;
+	size_t i;
+
+	if (hist) {
+		*min = hist->min;
+		*max = hist->max;
+		*total = hist->sum;
+		return hist->total;
+	}
+
+	*min = SIZE_MAX;
+	*max = 0;
+	*total = 0;
+	for (i = 0; res->completion && i < res->completion_cnt; i++) {
+		uint64_t val;
+
+		if (test_completion_excluded(&res->completion[i]))
+			continue;
+		val = completion_stat(&res->completion[i], stat);
+		if (val < *min)
+			*min = val;
+		if (val > *max)
+			*max = val;
+		*total += val;
+		++cnt;
+	}
+
+	return cnt;
+}
+
 static void print_stat_about(const test_result_t *res, const char *label,
 			     enum CompletionStat stat, int csv)
 {
-	uint64_t min = SIZE_MAX;
-	uint64_t max = 0;
-	uint64_t total = 0;
+	const hist_t *hist = completion_hist(res, stat);
+	uint64_t min;
+	uint64_t max;
+	uint64_t total;
+	size_t cnt;
 	size_t i;
 
-	if (res->frames_written == 0) {
+	cnt = completion_summary(res, stat, &min, &max, &total);
+	if (cnt == 0) {
 		if (csv)
 			printf("0,0,0,");
 		else
@@ -62,50 +148,57 @@ static void print_stat_about(const test_result_t *res, const char *label,
 		return;
 	}
 
-	for (i = 0; i < res->frames_written; i++) {
-		size_t val;
-
-		switch (stat) {
-		case COMP_OPEN:
-			val = res->completion[i].open;
-			val -= res->completion[i].start;
-			break;
-		case COMP_IO:
-			val = res->completion[i].io;
-			val -= res->completion[i].open;
-			break;
-		case COMP_CLOSE:
-			val = res->completion[i].close;
-			val -= res->completion[i].io;
-			break;
-		default:
-		case COMP_FRAME:
-			val = res->completion[i].frame;
-			break;
-		}
-
-		if (val < min)
-			min = val;
-		if (val > max)
-			max = val;
-		total += val;
-	}
 	if (csv) {
 		printf("%" PRIu64 ",", min);
-		printf("%.9lf,", (double)total / res->frames_written);
+		printf("%.9lf,", (double)total / cnt);
 		printf("%" PRIu64 ",", max);
 	} else {
 		printf("%s:\n", label);
 		printf(" min   : %.9lf ms\n", (double)min / SEC_IN_MS);
-		printf(" avg   : %.9lf ms\n",
-		       (double)total / res->frames_written / SEC_IN_MS);
+		printf(" avg   : %.9lf ms\n", (double)total / cnt / SEC_IN_MS);
+		for (i = 0; hist && i < REPORT_PCTS_CNT; i++)
+			printf(" p%-5g: %.9lf ms\n", report_pcts[i],
+			       (double)hist_percentile(hist, report_pcts[i]) /
+				       SEC_IN_MS);
 		printf(" max   : %.9lf ms\n", (double)max / SEC_IN_MS);
 	}
 }
 
+/* Percentile columns of a histogram, empty without one */
+static void print_pcts_csv(const hist_t *hist)
+{
+	size_t i;
+
+	for (i = 0; i < REPORT_PCTS_CNT; i++) {
+		if (hist && hist->total)
+			printf(",%" PRIu64, hist_percentile(hist, report_pcts[i]));
+		else
+			printf(",");
+	}
+}
+
+/* Percentile members of a JSON completion object */
+static void print_pcts_json(const hist_t *hist)
+{
+	size_t i;
+
+	for (i = 0; hist && i < REPORT_PCTS_CNT; i++) {
+		char name[16];
+		char *p;
+
+		snprintf(name, sizeof(name), "p%g", report_pcts[i]);
+		for (p = name; *p; p++)
+			if (*p == '.')
+				*p = '_';
+		printf("        \"%s_ms\": %.9lf,\n", name,
+		       (double)hist_percentile(hist, report_pcts[i]) /
+			       SEC_IN_MS);
+	}
+}
+
 static void print_frames_stat(const test_result_t *res, const opts_t *opts)
 {
-	if (!res->completion) {
+	if (!res->completion && !res->hist) {
 		if (opts->csv)
 			printf(",,,");
 		return;
@@ -119,7 +212,14 @@ static void print_frames_stat(const test_result_t *res, const opts_t *opts)
 			print_stat_about(res, "", COMP_CLOSE, 1);
 		}
 	} else {
+		if (res->completion_excluded)
+			printf("Excluded from statistics: %zu warm-up/cool-down frames\n",
+			       res->completion_excluded);
 		print_stat_about(res, "Completion times", COMP_FRAME, 0);
+		if (completion_paced(res))
+			print_stat_about(res,
+					 "Completion times from intended start",
+					 COMP_INTENDED, 0);
 		if (opts->times) {
 			print_stat_about(res, "Open times", COMP_OPEN, 0);
 			print_stat_about(res, "I/O times", COMP_IO, 0);
@@ -134,13 +234,19 @@ static void print_frame_times(const test_result_t *res, const opts_t *opts)
 		return;
 	size_t i;
 
-	printf("frame,start,open,io,close,frame\n");
-	for (i = 0; i < res->frames_written; i++) {
+	printf("frame,start,open,io,close,frame,intended,excluded\n");
+	for (i = 0; i < res->completion_cnt; i++) {
+		const test_completion_t *comp = &res->completion[i];
+		uint64_t open = comp->start + test_completion_open(comp);
+		uint64_t io = open + test_completion_io(comp);
+
 		printf("%zu,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
-		       ",%" PRIu64 "\n",
-		       i, res->completion[i].start, res->completion[i].open,
-		       res->completion[i].io, res->completion[i].close,
-		       res->completion[i].frame);
+		       ",%" PRIu64 ",%" PRIu64 ",%d\n",
+		       i, comp->start, open, io,
+		       io + test_completion_close(comp),
+		       test_completion_frame(comp),
+		       test_completion_intended(comp),
+		       test_completion_excluded(comp));
 	}
 }
 
@@ -228,6 +334,143 @@ static void print_errors_json(const test_result_t *res)
 	printf("      }\n");
 }
 
+/* Throughput without the time spent opening and closing cached handles */
+static inline uint64_t open_exclusive_time(const test_result_t *res)
+{
+	if (res->handle_time_ns >= res->time_taken_ns)
+		return 0;
+	return res->time_taken_ns - res->handle_time_ns;
+}
+
+static void print_handle_stats(const test_result_t *res)
+{
+	uint64_t excl = open_exclusive_time(res);
+
+	if (!res->handle_time_ns || !excl)
+		return;
+
+	printf("Handle cache:\n");
+	printf(" open/close     : %.9lf ms\n",
+	       (double)res->handle_time_ns / SEC_IN_MS);
+	printf(" open-inclusive : %lf MiB/s\n",
+	       (double)res->bytes_written * SEC_IN_NS / (1024.0 * 1024.0) /
+		       res->time_taken_ns);
+	printf(" open-exclusive : %lf MiB/s\n",
+	       (double)res->bytes_written * SEC_IN_NS / (1024.0 * 1024.0) /
+		       excl);
+}
+
+static inline const char *playback_verdict(const test_result_t *res)
+{
+	return test_result_playback_ok(res) ? "PASS" : "FAIL";
+}
+
+static void print_playback_stats(const test_result_t *res)
+{
+	const playback_stats_t *pb = &res->playback_stats;
+
+	if (!res->playback)
+		return;
+
+	printf("Playback (prebuffer %zu frames): %s\n", res->prebuffer,
+	       playback_verdict(res));
+	printf(" frames   : %" PRIu64 "\n", pb->frames);
+	printf(" late     : %" PRIu64 "\n", pb->late);
+	printf(" dropped  : %" PRIu64 "\n", pb->dropped);
+	printf(" miss run : %" PRIu64 " (longest consecutive)\n",
+	       pb->max_miss_run);
+	printf(" slack    : %.9lf ms (minimum)\n",
+	       (double)pb->min_slack_ns / SEC_IN_MS);
+	printf(" startup  : %.9lf ms (prebuffer %" PRIu64
+	       " frames) for no drops\n",
+	       (double)pb->startup_ns / SEC_IN_MS, pb->startup_frames);
+}
+
+static inline double stream_fps(const stream_stats_t *st)
+{
+	return st->time_ns ? (double)st->frames * SEC_IN_NS / st->time_ns : 0;
+}
+
+/* Spread over the virtual streams and the slowest of them */
+static void print_stream_stats(const test_result_t *res)
+{
+	double min_fps = 0;
+	double max_fps = 0;
+	double total_fps = 0;
+	size_t worst = 0;
+	size_t i;
+
+	if (!res->stream_count)
+		return;
+
+	for (i = 0; i < res->stream_count; i++) {
+		const stream_stats_t *st = &res->stream_stats[i];
+		double fps = stream_fps(st);
+
+		if (!i || fps < min_fps)
+			min_fps = fps;
+		if (fps > max_fps)
+			max_fps = fps;
+		total_fps += fps;
+		if (st->max_frame_ns > res->stream_stats[worst].max_frame_ns)
+			worst = i;
+	}
+
+	printf("Streams: %zu\n", res->stream_count);
+	printf(" fps   : min %.3lf, avg %.3lf, max %.3lf per stream\n",
+	       min_fps, total_fps / res->stream_count, max_fps);
+	printf(" worst : stream %zu, max %.9lf ms, avg %.9lf ms, "
+	       "%" PRIu64 " failed\n",
+	       worst, (double)res->stream_stats[worst].max_frame_ns / SEC_IN_MS,
+	       (double)res->stream_stats[worst].avg_frame_ns / SEC_IN_MS,
+	       res->stream_stats[worst].failed);
+}
+
+/* With --huge-pages, the backing the frame buffers actually got */
+static void print_buffer_stats(const test_result_t *res, const opts_t *opts)
+{
+	if (opts->huge_pages == PLATFORM_PAGES_DEFAULT)
+		return;
+	if (!res->buffer_cnt) {
+		printf("Frame buffers: shared frame, %s pages not used\n",
+		       platform_pages_name(opts->huge_pages));
+		return;
+	}
+	printf("Frame buffers: %zu on %s pages (asked %s)\n", res->buffer_cnt,
+	       platform_pages_name(res->buffer_pages),
+	       platform_pages_name(opts->huge_pages));
+}
+
+static inline double node_mibps(const test_result_t *res,
+				const node_stats_t *node)
+{
+	return (double)node->bytes * SEC_IN_NS / (1024.0 * 1024.0) /
+	       res->time_taken_ns;
+}
+
+/* Throughput of the workers pinned to each node by --numa */
+static void print_node_stats(const test_result_t *res)
+{
+	size_t i;
+
+	for (i = 0; i < res->node_count; i++) {
+		const node_stats_t *node = &res->node_stats[i];
+
+		printf("NUMA node %d: %zu threads, %" PRIu64
+		       " frames, %lf MiB/s\n",
+		       node->node, node->threads, node->frames,
+		       node_mibps(res, node));
+	}
+}
+
+static void print_thread_frames(const test_result_t *res, const char *sep)
+{
+	size_t i;
+
+	for (i = 0; i < res->thread_count; i++)
+		printf("%s%" PRIu64, i ? sep : "", res->thread_frames[i]);
+}
+
 void print_results(const char *tcase, const opts_t *opts,
 		   const test_result_t *res)
 {
@@ -247,7 +490,17 @@ void print_results(const char *tcase, const opts_t *opts,
 	printf(" MiB/s : %lf\n", (double)res->bytes_written * SEC_IN_NS /
 					 (1024.0 * 1024.0) /
 					 res->time_taken_ns);
+	print_handle_stats(res);
+	print_buffer_stats(res, opts);
+	print_node_stats(res);
+	print_stream_stats(res);
+	if (res->thread_count > 1) {
+		printf("Frames per thread: ");
+		print_thread_frames(res, " ");
+		printf("\n");
+	}
 	print_frames_stat(res, opts);
+	print_playback_stats(res);
 	print_frame_times(res, opts);
 	/* Phase 2: Print error statistics */
 	print_error_stats(res);
@@ -266,13 +519,19 @@ void print_header_csv(const opts_t *opts)
 	       "fmin,favg,fmax%s,"
 	       "filesystem,success_rate,frames_failed,frames_succeeded,"
 	       "direct_io_frames,buffered_io_frames,fallback_count,direct_io_rate,"
-	       "is_remote,min_frame_time,avg_frame_time,max_frame_time,performance_trend,network_timeout\n",
+	       "is_remote,min_frame_time,avg_frame_time,max_frame_time,performance_trend,network_timeout,"
+	       "imin,iavg,imax,handle_time,open_exclusive_mibps,thread_frames,"
+	       "playback,late,dropped,max_miss_run,min_slack,startup,"
+	       "startup_frames,excluded,p50,p90,p99,p999,p9999,"
+	       "ip50,ip90,ip99,ip999,ip9999\n",
 	       extra);
 }
 
 void print_results_csv(const char *tcase, const opts_t *opts,
 		       const test_result_t *res)
 {
+	uint64_t excl;
+
 	if (!res)
 		return;
 	if (!res->time_taken_ns)
@@ -294,7 +553,7 @@ void print_results_csv(const char *tcase, const opts_t *opts,
 	/* Phase 2: Add filesystem, success rate, and I/O stats */
 	/* Phase 3: Add performance metrics and trend analysis */
 	printf("%s,%.2f,%d,%d,%d,%d,%d,%.2f,"
-	       "%d,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.2f,%" PRIu64 "\n",
+	       "%d,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.2f,%" PRIu64 ",",
 	       get_filesystem_name(res->filesystem_type),
 	       res->success_rate_percent, res->frames_failed,
 	       res->frames_succeeded, res->frames_direct_io,
@@ -303,6 +562,35 @@ void print_results_csv(const char *tcase, const opts_t *opts,
 	       res->min_frame_time_ns, res->avg_frame_time_ns,
 	       res->max_frame_time_ns, res->performance_trend,
 	       res->network_timeout_ns);
+	/* Completion from the intended start, paced runs only */
+	if (completion_paced(res))
+		print_stat_about(res, "", COMP_INTENDED, 1);
+	else
+		printf(",,,");
+	/* Handle cache, open-exclusive rate equals the plain one without it */
+	excl = open_exclusive_time(res);
+	if (!excl)
+		excl = res->time_taken_ns;
+	printf("%" PRIu64 ",%.9lf,", res->handle_time_ns,
+	       (double)res->bytes_written * SEC_IN_NS / (1024.0 * 1024.0) /
+		       excl);
+	/* Frames per thread, separated by '/' to keep one column */
+	print_thread_frames(res, "/");
+	if (res->playback) {
+		const playback_stats_t *pb = &res->playback_stats;
+
+		printf(",%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRId64
+		       ",%" PRIu64 ",%" PRIu64,
+		       playback_verdict(res), pb->late, pb->dropped,
+		       pb->max_miss_run, pb->min_slack_ns, pb->startup_ns,
+		       pb->startup_frames);
+	} else {
+		printf(",,,,,,,");
+	}
+	printf(",%zu", res->completion_excluded);
+	print_pcts_csv(res->hist);
+	print_pcts_csv(res->hist_intended);
+	printf("\n");
 	print_frame_times(res, opts);
 	/* Phase 2: Print error data in CSV format */
 	print_errors_csv(res);
@@ -318,12 +606,19 @@ void print_footer_json(void)
 	printf("  ]\n}\n");
 }
 
+/* Between the result objects of a run reporting several */
+void print_separator_json(void)
+{
+	printf("    ,\n");
+}
+
 void print_results_json(const char *tcase, const opts_t *opts,
 			const test_result_t *res)
 {
-	uint64_t min = SIZE_MAX;
-	uint64_t max = 0;
-	uint64_t total = 0;
+	uint64_t min;
+	uint64_t max;
+	uint64_t total;
+	size_t cnt;
 	size_t i;
 
 	if (!res)
@@ -347,30 +642,35 @@ void print_results_json(const char *tcase, const opts_t *opts,
 		       res->time_taken_ns);
 
 	/* Completion times */
-	if (res->completion) {
-		for (i = 0; i < res->frames_written; i++) {
-			uint64_t val = res->completion[i].frame -
-				       res->completion[i].start;
-			if (val < min)
-				min = val;
-			if (val > max)
-				max = val;
-			total += val;
-		}
+	if (res->completion || res->hist) {
+		cnt = completion_summary(res, COMP_FRAME, &min, &max, &total);
 		printf("      \"completion\": {\n");
-		printf("        \"min_ms\": %.9lf,\n", (double)min / SEC_IN_MS);
-		if (res->frames_written > 0) {
-			printf("        \"avg_ms\": %.9lf,\n",
-			       (double)total / res->frames_written / SEC_IN_MS);
-		} else {
-			printf("        \"avg_ms\": 0,\n");
-		}
-		printf("        \"max_ms\": %.9lf\n", (double)max / SEC_IN_MS);
-		printf("      }\n");
+		printf("        \"min_ms\": %.9lf,\n",
+		       cnt ? (double)min / SEC_IN_MS : 0.0);
+		printf("        \"avg_ms\": %.9lf,\n",
+		       cnt ? (double)total / cnt / SEC_IN_MS : 0.0);
+		print_pcts_json(res->hist);
+		printf("        \"max_ms\": %.9lf,\n", (double)max / SEC_IN_MS);
+		printf("        \"excluded_frames\": %zu\n",
+		       res->completion_excluded);
+		printf("      },\n");
 	} else {
 		printf("      \"completion\": null,\n");
 	}
 
+	/* Completion from the intended start, paced runs only */
+	if (completion_paced(res)) {
+		cnt = completion_summary(res, COMP_INTENDED, &min, &max,
+					 &total);
+		printf("      \"completion_intended\": {\n");
+		printf("        \"min_ms\": %.9lf,\n", (double)min / SEC_IN_MS);
+		printf("        \"avg_ms\": %.9lf,\n",
+		       (double)total / cnt / SEC_IN_MS);
+		print_pcts_json(res->hist_intended);
+		printf("        \"max_ms\": %.9lf\n", (double)max / SEC_IN_MS);
+		printf("      },\n");
+	}
+
 	/* Phase 2: Add filesystem, success rate, and I/O stats to JSON */
 	printf("      \"filesystem\": \"%s\",\n",
 	       get_filesystem_name(res->filesystem_type));
@@ -405,8 +705,202 @@ void print_results_json(const char *tcase, const opts_t *opts,
 	       res->network_timeout_ns);
 	printf("      },\n");
 
+	if (res->playback) {
+		const playback_stats_t *pb = &res->playback_stats;
+
+		printf("      \"playback\": {\n");
+		printf("        \"verdict\": \"%s\",\n", playback_verdict(res));
+		printf("        \"prebuffer_frames\": %zu,\n", res->prebuffer);
+		printf("        \"frames\": %" PRIu64 ",\n", pb->frames);
+		printf("        \"late\": %" PRIu64 ",\n", pb->late);
+		printf("        \"dropped\": %" PRIu64 ",\n", pb->dropped);
+		printf("        \"max_miss_run\": %" PRIu64 ",\n",
+		       pb->max_miss_run);
+		printf("        \"min_slack_ns\": %" PRId64 ",\n",
+		       pb->min_slack_ns);
+		printf("        \"startup_ns\": %" PRIu64 ",\n", pb->startup_ns);
+		printf("        \"startup_frames\": %" PRIu64 "\n",
+		       pb->startup_frames);
+		printf("      },\n");
+	}
+
+	if (res->stream_count) {
+		printf("      \"streams\": [\n");
+		for (i = 0; i < res->stream_count; i++) {
+			const stream_stats_t *st = &res->stream_stats[i];
+
+			printf("        { \"frames\": %" PRIu64
+			       ", \"failed\": %" PRIu64 ", \"bytes\": %" PRIu64
+			       ", \"time_ns\": %" PRIu64 ", \"fps\": %.9lf"
+			       ", \"avg_ms\": %.9lf, \"max_ms\": %.9lf"
+			       ", \"dropped\": %" PRIu64 " }%s\n",
+			       st->frames, st->failed, st->bytes, st->time_ns,
+			       stream_fps(st),
+			       (double)st->avg_frame_ns / SEC_IN_MS,
+			       (double)st->max_frame_ns / SEC_IN_MS, st->dropped,
+			       i + 1 < res->stream_count ? "," : "");
+		}
+		printf("      ],\n");
+	}
+
+	if (opts->huge_pages != PLATFORM_PAGES_DEFAULT) {
+		printf("      \"frame_buffers\": { \"count\": %zu, "
+		       "\"pages\": \"%s\", \"requested\": \"%s\" },\n",
+		       res->buffer_cnt, platform_pages_name(res->buffer_pages),
+		       platform_pages_name(opts->huge_pages));
+	}
+
+	if (res->node_count) {
+		printf("      \"numa_nodes\": [\n");
+		for (i = 0; i < res->node_count; i++) {
+			const node_stats_t *node = &res->node_stats[i];
+
+			printf("        { \"node\": %d, \"threads\": %zu"
+			       ", \"frames\": %" PRIu64 ", \"bytes\": %" PRIu64
+			       ", \"mibps\": %.9lf }%s\n",
+			       node->node, node->threads, node->frames,
+			       node->bytes, node_mibps(res, node),
+			       i + 1 < res->node_count ? "," : "");
+		}
+		printf("      ],\n");
+	}
+
+	if (res->thread_count) {
+		printf("      \"thread_frames\": [");
+		print_thread_frames(res, ", ");
+		printf("],\n");
+	}
+
+	/* Handle cache: throughput with and without open/close cost */
+	if (res->handle_time_ns && open_exclusive_time(res)) {
+		printf("      \"handle_cache\": {\n");
+		printf("        \"handle_time_ns\": %" PRIu64 ",\n",
+		       res->handle_time_ns);
+		printf("        \"open_inclusive_mibps\": %.9lf,\n",
+		       (double)res->bytes_written * SEC_IN_NS /
+			       (1024.0 * 1024.0) / res->time_taken_ns);
+		printf("        \"open_exclusive_mibps\": %.9lf\n",
+		       (double)res->bytes_written * SEC_IN_NS /
+			       (1024.0 * 1024.0) / open_exclusive_time(res));
+		printf("      },\n");
+	}
+
 	/* Phase 2: Add error data in JSON format */
 	print_errors_json(res);
 
 	printf("    }\n");
 }
+
+/* One line per finished step, so a long search shows its progress */
+void print_search_step(const char *what, const opts_t *opts,
+		       const search_point_t *point)
+{
+	if (opts->csv || opts->json)
+		return;
+
+	printf("%s %6zu: %10.3lf fps, late %" PRIu64 ", dropped %" PRIu64
+	       ", failed %" PRIu64 ", p99 %.3lf ms: %s\n",
+	       what, point->level, point->fps, point->late, point->dropped,
+	       point->failed, (double)point->p99_ns / SEC_IN_MS,
+	       point->pass ? "PASS" : "FAIL");
+}
+
+void print_search(const char *what, const opts_t *opts,
+		  const search_point_t *curve, size_t cnt, size_t best)
+{
+	size_t i;
+
+	if (opts->csv) {
+		if (!opts->no_csv_header)
+			printf("search,profile,level,fps,frames,late,dropped,"
+			       "failed,p99,pass\n");
+		for (i = 0; i < cnt; i++)
+			printf("\"%s\",\"%s\",%zu,%.9lf,%" PRIu64 ",%" PRIu64
+			       ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%d\n",
+			       what, opts->profile.name, curve[i].level,
+			       curve[i].fps, curve[i].frames, curve[i].late,
+			       curve[i].dropped, curve[i].failed,
+			       curve[i].p99_ns, curve[i].pass);
+		return;
+	}
+	if (!opts->json) {
+		if (best)
+			printf("Highest sustainable %s: %zu\n", what, best);
+		else
+			printf("No %s level sustainable\n", what);
+		return;
+	}
+
+	printf("{\n  \"search\": {\n");
+	printf("    \"mode\": \"%s\",\n", what);
+	printf("    \"profile\": \"%s\",\n", opts->profile.name);
+	printf("    \"p99_budget_ns\": %" PRIu64 ",\n", opts->search_p99);
+	printf("    \"max_level\": %zu,\n", best);
+	printf("    \"curve\": [\n");
+	for (i = 0; i < cnt; i++) {
+		printf("      { \"level\": %zu, \"fps\": %.9lf, "
+		       "\"frames\": %" PRIu64 ", \"late\": %" PRIu64
+		       ", \"dropped\": %" PRIu64 ", \"failed\": %" PRIu64
+		       ", \"p99_ns\": %" PRIu64 ", \"pass\": %s }%s\n",
+		       curve[i].level, curve[i].fps, curve[i].frames,
+		       curve[i].late, curve[i].dropped, curve[i].failed,
+		       curve[i].p99_ns, curve[i].pass ? "true" : "false",
+		       i + 1 < cnt ? "," : "");
+	}
+	printf("    ]\n  }\n}\n");
+}
+
+void print_sweep_step(const opts_t *opts, const sweep_point_t *point)
+{
+	if (opts->csv || opts->json)
+		return;
+
+	printf("threads %3zu depth %3zu: %10.3lf fps, %10.3lf IOPS, "
+	       "%10.3lf MiB/s, p50 %.3lf ms, p99 %.3lf ms\n",
+	       point->threads, point->depth, point->fps, point->iops,
+	       point->mibps, (double)point->p50_ns / SEC_IN_MS,
+	       (double)point->p99_ns / SEC_IN_MS);
+}
+
+void print_sweep(const opts_t *opts, const sweep_point_t *points, size_t cnt)
+{
+	size_t i;
+
+	if (opts->csv) {
+		if (!opts->no_csv_header)
+			printf("profile,threads,queue_depth,fps,iops,mibps,"
+			       "p50,p99,efficiency\n");
+		for (i = 0; i < cnt; i++)
+			printf("\"%s\",%zu,%zu,%.9lf,%.9lf,%.9lf,%" PRIu64
+			       ",%" PRIu64 ",%.6lf\n",
+			       opts->profile.name, points[i].threads,
+			       points[i].depth, points[i].fps, points[i].iops,
+			       points[i].mibps, points[i].p50_ns,
+			       points[i].p99_ns, points[i].efficiency);
+		return;
+	}
+	if (!opts->json) {
+		printf("Scaling efficiency (vs threads %zu depth %zu):\n",
+		       cnt ? points[0].threads : 0, cnt ? points[0].depth : 0);
+		for (i = 0; i < cnt; i++)
+			printf(" threads %3zu depth %3zu: %6.3lf\n",
+			       points[i].threads, points[i].depth,
+			       points[i].efficiency);
+		return;
+	}
+
+	printf("{\n  \"sweep\": {\n");
+	printf("    \"profile\": \"%s\",\n", opts->profile.name);
+	printf("    \"points\": [\n");
+	for (i = 0; i < cnt; i++) {
+		printf("      { \"threads\": %zu, \"queue_depth\": %zu, "
+		       "\"fps\": %.9lf, \"iops\": %.9lf, \"mibps\": %.9lf, "
+		       "\"p50_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64
+		       ", \"efficiency\": %.6lf }%s\n",
+		       points[i].threads, points[i].depth, points[i].fps,
+		       points[i].iops, points[i].mibps, points[i].p50_ns,
+		       points[i].p99_ns, points[i].efficiency,
+		       i + 1 < cnt ? "," : "");
+	}
+	printf("    ]\n  }\n}\n");
+}
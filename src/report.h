@@ -23,6 +23,7 @@
 
 #include "tester.h"
 #include "frametest.h"
+#include "search.h"
 
 extern void print_header_csv(const opts_t *opts);
 extern void print_results_csv(const char *tcase, const opts_t *opts,
@@ -31,7 +32,15 @@ extern void print_results_json(const char *tcase, const opts_t *opts,
 			       const test_result_t *res);
 extern void print_header_json(void);
 extern void print_footer_json(void);
+extern void print_separator_json(void);
 extern void print_results(const char *tcase, const opts_t *opts,
 			  const test_result_t *res);
+extern void print_search_step(const char *what, const opts_t *opts,
+			      const search_point_t *point);
+extern void print_search(const char *what, const opts_t *opts,
+			 const search_point_t *curve, size_t cnt, size_t best);
+extern void print_sweep_step(const opts_t *opts, const sweep_point_t *point);
+extern void print_sweep(const opts_t *opts, const sweep_point_t *points,
+			size_t cnt);
 
 #endif
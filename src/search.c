@@ -0,0 +1,147 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <stdlib.h>
+#include "frametest.h"
+#include "search.h"
+
+void search_init(search_t *search, size_t start, size_t max)
+{
+	search->pass = 0;
+	search->fail = 0;
+	search->max = max;
+	search->level = start ? start : 1;
+	if (max && search->level > max)
+		search->level = max;
+}
+
+/* Record the verdict of the current level, returns the next one or 0 */
+size_t search_next(search_t *search, int passed)
+{
+	size_t level = search->level;
+
+	if (!level)
+		return 0;
+	if (passed) {
+		if (level > search->pass)
+			search->pass = level;
+	} else if (!search->fail || level < search->fail) {
+		search->fail = level;
+	}
+
+	if (!search->fail) {
+		/* Ramp up until something breaks */
+		if (search->max && level >= search->max)
+			search->level = 0;
+		else if (search->max && level * 2 > search->max)
+			search->level = search->max;
+		else
+			search->level = level * 2;
+	} else if (search->fail - search->pass <= 1 ||
+		   (search->fail - search->pass) * SEARCH_RESOLUTION <=
+			   search->pass) {
+		search->level = 0;
+	} else {
+		search->level =
+			search->pass + (search->fail - search->pass) / 2;
+	}
+
+	return search->level;
+}
+
+static int search_cmp(const void *a, const void *b)
+{
+	uint64_t va = *(const uint64_t *)a;
+	uint64_t vb = *(const uint64_t *)b;
+
+	return va < vb ? -1 : va > vb;
+}
+
+/* Nearest-rank percentile of the latency from the intended start */
+uint64_t search_percentile(const test_result_t *res, unsigned int pct)
+{
+	uint64_t *vals;
+	uint64_t val;
+	size_t cnt = 0;
+	size_t rank;
+	size_t i;
+
+	/* Recorded for every frame, the records may only be the latest */
+	if (res->hist_intended || res->hist)
+		return hist_percentile(res->hist_intended ? res->hist_intended :
+							    res->hist,
+				       pct);
+	if (!res->completion || !res->completion_cnt || pct > 100)
+		return 0;
+	vals = malloc(sizeof(*vals) * res->completion_cnt);
+	if (!vals)
+		return 0;
+	/* Steady state only */
+	for (i = 0; i < res->completion_cnt; i++)
+		if (!test_completion_excluded(&res->completion[i]))
+			vals[cnt++] = test_completion_intended_time(
+				&res->completion[i]);
+	if (!cnt) {
+		free(vals);
+		return 0;
+	}
+	qsort(vals, cnt, sizeof(*vals), search_cmp);
+
+	rank = (cnt * pct + 99) / 100;
+	val = vals[rank ? rank - 1 : 0];
+	free(vals);
+
+	return val;
+}
+
+void sweep_point_fill(sweep_point_t *point, const test_result_t *res,
+		      size_t reqs_per_frame)
+{
+	point->fps = 0;
+	point->mibps = 0;
+	if (res->time_taken_ns) {
+		point->fps = (double)res->frames_written * SEC_IN_NS /
+			     res->time_taken_ns;
+		point->mibps = (double)res->bytes_written * SEC_IN_NS /
+			       (1024.0 * 1024.0) / res->time_taken_ns;
+	}
+	point->iops = point->fps * reqs_per_frame;
+	point->p50_ns = search_percentile(res, 50);
+	point->p99_ns = search_percentile(res, 99);
+	point->efficiency = 0;
+}
+
+/*
+ * Scaling efficiency against the first point, normally one thread: the
+ * throughput gained over the concurrency added, 1.0 is linear scaling.
+ */
+void sweep_efficiency(sweep_point_t *points, size_t cnt)
+{
+	double base;
+	size_t i;
+
+	if (!cnt || !points[0].mibps)
+		return;
+	base = points[0].mibps / (points[0].threads * points[0].depth);
+	for (i = 0; i < cnt; i++)
+		points[i].efficiency = points[i].mibps /
+				       (points[i].threads * points[i].depth) /
+				       base;
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FRAMETEST_SEARCH_H
+#define FRAMETEST_SEARCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tester.h"
+
+/*
+ * Saturation search over a load level, the total fps or the stream count.
+ * The level doubles until a step fails, then it is bisected between the
+ * highest passing and the lowest failing level, down to a gap of
+ * 1/SEARCH_RESOLUTION of the level as steps are noisier than that.
+ */
+#define SEARCH_RESOLUTION 50
+
+typedef struct search_t {
+	size_t level; /* Level of the next step, 0 once done */
+	size_t pass; /* Highest passing level, 0 if none */
+	size_t fail; /* Lowest failing level, 0 if none yet */
+	size_t max; /* Highest level to try, 0 for no limit */
+} search_t;
+
+/* One measured step of the search */
+typedef struct search_point_t {
+	size_t level;
+	double fps; /* Achieved frame rate */
+	uint64_t frames;
+	uint64_t late;
+	uint64_t dropped;
+	uint64_t failed;
+	uint64_t p99_ns; /* Latency from the intended start */
+	int pass;
+} search_point_t;
+
+/* One point of a --sweep over threads and queue depths */
+typedef struct sweep_point_t {
+	size_t threads;
+	size_t depth; /* Queue depth, 1 on the sync engine */
+	double fps;
+	double iops; /* I/O requests per second */
+	double mibps;
+	uint64_t p50_ns;
+	uint64_t p99_ns;
+	double efficiency; /* Throughput per unit of concurrency vs first */
+} sweep_point_t;
+
+void search_init(search_t *search, size_t start, size_t max);
+size_t search_next(search_t *search, int passed);
+uint64_t search_percentile(const test_result_t *res, unsigned int pct);
+void sweep_point_fill(sweep_point_t *point, const test_result_t *res,
+		      size_t reqs_per_frame);
+void sweep_efficiency(sweep_point_t *points, size_t cnt);
+
+#endif
@@ -26,6 +26,7 @@
 #endif
 #endif
 #include <limits.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <errno.h>
@@ -63,59 +64,71 @@ static inline void record_error(test_result_t *result, int errno_val,
 		 operation, platform_strerror(errno_val));
 }
 
-static inline size_t tester_frame_write(const platform_t *platform,
-					const char *path, frame_t *frame,
-					size_t num, test_files_t files,
-					test_completion_t *comp,
-					int is_remote_fs)
+static inline int tester_frame_name(char *name, const char *path, size_t num,
+				    test_files_t files)
 {
-	char name[PATH_MAX + 1];
-	size_t ret;
-	platform_handle_t f;
-	io_mode_t io_mode = IO_MODE_UNKNOWN;
-
 	switch (files) {
 	case TEST_FILES_MULTIPLE:
 		snprintf(name, PATH_MAX, "%s/frame%.6zu.tst", path, num);
-		name[PATH_MAX] = 0;
 		break;
 	case TEST_FILES_SINGLE:
 		snprintf(name, PATH_MAX, "%s", path);
-		name[PATH_MAX] = 0;
 		break;
 	default:
 		return 1;
 	}
+	name[PATH_MAX] = 0;
+
+	return 0;
+}
+
+/* Open a frame file, trying Direct I/O first unless the filesystem is remote */
+static inline platform_handle_t tester_frame_open(const platform_t *platform,
+						  const char *name,
+						  test_op_t op,
+						  int is_remote_fs,
+						  io_mode_t *io_mode)
+{
+	platform_open_flags_t flags;
+	platform_handle_t f;
+
+	flags = op == TEST_OP_WRITE ? PLATFORM_OPEN_CREATE | PLATFORM_OPEN_WRITE :
+				      PLATFORM_OPEN_READ;
+	*io_mode = IO_MODE_UNKNOWN;
 
 	/* Phase 3: Skip Direct I/O on remote filesystems */
-	if (is_remote_fs) {
-		/* Use buffered I/O directly for remote filesystems */
-		f = platform->open(
-			name, PLATFORM_OPEN_CREATE | PLATFORM_OPEN_WRITE, 0666);
-		if (f > 0) {
-			io_mode = IO_MODE_BUFFERED;
-		}
-	} else {
+	if (!is_remote_fs) {
 		/* Phase 2: Try Direct I/O first, fall back to buffered if needed */
-		f = platform->open(name,
-				   PLATFORM_OPEN_CREATE | PLATFORM_OPEN_WRITE |
-					   PLATFORM_OPEN_DIRECT,
-				   0666);
-
+		f = platform->open(name, flags | PLATFORM_OPEN_DIRECT, 0666);
 		if (f > 0) {
-			io_mode = IO_MODE_DIRECT;
-		} else {
-			/* Fallback: Retry without Direct I/O flag */
-			f = platform->open(name,
-					   PLATFORM_OPEN_CREATE |
-						   PLATFORM_OPEN_WRITE,
-					   0666);
-			if (f > 0) {
-				io_mode = IO_MODE_BUFFERED;
-			}
+			*io_mode = IO_MODE_DIRECT;
+			return f;
 		}
 	}
 
+	f = platform->open(name, flags, 0666);
+	if (f > 0)
+		*io_mode = IO_MODE_BUFFERED;
+
+	return f;
+}
+
+static inline size_t tester_frame_write(const platform_t *platform,
+					const char *path, frame_t *frame,
+					size_t num, test_files_t files,
+					test_frame_timing_t *comp,
+					int is_remote_fs, size_t req_size)
+{
+	char name[PATH_MAX + 1];
+	size_t ret;
+	platform_handle_t f;
+	io_mode_t io_mode = IO_MODE_UNKNOWN;
+
+	if (tester_frame_name(name, path, num, files))
+		return 1;
+
+	f = tester_frame_open(platform, name, TEST_OP_WRITE, is_remote_fs,
+			      &io_mode);
 	if (f <= 0)
 		return 1;
 
@@ -130,7 +143,7 @@ static inline size_t tester_frame_write(const platform_t *platform,
 
 	comp->open = timing_start();
 
-	ret = frame_write(platform, f, frame);
+	ret = frame_write_chunked(platform, f, frame, req_size);
 	comp->io = timing_start();
 
 	platform->close(f);
@@ -148,49 +161,19 @@ static inline size_t tester_frame_write(const platform_t *platform,
 static inline size_t tester_frame_read(const platform_t *platform,
 				       const char *path, frame_t *frame,
 				       size_t num, test_files_t files,
-				       test_completion_t *comp,
-				       int is_remote_fs)
+				       test_frame_timing_t *comp,
+				       int is_remote_fs, size_t req_size)
 {
 	char name[PATH_MAX + 1];
 	size_t ret;
 	platform_handle_t f;
 	io_mode_t io_mode = IO_MODE_UNKNOWN;
 
-	switch (files) {
-	case TEST_FILES_MULTIPLE:
-		snprintf(name, PATH_MAX, "%s/frame%.6zu.tst", path, num);
-		name[PATH_MAX] = 0;
-		break;
-	case TEST_FILES_SINGLE:
-		snprintf(name, PATH_MAX, "%s", path);
-		name[PATH_MAX] = 0;
-		break;
-	default:
+	if (tester_frame_name(name, path, num, files))
 		return 1;
-	}
-
-	/* Phase 3: Skip Direct I/O on remote filesystems */
-	if (is_remote_fs) {
-		/* Use buffered I/O directly for remote filesystems */
-		f = platform->open(name, PLATFORM_OPEN_READ, 0666);
-		if (f > 0) {
-			io_mode = IO_MODE_BUFFERED;
-		}
-	} else {
-		/* Phase 2: Try Direct I/O first, fall back to buffered if needed */
-		f = platform->open(
-			name, PLATFORM_OPEN_READ | PLATFORM_OPEN_DIRECT, 0666);
-		if (f > 0) {
-			io_mode = IO_MODE_DIRECT;
-		} else {
-			/* Fallback: Retry without Direct I/O flag */
-			f = platform->open(name, PLATFORM_OPEN_READ, 0666);
-			if (f > 0) {
-				io_mode = IO_MODE_BUFFERED;
-			}
-		}
-	}
 
+	f = tester_frame_open(platform, name, TEST_OP_READ, is_remote_fs,
+			      &io_mode);
 	if (f <= 0)
 		return 0;
 
@@ -205,7 +188,7 @@ static inline size_t tester_frame_read(const platform_t *platform,
 
 	comp->open = timing_start();
 
-	ret = frame_read(platform, f, frame);
+	ret = frame_read_chunked(platform, f, frame, req_size);
 	comp->io = timing_start();
 
 	platform->close(f);
@@ -220,6 +203,157 @@ static inline size_t tester_frame_read(const platform_t *platform,
 	return ret;
 }
 
+/* Pre-opened frame file of the handle cache */
+typedef struct tester_handle_t {
+	platform_handle_t f;
+	io_mode_t io_mode;
+	int error;
+} tester_handle_t;
+
+static inline size_t tester_handle_count(const tester_params_t *params)
+{
+	return params->files == TEST_FILES_SINGLE ? 1 : params->frames;
+}
+
+static inline tester_handle_t *
+tester_handle_get(tester_handle_t *handles, const tester_params_t *params,
+		  size_t frame_idx)
+{
+	if (params->files == TEST_FILES_SINGLE)
+		return &handles[0];
+	return &handles[frame_idx - params->start_frame];
+}
+
+/*
+ * Setup phase of the handle cache: open every frame file of the run up
+ * front so the measured loop only moves data. Time spent here and in
+ * tester_handles_close() is accounted in handle_time_ns.
+ */
+static tester_handle_t *tester_handles_open(const platform_t *platform,
+					    test_op_t op,
+					    const tester_params_t *params,
+					    test_result_t *res)
+{
+	char name[PATH_MAX + 1];
+	tester_handle_t *handles;
+	size_t cnt = tester_handle_count(params);
+	uint64_t start;
+	size_t i;
+
+	handles = platform->calloc(cnt, sizeof(*handles));
+	if (!handles)
+		return NULL;
+
+	start = timing_start();
+	for (i = 0; i < cnt; i++) {
+		tester_handle_t *h = &handles[i];
+
+		errno = 0;
+		if (tester_frame_name(name, params->path,
+				      params->start_frame + i, params->files)) {
+			h->f = -1;
+			h->error = EINVAL;
+			continue;
+		}
+		h->f = tester_frame_open(platform, name, op,
+					 res->is_remote_filesystem,
+					 &h->io_mode);
+		if (h->f <= 0)
+			h->error = errno ? errno : EIO;
+	}
+	res->handle_time_ns += timing_elapsed(start);
+
+	return handles;
+}
+
+static void tester_handles_close(const platform_t *platform,
+				 const tester_params_t *params,
+				 tester_handle_t *handles, test_result_t *res)
+{
+	size_t cnt = tester_handle_count(params);
+	uint64_t start;
+	size_t i;
+
+	start = timing_start();
+	for (i = 0; i < cnt; i++) {
+		if (handles[i].f > 0)
+			platform->close(handles[i].f);
+	}
+	res->handle_time_ns += timing_elapsed(start);
+
+	platform->free(handles);
+}
+
+/* Memory of the frame in flight in slot n */
+static inline void *tester_slot_buf(const tester_params_t *params, size_t n)
+{
+	if (!params->buf_cnt)
+		return params->frame->data;
+	return params->bufs[n % params->buf_cnt];
+}
+
+static inline void tester_frame_stamp(const tester_params_t *params,
+				      test_op_t op, void *buf, size_t frame_idx)
+{
+	if (params->stamp && op == TEST_OP_WRITE)
+		frame_stamp(buf, params->frame->size, params->seed, frame_idx);
+}
+
+/* Transfer one frame through the handle cache, there's no open or close */
+static inline size_t tester_frame_cached(const platform_t *platform,
+					 test_op_t op,
+					 const tester_params_t *params,
+					 frame_t *frame, tester_handle_t *h,
+					 size_t num, test_frame_timing_t *comp)
+{
+	size_t ret;
+
+	if (h->f <= 0) {
+		errno = h->error;
+		return 0;
+	}
+
+	comp->open = timing_start();
+
+	/* The stream file may be shared, so no seek + write there */
+	if (params->files == TEST_FILES_SINGLE) {
+		platform_off_t offs = (platform_off_t)(num * frame->size);
+
+		if (op == TEST_OP_WRITE)
+			ret = frame_pwrite(platform, h->f, frame, offs,
+					   params->request_size);
+		else
+			ret = frame_pread(platform, h->f, frame, offs,
+					  params->request_size);
+	} else if (op == TEST_OP_WRITE) {
+		ret = frame_write_chunked(platform, h->f, frame,
+					  params->request_size);
+	} else {
+		ret = frame_read_chunked(platform, h->f, frame,
+					 params->request_size);
+	}
+	comp->io = timing_start();
+	comp->close = comp->io;
+
+	comp->io_mode = h->io_mode;
+
+	/* Faking the output! */
+	if (!ret && !frame->size)
+		return 1;
+	return ret;
+}
+
+platform_handle_t tester_stream_open(const platform_t *platform,
+				     const char *path, test_op_t op,
+				     io_mode_t *io_mode)
+{
+	filesystem_type_t fs = platform_detect_filesystem(path);
+
+	return tester_frame_open(platform, path, op,
+				 fs == FILESYSTEM_NFS || fs == FILESYSTEM_SMB,
+				 io_mode);
+}
+
 frame_t *tester_get_frame_read(const platform_t *platform, const char *path,
 			       size_t frame_size)
 {
@@ -231,6 +365,29 @@ frame_t *tester_get_frame_read(const platform_t *platform, const char *path,
 	return frame_from_file(platform, name, frame_size);
 }
 
+/*
+ * Whether frames [start, start + frames) look written, judged by the first
+ * and the last file holding at least size bytes.
+ */
+int tester_frames_present(const platform_t *platform, const char *path,
+			  size_t start, size_t frames, size_t size)
+{
+	char name[PATH_MAX + 1];
+	platform_stat_t st;
+
+	if (!frames)
+		return 1;
+	if (tester_frame_name(name, path, start, TEST_FILES_MULTIPLE) ||
+	    platform->stat(name, &st) || st.size < size)
+		return 0;
+	if (tester_frame_name(name, path, start + frames - 1,
+			      TEST_FILES_MULTIPLE) ||
+	    platform->stat(name, &st) || st.size < size)
+		return 0;
+
+	return 1;
+}
+
 static inline void shuffle_array(size_t *arr, size_t size)
 {
 	size_t i;
@@ -248,170 +405,431 @@ static inline void shuffle_array(size_t *arr, size_t size)
 	}
 }
 
-test_result_t tester_run_write(const platform_t *platform, const char *path,
-			       frame_t *frame, size_t start_frame,
-			       size_t frames, size_t fps, test_mode_t mode,
-			       test_files_t files)
+static inline const char *tester_op_name(test_op_t op)
+{
+	return op == TEST_OP_WRITE ? "write" : "read";
+}
+
+/* Map the i-th frame of the run to the frame number to access */
+static inline size_t tester_frame_index(const tester_params_t *params,
+					const size_t *seq, size_t i)
+{
+	switch (params->mode) {
+	case TEST_MODE_REVERSE:
+		return params->start_frame + params->frames - i - 1;
+	case TEST_MODE_RANDOM:
+		return seq[i];
+	case TEST_MODE_NORM:
+	default:
+		return params->start_frame + i;
+	}
+}
+
+size_t tester_dispatch_index(const tester_dispatch_t *dispatch, size_t pos)
+{
+	switch (dispatch->mode) {
+	case TEST_MODE_REVERSE:
+		return dispatch->start_frame + dispatch->frames - pos - 1;
+	case TEST_MODE_RANDOM:
+		return dispatch->seq[pos];
+	case TEST_MODE_NORM:
+	default:
+		return dispatch->start_frame + pos;
+	}
+}
+
+int tester_dispatch_init(const platform_t *platform,
+			 tester_dispatch_t *dispatch, size_t start_frame,
+			 size_t frames, test_mode_t mode)
 {
-	test_result_t res = { 0 };
 	size_t i;
-	size_t budget;
-	size_t end_frame;
-	size_t *seq = NULL;
 
-	res.completion = platform->calloc(frames, sizeof(*res.completion));
-	if (!res.completion)
-		return res;
+	memset(dispatch, 0, sizeof(*dispatch));
+	dispatch->start_frame = start_frame;
+	dispatch->frames = frames;
+	dispatch->mode = mode;
+
+	if (mode == TEST_MODE_RANDOM) {
+		dispatch->seq = platform->malloc(sizeof(*dispatch->seq) * frames);
+		if (!dispatch->seq)
+			return 1;
+		for (i = 0; i < frames; i++)
+			dispatch->seq[i] = start_frame + i;
+		shuffle_array(dispatch->seq, frames);
+	}
+
+	return 0;
+}
+
+void tester_dispatch_free(const platform_t *platform,
+			  tester_dispatch_t *dispatch)
+{
+	if (dispatch->seq)
+		platform->free(dispatch->seq);
+	dispatch->seq = NULL;
+}
+
+/*
+ * Pick the i-th frame of this worker. Static runs walk their own range,
+ * dynamic ones take the next frame of the shared cursor. Time-bounded
+ * runs wrap around the range until the end. Returns 0 once there's
+ * nothing left.
+ */
+static inline int tester_next_frame(const tester_params_t *params,
+				    const size_t *seq, size_t i,
+				    size_t *frame_idx)
+{
+	tester_dispatch_t *dispatch = params->dispatch;
+	size_t pos;
+
+	if (!params->frames)
+		return 0;
+	if (params->end) {
+		if (timing_time() >= params->end)
+			return 0;
+	} else if (i >= params->frames) {
+		return 0;
+	}
+	if (!dispatch) {
+		*frame_idx = tester_frame_index(params, seq,
+						i % params->frames);
+		return 1;
+	}
+
+	pos = __sync_fetch_and_add(&dispatch->next, 1);
+	if (!params->end && pos >= dispatch->frames)
+		return 0;
+	*frame_idx = tester_dispatch_index(dispatch, pos % dispatch->frames);
+
+	return 1;
+}
 
+static void tester_result_init(test_result_t *res, const char *path)
+{
 	/* Phase 1: Initialize error tracking */
-	res.frames_failed = 0;
-	res.frames_succeeded = 0;
-	res.error_count = 0;
-	res.max_errors = 0;
-	res.errors = NULL;
-	res.direct_io_available = 1;
+	res->frames_failed = 0;
+	res->frames_succeeded = 0;
+	res->error_count = 0;
+	res->max_errors = 0;
+	res->errors = NULL;
+	res->direct_io_available = 1;
 
 	/* Phase 2: Initialize I/O fallback tracking */
-	res.frames_direct_io = 0;
-	res.frames_buffered_io = 0;
-	res.fallback_count = 0;
-	res.direct_io_success_rate = 0.0;
+	res->frames_direct_io = 0;
+	res->frames_buffered_io = 0;
+	res->fallback_count = 0;
+	res->direct_io_success_rate = 0.0;
 
 	/* Phase 3: Initialize NFS/SMB optimization and performance tracking */
-	res.filesystem_type = platform_detect_filesystem(path);
-	res.is_remote_filesystem = (res.filesystem_type == FILESYSTEM_NFS ||
-				    res.filesystem_type == FILESYSTEM_SMB) ?
-					   1 :
-					   0;
-	res.skipped_direct_io_attempt = 0;
-	res.min_frame_time_ns = UINT64_MAX;
-	res.max_frame_time_ns = 0;
-	res.avg_frame_time_ns = 0;
-	res.performance_trend = 0.0;
-	res.network_timeout_ns =
-		platform_get_network_timeout(res.filesystem_type);
-
-	budget = fps ? (SEC_IN_NS / fps) : 0;
-	end_frame = start_frame + frames;
+	res->filesystem_type = platform_detect_filesystem(path);
+	res->is_remote_filesystem = (res->filesystem_type == FILESYSTEM_NFS ||
+				     res->filesystem_type == FILESYSTEM_SMB) ?
+					    1 :
+					    0;
+	res->skipped_direct_io_attempt = 0;
+	res->min_frame_time_ns = UINT64_MAX;
+	res->max_frame_time_ns = 0;
+	res->avg_frame_time_ns = 0;
+	res->performance_trend = 0.0;
+	res->network_timeout_ns =
+		platform_get_network_timeout(res->filesystem_type);
+}
 
-	if (mode == TEST_MODE_RANDOM) {
-		seq = platform->malloc(sizeof(*seq) * frames);
-		if (!seq) {
-			platform->free(res.completion);
-			res.completion = NULL;
-			return res;
-		}
+/*
+ * Judge a frame against its display deadline, comp is NULL for a frame
+ * that never arrived. Any miss is a drop: a player can't show a frame
+ * after its slot without shifting the rest of the stream.
+ */
+static void tester_playback_frame(test_result_t *res,
+				  const tester_params_t *params,
+				  const test_completion_t *comp)
+{
+	playback_stats_t *pb = &res->playback_stats;
+	uint64_t deadline;
+	uint64_t arrival;
+	int64_t slack;
 
-		for (i = 0; i < frames; i++)
-			seq[i] = start_frame + i;
-		shuffle_array(seq, frames);
+	if (!res->playback)
+		return;
+
+	++pb->frames;
+	if (!comp || !test_completion_intended(comp)) {
+		++pb->dropped;
+		if (++pb->miss_run > pb->max_miss_run)
+			pb->max_miss_run = pb->miss_run;
+		return;
 	}
 
-	for (i = start_frame; i < end_frame; i++) {
-		uint64_t frame_start = timing_start();
-		size_t frame_idx;
+	deadline = test_completion_intended(comp) +
+		   (params->prebuffer + 1) * SEC_IN_NS / params->fps;
+	arrival = comp->start + test_completion_frame(comp);
+	slack = (int64_t)(deadline - arrival);
+	if (pb->frames == 1 || slack < pb->min_slack_ns)
+		pb->min_slack_ns = slack;
+	if (test_completion_intended_time(comp) > pb->startup_ns)
+		pb->startup_ns = test_completion_intended_time(comp);
+
+	if (slack < 0) {
+		++pb->late;
+		++pb->dropped;
+		if (++pb->miss_run > pb->max_miss_run)
+			pb->max_miss_run = pb->miss_run;
+	} else {
+		pb->miss_run = 0;
+	}
+}
 
-		res.completion[i - start_frame].start = frame_start;
-		switch (mode) {
-		case TEST_MODE_REVERSE:
-			frame_idx = end_frame - i + start_frame - 1;
-			break;
-		case TEST_MODE_RANDOM:
-			frame_idx = seq[i - start_frame];
-			break;
-		case TEST_MODE_NORM:
-		default:
-			frame_idx = i;
-			break;
-		}
-		if (!tester_frame_write(platform, path, frame, frame_idx, files,
-					&res.completion[i - start_frame],
-					res.is_remote_filesystem)) {
-			/* Phase 1: Record error and continue tracking */
-			res.frames_failed++;
-			record_error(&res, errno, "write", frame_idx, 0);
-			/* Phase 2: Continue instead of break to allow test to continue */
-			continue;
-		}
-		res.completion[i - start_frame].frame = timing_elapsed(frame_start);
-		++res.frames_written;
-		res.frames_succeeded++;
-		res.bytes_written += frame->size;
-
-		/* Phase 2: Track which I/O mode was used */
-		if (res.completion[i - start_frame].io_mode == IO_MODE_DIRECT) {
-			res.frames_direct_io++;
-		} else if (res.completion[i - start_frame].io_mode ==
-			   IO_MODE_BUFFERED) {
-			res.frames_buffered_io++;
-			res.fallback_count++;
-		}
+/* Prebuffer depth that would have absorbed the worst arrival */
+static void tester_playback_finish(test_result_t *res,
+				   const tester_params_t *params)
+{
+	playback_stats_t *pb = &res->playback_stats;
+	uint64_t period = SEC_IN_NS / params->fps;
+	uint64_t periods = (pb->startup_ns + period - 1) / period;
 
-		/* Phase 3: Track performance metrics */
-		uint64_t frame_time = res.completion[i - start_frame].frame;
-		if (frame_time > 0) {
-			if (frame_time < res.min_frame_time_ns) {
-				res.min_frame_time_ns = frame_time;
-			}
-			if (frame_time > res.max_frame_time_ns) {
-				res.max_frame_time_ns = frame_time;
-			}
-		}
+	pb->startup_frames = periods ? periods - 1 : 0;
+}
 
-		/* If fps limit is enabled loop until frame budget is gone */
-		if (fps && budget) {
-			uint64_t frame_elapsed = timing_elapsed(frame_start);
+/* Keep the record of a frame, overwriting the oldest one when full */
+static inline void tester_completion_store(test_result_t *res,
+					   const test_completion_t *comp)
+{
+	if (!res->completion_cap)
+		return;
+	res->completion[(res->frames_written - 1) % res->completion_cap] =
+		*comp;
+	if (res->completion_cnt < res->completion_cap)
+		++res->completion_cnt;
+}
 
-			while (frame_elapsed < budget) {
-				platform->usleep(100);
-				frame_elapsed = timing_elapsed(frame_start);
-			}
-		}
+static inline void tester_completion_reverse(test_completion_t *comp,
+					     size_t cnt)
+{
+	size_t i;
+
+	for (i = 0; i < cnt / 2; i++) {
+		test_completion_t tmp = comp[i];
+
+		comp[i] = comp[cnt - i - 1];
+		comp[cnt - i - 1] = tmp;
+	}
+}
+
+/* Rotate a wrapped record ring so the oldest record comes first */
+static void tester_completion_unwrap(test_result_t *res)
+{
+	size_t first;
+
+	if (res->frames_written <= res->completion_cap)
+		return;
+	first = res->frames_written % res->completion_cap;
+	if (!first)
+		return;
+	tester_completion_reverse(res->completion, first);
+	tester_completion_reverse(res->completion + first,
+				  res->completion_cap - first);
+	tester_completion_reverse(res->completion, res->completion_cap);
+}
+
+/* Frame number frame of the run is part of the warm-up */
+static inline int tester_frame_warmup(const test_result_t *res,
+				      const tester_params_t *params,
+				      uint64_t frame,
+				      const test_completion_t *comp)
+{
+	uint64_t begin = params->begin ? params->begin : res->first_start;
+
+	return frame < params->warmup_frames ||
+	       (params->warmup && comp->start < begin + params->warmup);
+}
+
+/*
+ * Flag the warm-up and cool-down records of an unwrapped ring. Record i
+ * is frame frames_written - completion_cnt + i of the run, a window in
+ * time counts from begin (or the first frame) and back from the end of
+ * the last frame. Cool-down frames leave the histograms here.
+ */
+static void tester_completion_exclude(test_result_t *res,
+				      const tester_params_t *params)
+{
+	const test_completion_t *last;
+	uint64_t first;
+	uint64_t end;
+	size_t i;
+
+	res->completion_excluded = 0;
+	if (!res->completion_cnt)
+		return;
+	first = res->frames_written - res->completion_cnt;
+	last = &res->completion[res->completion_cnt - 1];
+	end = last->start + test_completion_frame(last);
+
+	for (i = 0; i < res->completion_cnt; i++) {
+		test_completion_t *comp = &res->completion[i];
+		uint64_t frame = first + i;
+		uint64_t frame_time = test_completion_frame(comp);
+		int warmup = tester_frame_warmup(res, params, frame, comp);
+		int cooldown =
+			frame + params->cooldown_frames >= res->frames_written ||
+			(params->cooldown &&
+			 comp->start + frame_time + params->cooldown > end);
+
+		test_completion_exclude(comp, warmup || cooldown);
+		res->completion_excluded += warmup || cooldown;
+		if (!cooldown || warmup || !res->hist)
+			continue;
+		hist_remove(res->hist, frame_time);
+		if (res->hist_intended)
+			hist_remove(res->hist_intended,
+				    test_completion_intended_time(comp));
+	}
+}
+
+/* Account the record of a successful frame, as logged or live */
+static void tester_frame_record(test_result_t *res,
+				const tester_params_t *params,
+				const test_completion_t *comp)
+{
+	uint64_t frame_time = test_completion_frame(comp);
+	io_mode_t io_mode = test_completion_io_mode(comp);
+
+	++res->frames_written;
+	tester_completion_store(res, comp);
+	if (res->frames_written == 1)
+		res->first_start = comp->start;
+	/* Cool-down frames are only known at the end, they come out then */
+	if (res->hist && !tester_frame_warmup(res, params, res->frames_written - 1,
+					      comp)) {
+		hist_record(res->hist, frame_time);
+		if (res->hist_intended)
+			hist_record(res->hist_intended,
+				    test_completion_intended_time(comp));
+	}
+	res->frames_succeeded++;
+
+	/* Phase 2: Track which I/O mode was used */
+	if (io_mode == IO_MODE_DIRECT) {
+		res->frames_direct_io++;
+	} else if (io_mode == IO_MODE_BUFFERED) {
+		res->frames_buffered_io++;
+		res->fallback_count++;
+	}
+
+	/* Phase 3: Track performance metrics */
+	if (frame_time > 0) {
+		if (frame_time < res->min_frame_time_ns)
+			res->min_frame_time_ns = frame_time;
+		if (frame_time > res->max_frame_time_ns)
+			res->max_frame_time_ns = frame_time;
 	}
+}
+
+/* Account one successfully transferred frame */
+static void tester_frame_done(test_result_t *res, const tester_params_t *params,
+			      const test_frame_timing_t *timing)
+{
+	test_completion_t comp;
+
+	/* Everything below sees the frame as it is recorded */
+	test_completion_pack(&comp, timing);
+	if (params->log)
+		complog_append(params->log, &comp);
+	tester_frame_record(res, params, &comp);
+	res->bytes_written += params->frame->size;
+
+	tester_playback_frame(res, params, &comp);
+
+	if (params->cb)
+		params->cb(params->cb_ctx,
+			   res->frames_written + res->frames_failed,
+			   params->frame->size, test_completion_frame(&comp),
+			   timing->io_mode, 1);
+}
+
+/* Account one failed frame, err is the errno of the failure */
+static void tester_frame_failed(test_result_t *res,
+				const tester_params_t *params, test_op_t op,
+				size_t frame_idx, int err)
+{
+	/* Phase 1: Record error and continue tracking */
+	res->frames_failed++;
+	record_error(res, err, tester_op_name(op), frame_idx, 0);
+	tester_playback_frame(res, params, NULL);
+
+	if (params->cb)
+		params->cb(params->cb_ctx,
+			   res->frames_written + res->frames_failed, 0, 0,
+			   IO_MODE_UNKNOWN, 0);
+}
+
+static void tester_result_finish(test_result_t *res)
+{
+	size_t frames = res->completion_cnt - res->completion_excluded;
 
 	/* Phase 1: Calculate success rate */
-	if (res.frames_succeeded + res.frames_failed > 0) {
-		res.success_rate_percent =
-			(res.frames_succeeded * 100.0) /
-			(res.frames_succeeded + res.frames_failed);
+	if (res->frames_succeeded + res->frames_failed > 0) {
+		res->success_rate_percent =
+			(res->frames_succeeded * 100.0) /
+			(res->frames_succeeded + res->frames_failed);
 	}
 
 	/* Phase 2: Calculate Direct I/O success rate */
-	if (res.frames_direct_io + res.frames_buffered_io > 0) {
-		res.direct_io_success_rate =
-			(res.frames_direct_io * 100.0) /
-			(res.frames_direct_io + res.frames_buffered_io);
+	if (res->frames_direct_io + res->frames_buffered_io > 0) {
+		res->direct_io_success_rate =
+			(res->frames_direct_io * 100.0) /
+			(res->frames_direct_io + res->frames_buffered_io);
+	}
+
+	/* Steady state only, min/max were tracked over every frame */
+	if (res->completion_excluded) {
+		res->min_frame_time_ns = UINT64_MAX;
+		res->max_frame_time_ns = 0;
+		for (size_t j = 0; j < res->completion_cnt; j++) {
+			const test_completion_t *comp = &res->completion[j];
+			uint64_t frame_time = test_completion_frame(comp);
+
+			if (test_completion_excluded(comp) || !frame_time)
+				continue;
+			if (frame_time < res->min_frame_time_ns)
+				res->min_frame_time_ns = frame_time;
+			if (frame_time > res->max_frame_time_ns)
+				res->max_frame_time_ns = frame_time;
+		}
 	}
 
 	/* Phase 3: Calculate performance trend and average frame time */
-	if (res.frames_succeeded > 0 && res.min_frame_time_ns != UINT64_MAX) {
+	if (res->frames_succeeded > 0 && res->min_frame_time_ns != UINT64_MAX) {
 		/* Calculate average frame time */
 		uint64_t total_frame_time = 0;
-		for (size_t j = 0; j < frames; j++) {
-			if (res.completion[j].frame > 0) {
-				total_frame_time += res.completion[j].frame;
-			}
+		for (size_t j = 0; j < res->completion_cnt; j++) {
+			if (test_completion_excluded(&res->completion[j]))
+				continue;
+			total_frame_time +=
+				test_completion_frame(&res->completion[j]);
 		}
-		res.avg_frame_time_ns =
-			(res.frames_succeeded > 0) ?
-				(total_frame_time / res.frames_succeeded) :
-				0;
+		res->avg_frame_time_ns =
+			frames ? (total_frame_time / frames) : 0;
 
 		/* Calculate performance trend using first half vs second half comparison */
-		if (res.frames_succeeded > 10) {
+		if (frames > 10) {
 			uint64_t first_half_time = 0, second_half_time = 0;
 			int first_half_count = 0, second_half_count = 0;
-			int mid = res.frames_succeeded / 2;
+			int mid = frames / 2;
 
-			for (size_t j = 0; j < frames; j++) {
-				if (res.completion[j].frame > 0) {
+			for (size_t j = 0; j < res->completion_cnt; j++) {
+				const test_completion_t *comp =
+					&res->completion[j];
+				uint64_t frame_time =
+					test_completion_frame(comp);
+
+				if (test_completion_excluded(comp))
+					continue;
+				if (frame_time > 0) {
 					if (first_half_count < mid) {
-						first_half_time +=
-							res.completion[j].frame;
+						first_half_time += frame_time;
 						first_half_count++;
 					} else {
-						second_half_time +=
-							res.completion[j].frame;
+						second_half_time += frame_time;
 						second_half_count++;
 					}
 				}
@@ -424,487 +842,945 @@ test_result_t tester_run_write(const platform_t *platform, const char *path,
 					second_half_time / second_half_count;
 
 				if (second_avg < first_avg) {
-					res.performance_trend =
+					res->performance_trend =
 						1.0; /* Improving */
 				} else if (second_avg > first_avg) {
-					res.performance_trend =
+					res->performance_trend =
 						-1.0; /* Degrading */
 				} else {
-					res.performance_trend =
+					res->performance_trend =
 						0.0; /* Stable */
 				}
 			}
 		}
 	}
-
-	if (seq)
-		platform->free(seq);
-	return res;
 }
 
-test_result_t tester_run_read(const platform_t *platform, const char *path,
-			      frame_t *frame, size_t start_frame, size_t frames,
-			      size_t fps, test_mode_t mode, test_files_t files)
+/*
+ * Frame pacing on absolute deadlines: frame k is due at t0 + k / fps,
+ * t0 being the start of the first frame. Late wakeups and rounding never
+ * carry over to the next frame, so long runs stay phase-locked to the
+ * nominal rate instead of drifting.
+ */
+typedef struct tester_pacer_t {
+	uint64_t t0;
+	size_t fps;
+	uint64_t spin;
+} tester_pacer_t;
+
+static inline void tester_pacer_init(tester_pacer_t *pacer,
+				     const tester_params_t *params)
 {
-	test_result_t res = { 0 };
-	size_t i;
-	size_t budget;
-	size_t end_frame;
-	size_t *seq = NULL;
+	pacer->t0 = 0;
+	pacer->fps = params->fps;
+	pacer->spin = params->pace_spin;
+}
 
-	res.completion = platform->calloc(frames, sizeof(*res.completion));
-	if (!res.completion)
-		return res;
-
-	/* Phase 1: Initialize error tracking */
-	res.frames_failed = 0;
-	res.frames_succeeded = 0;
-	res.error_count = 0;
-	res.max_errors = 0;
-	res.errors = NULL;
-	res.direct_io_available = 1;
+static inline uint64_t tester_pacer_deadline(const tester_pacer_t *pacer,
+					     size_t k)
+{
+	/* Split to stay exact without overflowing on long runs */
+	return pacer->t0 + (uint64_t)(k / pacer->fps) * SEC_IN_NS +
+	       (uint64_t)(k % pacer->fps) * SEC_IN_NS / pacer->fps;
+}
 
-	/* Phase 2: Initialize I/O fallback tracking */
-	res.frames_direct_io = 0;
-	res.frames_buffered_io = 0;
-	res.fallback_count = 0;
-	res.direct_io_success_rate = 0.0;
+/* Scheduled start of frame k, 0 when not paced */
+static inline uint64_t tester_pacer_intended(const tester_pacer_t *pacer,
+					     size_t k)
+{
+	return pacer->fps ? tester_pacer_deadline(pacer, k) : 0;
+}
 
-	budget = fps ? (SEC_IN_NS / fps) : 0;
-	end_frame = start_frame + frames;
+static inline void tester_sleep_until(const platform_t *platform,
+				      uint64_t deadline)
+{
+	uint64_t now;
 
-	if (mode == TEST_MODE_RANDOM) {
-		seq = platform->malloc(sizeof(*seq) * frames);
-		if (!seq) {
-			platform->free(res.completion);
-			res.completion = NULL;
-			return res;
-		}
+	if (platform->sleep_until) {
+		platform->sleep_until(deadline);
+		return;
+	}
+	now = timing_time();
+	if (deadline > now)
+		platform->usleep((deadline - now) / 1000);
+}
 
-		for (i = 0; i < frames; i++)
-			seq[i] = i + start_frame;
-		shuffle_array(seq, frames);
+/*
+ * Returns 1 if frame k may start now. The first frame starts the clock
+ * unless t0 was set in advance.
+ */
+static inline int tester_pacer_due(tester_pacer_t *pacer, size_t k)
+{
+	if (!pacer->fps)
+		return 1;
+	if (!k && !pacer->t0) {
+		pacer->t0 = timing_time();
+		return 1;
 	}
 
-	for (i = start_frame; i < start_frame + frames; i++) {
-		uint64_t frame_start = timing_start();
-		size_t frame_idx;
+	return timing_time() >= tester_pacer_deadline(pacer, k);
+}
 
-		res.completion[i - start_frame].start = frame_start;
-		switch (mode) {
-		case TEST_MODE_REVERSE:
-			frame_idx = end_frame - i + start_frame - 1;
-			break;
-		case TEST_MODE_RANDOM:
-			frame_idx = seq[i - start_frame];
-			break;
-		case TEST_MODE_NORM:
-		default:
-			frame_idx = i;
-			break;
-		}
-		if (!tester_frame_read(platform, path, frame, frame_idx, files,
-				       &res.completion[i - start_frame],
-				       res.is_remote_filesystem)) {
-			/* Phase 1: Record error and continue tracking */
-			res.frames_failed++;
-			record_error(&res, errno, "read", frame_idx, 0);
+/*
+ * Block until frame k is due. Sleeps up to spin nanoseconds before the
+ * deadline and busy-waits the rest, trading CPU for wakeup accuracy.
+ */
+static inline void tester_pacer_wait(const platform_t *platform,
+				     tester_pacer_t *pacer, size_t k)
+{
+	uint64_t deadline;
+
+	if (tester_pacer_due(pacer, k))
+		return;
+
+	deadline = tester_pacer_deadline(pacer, k);
+	if (deadline > pacer->spin)
+		tester_sleep_until(platform, deadline - pacer->spin);
+	while (timing_time() < deadline)
+		;
+}
+
+/*
+ * One frame at a time: open, read/write and close before the next one,
+ * or only read/write when the handles were opened in advance.
+ */
+static void tester_run_sync(const platform_t *platform, test_op_t op,
+			    const tester_params_t *params, const size_t *seq,
+			    tester_handle_t *handles, test_result_t *res)
+{
+	frame_t frame = *params->frame;
+	tester_pacer_t pacer;
+	size_t frame_idx;
+	size_t i;
+
+	frame.data = tester_slot_buf(params, 0);
+
+	tester_pacer_init(&pacer, params);
+
+	for (i = 0; tester_next_frame(params, seq, i, &frame_idx); i++) {
+		test_frame_timing_t frame_comp = { 0 };
+		test_frame_timing_t *comp = &frame_comp;
+		size_t ret;
+
+		tester_pacer_wait(platform, &pacer, i);
+		tester_frame_stamp(params, op, frame.data, frame_idx);
+		comp->start = timing_start();
+		comp->intended = tester_pacer_intended(&pacer, i);
+		if (handles)
+			ret = tester_frame_cached(
+				platform, op, params, &frame,
+				tester_handle_get(handles, params, frame_idx),
+				frame_idx, comp);
+		else if (op == TEST_OP_WRITE)
+			ret = tester_frame_write(platform, params->path,
+						 &frame, frame_idx,
+						 params->files, comp,
+						 res->is_remote_filesystem,
+						 params->request_size);
+		else
+			ret = tester_frame_read(platform, params->path,
+						&frame, frame_idx,
+						params->files, comp,
+						res->is_remote_filesystem,
+						params->request_size);
+		if (!ret) {
+			tester_frame_failed(res, params, op, frame_idx, errno);
 			/* Phase 2: Continue instead of break to allow test to continue */
 			continue;
 		}
-		res.completion[i - start_frame].frame = timing_elapsed(frame_start);
-		++res.frames_written;
-		res.frames_succeeded++;
-		res.bytes_written += frame->size;
-
-		/* Phase 2: Track which I/O mode was used */
-		if (res.completion[i - start_frame].io_mode == IO_MODE_DIRECT) {
-			res.frames_direct_io++;
-		} else if (res.completion[i - start_frame].io_mode ==
-			   IO_MODE_BUFFERED) {
-			res.frames_buffered_io++;
-			res.fallback_count++;
-		}
+		tester_frame_done(res, params, comp);
+	}
+	/* The last frame owns its full period as well */
+	if (i)
+		tester_pacer_wait(platform, &pacer, i);
+}
 
-		/* Phase 3: Track performance metrics */
-		uint64_t frame_time = res.completion[i - start_frame].frame;
-		if (frame_time > 0) {
-			if (frame_time < res.min_frame_time_ns) {
-				res.min_frame_time_ns = frame_time;
-			}
-			if (frame_time > res.max_frame_time_ns) {
-				res.max_frame_time_ns = frame_time;
+static inline void tester_async_prepare(const tester_params_t *params,
+					test_op_t op, size_t frame_idx,
+					size_t slot, int is_remote_fs,
+					platform_aio_req_t *req)
+{
+	(void)tester_frame_name(req->name, params->path, frame_idx,
+				params->files);
+
+	req->op = op == TEST_OP_WRITE ? PLATFORM_AIO_WRITE : PLATFORM_AIO_READ;
+	req->flags = op == TEST_OP_WRITE ?
+			     PLATFORM_OPEN_CREATE | PLATFORM_OPEN_WRITE :
+			     PLATFORM_OPEN_READ;
+	/* Phase 3: Skip Direct I/O on remote filesystems */
+	if (!is_remote_fs)
+		req->flags |= PLATFORM_OPEN_DIRECT;
+	req->mode = 0666;
+	req->buf = tester_slot_buf(params, slot);
+	req->size = params->frame->size;
+	req->chunk = params->request_size;
+	req->offset = params->files == TEST_FILES_SINGLE ?
+			      (platform_off_t)(frame_idx * params->frame->size) :
+			      0;
+}
+
+/*
+ * Handle a completed asynchronous frame. Returns 1 if the request was
+ * submitted again and is still in flight.
+ */
+static int tester_async_complete(const platform_t *platform,
+				 platform_aio_t *aio, test_op_t op,
+				 const tester_params_t *params,
+				 size_t frame_idx, platform_aio_req_t *req,
+				 test_frame_timing_t *comp, test_result_t *res)
+{
+	/* Phase 2: Direct I/O refused at open, retry buffered */
+	if (req->open_failed && (req->flags & PLATFORM_OPEN_DIRECT)) {
+		req->flags &= ~PLATFORM_OPEN_DIRECT;
+		if (!platform->aio_submit(aio, req))
+			return 1;
+	}
+
+	if (req->error || (!req->res && req->size)) {
+		tester_frame_failed(res, params, op, frame_idx,
+				    req->error ? req->error : EIO);
+		return 0;
+	}
+
+	comp->open = req->open_ns;
+	comp->io = req->io_ns;
+	comp->close = req->close_ns;
+	comp->io_mode = (req->flags & PLATFORM_OPEN_DIRECT) ? IO_MODE_DIRECT :
+							      IO_MODE_BUFFERED;
+	tester_frame_done(res, params, comp);
+
+	return 0;
+}
+
+/* Bytes per stripe, rounded up so every stripe but the last stays aligned */
+static inline size_t tester_stripe_size(size_t size, size_t stripes)
+{
+	size_t stripe = (size + stripes - 1) / stripes;
+
+	return (stripe + ALIGN_SIZE - 1) & ~((size_t)ALIGN_SIZE - 1);
+}
+
+/*
+ * Frames one at a time, each striped in byte ranges over params->stripes
+ * requests in flight together. A frame is complete when its last stripe
+ * lands, so its latency is the one of the slowest stripe.
+ */
+static void tester_run_striped(const platform_t *platform, platform_aio_t *aio,
+			       test_op_t op, const tester_params_t *params,
+			       const size_t *seq, test_result_t *res)
+{
+	platform_aio_req_t *reqs;
+	size_t stripe = tester_stripe_size(params->frame->size, params->stripes);
+	tester_pacer_t pacer;
+	size_t frame_idx;
+	size_t i;
+
+	reqs = platform->calloc(params->stripes, sizeof(*reqs));
+	if (!reqs) {
+		tester_run_sync(platform, op, params, seq, NULL, res);
+		return;
+	}
+
+	tester_pacer_init(&pacer, params);
+
+	for (i = 0; tester_next_frame(params, seq, i, &frame_idx); i++) {
+		test_frame_timing_t frame_comp = { 0 };
+		test_frame_timing_t *comp = &frame_comp;
+		size_t submitted = 0;
+		size_t done = 0;
+		int err = 0;
+		size_t k;
+
+		tester_pacer_wait(platform, &pacer, i);
+		tester_frame_stamp(params, op, tester_slot_buf(params, 0),
+				   frame_idx);
+		comp->start = timing_start();
+		comp->intended = tester_pacer_intended(&pacer, i);
+		for (k = 0; k < params->stripes; k++) {
+			platform_aio_req_t *req = &reqs[k];
+			size_t offs = k * stripe;
+
+			if (offs >= params->frame->size && k)
+				break;
+			/* Stripes are byte ranges of the frame in slot 0 */
+			tester_async_prepare(params, op, frame_idx, 0,
+					     res->is_remote_filesystem, req);
+			req->buf += offs;
+			req->offset += offs;
+			req->size = params->frame->size - offs;
+			if (req->size > stripe)
+				req->size = stripe;
+			req->tag = i;
+			if (platform->aio_submit(aio, req)) {
+				err = EAGAIN;
+				break;
 			}
+			++submitted;
 		}
 
-		/* If fps limit is enabled loop until frame budget is gone */
-		if (fps && budget) {
-			uint64_t frame_elapsed = timing_elapsed(frame_start);
+		comp->open = 0;
+		comp->io = 0;
+		comp->close = 0;
+		comp->io_mode = IO_MODE_DIRECT;
+		/* Wait until every stripe landed */
+		while (done < submitted) {
+			platform_aio_req_t *req = platform->aio_reap(aio, 1);
+
+			if (!req) {
+				/* Engine failure, nothing more will complete */
+				tester_frame_failed(res, params, op, frame_idx,
+						    EIO);
+				platform->free(reqs);
+				return;
+			}
+			/* Phase 2: Direct I/O refused at open, retry buffered */
+			if (req->open_failed &&
+			    (req->flags & PLATFORM_OPEN_DIRECT)) {
+				req->flags &= ~PLATFORM_OPEN_DIRECT;
+				if (!platform->aio_submit(aio, req))
+					continue;
+			}
+			++done;
 
-			while (frame_elapsed < budget) {
-				platform->usleep(100);
-				frame_elapsed = timing_elapsed(frame_start);
+			if (req->error || (!req->res && req->size)) {
+				if (!err)
+					err = req->error ? req->error : EIO;
+				continue;
 			}
+			if (!(req->flags & PLATFORM_OPEN_DIRECT))
+				comp->io_mode = IO_MODE_BUFFERED;
+			if (req->open_ns > comp->open)
+				comp->open = req->open_ns;
+			if (req->io_ns > comp->io)
+				comp->io = req->io_ns;
+			if (req->close_ns > comp->close)
+				comp->close = req->close_ns;
 		}
-	}
 
-	/* Phase 1: Calculate success rate */
-	if (res.frames_succeeded + res.frames_failed > 0) {
-		res.success_rate_percent =
-			(res.frames_succeeded * 100.0) /
-			(res.frames_succeeded + res.frames_failed);
+		if (err) {
+			tester_frame_failed(res, params, op, frame_idx, err);
+			continue;
+		}
+		tester_frame_done(res, params, comp);
 	}
+	if (i)
+		tester_pacer_wait(platform, &pacer, i);
 
-	/* Phase 2: Calculate Direct I/O success rate */
-	if (res.frames_direct_io + res.frames_buffered_io > 0) {
-		res.direct_io_success_rate =
-			(res.frames_direct_io * 100.0) /
-			(res.frames_direct_io + res.frames_buffered_io);
+	platform->free(reqs);
+}
+
+/* Keep up to queue_depth frames in flight on an asynchronous engine */
+static void tester_run_async(const platform_t *platform, platform_aio_t *aio,
+			     test_op_t op, const tester_params_t *params,
+			     const size_t *seq, test_result_t *res)
+{
+	platform_aio_req_t *reqs;
+	platform_aio_req_t **free_reqs;
+	size_t *frame_of;
+	test_frame_timing_t *comps; /* Frames in flight, by request */
+	size_t depth = params->queue_depth ? params->queue_depth : 1;
+	size_t free_cnt;
+	tester_pacer_t pacer;
+	size_t next = 0;
+	size_t inflight = 0;
+	int more = 1;
+	size_t i;
+
+	reqs = platform->calloc(depth, sizeof(*reqs));
+	free_reqs = platform->calloc(depth, sizeof(*free_reqs));
+	frame_of = platform->calloc(depth, sizeof(*frame_of));
+	comps = platform->calloc(depth, sizeof(*comps));
+	if (!reqs || !free_reqs || !frame_of || !comps) {
+		if (reqs)
+			platform->free(reqs);
+		if (free_reqs)
+			platform->free(free_reqs);
+		if (frame_of)
+			platform->free(frame_of);
+		if (comps)
+			platform->free(comps);
+		tester_run_sync(platform, op, params, seq, NULL, res);
+		return;
 	}
+	for (i = 0; i < depth; i++)
+		free_reqs[i] = &reqs[i];
+	free_cnt = depth;
 
-	/* Phase 3: Calculate performance trend and average frame time */
-	if (res.frames_succeeded > 0 && res.min_frame_time_ns != UINT64_MAX) {
-		/* Calculate average frame time */
-		uint64_t total_frame_time = 0;
-		for (size_t j = 0; j < frames; j++) {
-			if (res.completion[j].frame > 0) {
-				total_frame_time += res.completion[j].frame;
-			}
-		}
-		res.avg_frame_time_ns =
-			(res.frames_succeeded > 0) ?
-				(total_frame_time / res.frames_succeeded) :
-				0;
+	tester_pacer_init(&pacer, params);
 
-		/* Calculate performance trend using first half vs second half comparison */
-		if (res.frames_succeeded > 10) {
-			uint64_t first_half_time = 0, second_half_time = 0;
-			int first_half_count = 0, second_half_count = 0;
-			int mid = res.frames_succeeded / 2;
+	while (more || inflight) {
+		platform_aio_req_t *req;
+		size_t frame_idx;
+		int paced = 0;
 
-			for (size_t j = 0; j < frames; j++) {
-				if (res.completion[j].frame > 0) {
-					if (first_half_count < mid) {
-						first_half_time +=
-							res.completion[j].frame;
-						first_half_count++;
-					} else {
-						second_half_time +=
-							res.completion[j].frame;
-						second_half_count++;
-					}
-				}
+		/* Fill the window, frames still start on their deadlines */
+		while (more && free_cnt) {
+			if (!tester_pacer_due(&pacer, next)) {
+				paced = 1;
+				break;
+			}
+			if (!tester_next_frame(params, seq, next, &frame_idx)) {
+				more = 0;
+				break;
 			}
 
-			if (first_half_count > 0 && second_half_count > 0) {
-				uint64_t first_avg =
-					first_half_time / first_half_count;
-				uint64_t second_avg =
-					second_half_time / second_half_count;
+			req = free_reqs[--free_cnt];
+			tester_async_prepare(params, op, frame_idx,
+					     (size_t)(req - reqs),
+					     res->is_remote_filesystem, req);
+			tester_frame_stamp(params, op, req->buf, frame_idx);
+			req->tag = next;
+			frame_of[req - reqs] = frame_idx;
+			memset(&comps[req - reqs], 0, sizeof(*comps));
+			comps[req - reqs].start = timing_start();
+			comps[req - reqs].intended =
+				tester_pacer_intended(&pacer, next);
+			if (platform->aio_submit(aio, req)) {
+				free_reqs[free_cnt++] = req;
+				tester_frame_failed(res, params, op, frame_idx,
+						    EAGAIN);
+			} else {
+				++inflight;
+			}
+			++next;
+		}
 
-				if (second_avg < first_avg) {
-					res.performance_trend =
-						1.0; /* Improving */
-				} else if (second_avg > first_avg) {
-					res.performance_trend =
-						-1.0; /* Degrading */
-				} else {
-					res.performance_trend =
-						0.0; /* Stable */
-				}
+		if (paced) {
+			/* Collect what landed, then sleep until the next frame */
+			req = inflight ? platform->aio_reap(aio, 0) : NULL;
+			if (!req) {
+				tester_pacer_wait(platform, &pacer, next);
+				continue;
 			}
+		} else {
+			if (!inflight)
+				continue;
+			req = platform->aio_reap(aio, 1);
+			/* Engine failure, nothing more will complete */
+			if (!req)
+				break;
 		}
+		if (tester_async_complete(platform, aio, op, params,
+					  frame_of[req - reqs], req,
+					  &comps[req - reqs], res))
+			continue;
+		--inflight;
+		free_reqs[free_cnt++] = req;
 	}
+	if (next)
+		tester_pacer_wait(platform, &pacer, next);
 
-	if (seq)
-		platform->free(seq);
-	return res;
+	platform->free(comps);
+	platform->free(frame_of);
+	platform->free(free_reqs);
+	platform->free(reqs);
 }
 
-/* Callback-enabled versions for TUI progress updates */
+/* Completion array, result state and random order of one run */
+static void tester_run_init_free(const platform_t *platform,
+				 test_result_t *res)
+{
+	platform->free(res->completion);
+	res->completion = NULL;
+	res->completion_cap = 0;
+	hist_destroy(res->hist);
+	hist_destroy(res->hist_intended);
+	res->hist = NULL;
+	res->hist_intended = NULL;
+}
 
-test_result_t tester_run_write_cb(const platform_t *platform, const char *path,
-				  frame_t *frame, size_t start_frame,
-				  size_t frames, size_t fps, test_mode_t mode,
-				  test_files_t files, tester_progress_cb cb,
-				  void *cb_ctx)
+static int tester_run_init(const platform_t *platform,
+			   const tester_params_t *params, test_result_t *res,
+			   size_t **seq)
 {
-	test_result_t res = { 0 };
+	size_t records = params->records ? params->records : params->frames;
 	size_t i;
-	size_t budget;
-	size_t end_frame;
-	size_t *seq = NULL;
 
-	res.completion = platform->calloc(frames, sizeof(*res.completion));
-	if (!res.completion)
-		return res;
+	*seq = NULL;
+	res->completion = platform->calloc(records, sizeof(*res->completion));
+	if (!res->completion && records)
+		return 1;
+	res->completion_cap = records;
+	if (params->hist_digits) {
+		res->hist = hist_create(HIST_LOWEST, HIST_HIGHEST,
+					params->hist_digits);
+		if (params->fps)
+			res->hist_intended = hist_create(
+				HIST_LOWEST, HIST_HIGHEST, params->hist_digits);
+		if (!res->hist || (params->fps && !res->hist_intended)) {
+			tester_run_init_free(platform, res);
+			return 1;
+		}
+	}
 
-	res.frames_failed = 0;
-	res.frames_succeeded = 0;
-	res.error_count = 0;
-	res.max_errors = 0;
-	res.errors = NULL;
-	res.direct_io_available = 1;
-	res.frames_direct_io = 0;
-	res.frames_buffered_io = 0;
-	res.fallback_count = 0;
-	res.direct_io_success_rate = 0.0;
-	res.filesystem_type = platform_detect_filesystem(path);
-	res.is_remote_filesystem = (res.filesystem_type == FILESYSTEM_NFS ||
-				    res.filesystem_type == FILESYSTEM_SMB) ?
-					   1 :
-					   0;
-	res.skipped_direct_io_attempt = 0;
-	res.min_frame_time_ns = UINT64_MAX;
-	res.max_frame_time_ns = 0;
-	res.avg_frame_time_ns = 0;
-	res.performance_trend = 0.0;
-	res.network_timeout_ns =
-		platform_get_network_timeout(res.filesystem_type);
-
-	budget = fps ? (SEC_IN_NS / fps) : 0;
-	end_frame = start_frame + frames;
+	tester_result_init(res, params->path);
+	/* Display deadlines only exist on a paced schedule */
+	res->playback = params->playback && params->fps;
+	res->prebuffer = params->prebuffer;
 
-	if (mode == TEST_MODE_RANDOM) {
-		seq = platform->malloc(sizeof(*seq) * frames);
-		if (!seq) {
-			platform->free(res.completion);
-			res.completion = NULL;
-			return res;
+	/* Dynamic runs take the order from the shared dispatcher */
+	if (params->mode == TEST_MODE_RANDOM && !params->dispatch) {
+		*seq = platform->malloc(sizeof(**seq) * params->frames);
+		if (!*seq) {
+			tester_run_init_free(platform, res);
+			return 1;
 		}
-		for (i = 0; i < frames; i++)
-			seq[i] = start_frame + i;
-		shuffle_array(seq, frames);
+
+		for (i = 0; i < params->frames; i++)
+			(*seq)[i] = params->start_frame + i;
+		shuffle_array(*seq, params->frames);
 	}
 
-	for (i = start_frame; i < end_frame; i++) {
-		uint64_t frame_start = timing_start();
-		size_t frame_idx;
-		int success = 0;
-		uint64_t frame_time_ns = 0;
-		io_mode_t io_mode = IO_MODE_UNKNOWN;
-
-		res.completion[i - start_frame].start = frame_start;
-		switch (mode) {
-		case TEST_MODE_REVERSE:
-			frame_idx = end_frame - i + start_frame - 1;
-			break;
-		case TEST_MODE_RANDOM:
-			frame_idx = seq[i - start_frame];
-			break;
-		case TEST_MODE_NORM:
-		default:
-			frame_idx = i;
-			break;
-		}
+	return 0;
+}
 
-		if (!tester_frame_write(platform, path, frame, frame_idx, files,
-					&res.completion[i - start_frame],
-					res.is_remote_filesystem)) {
-			res.frames_failed++;
-			record_error(&res, errno, "write", frame_idx, 0);
-			if (cb)
-				cb(cb_ctx,
-				   res.frames_written + res.frames_failed, 0, 0,
-				   IO_MODE_UNKNOWN, 0);
+static void tester_run_finish(const platform_t *platform,
+			      const tester_params_t *params, test_result_t *res,
+			      size_t *seq)
+{
+	tester_completion_unwrap(res);
+	tester_completion_exclude(res, params);
+	tester_result_finish(res);
+	if (res->playback)
+		tester_playback_finish(res, params);
+
+	if (seq)
+		platform->free(seq);
+}
+
+/*
+ * Poll interval of the event loop while a frame in flight is needed back
+ * before the next deadline, or belongs to an unpaced stream.
+ */
+#define TESTER_VSTREAM_POLL_NS 200000
+
+/* Private state of a virtual stream while the event loop drives it */
+typedef struct tester_vstream_state_t {
+	tester_vstream_t *vs;
+	platform_aio_req_t req;
+	test_frame_timing_t comp; /* Frame in flight */
+	tester_pacer_t pacer;
+	size_t *seq;
+	size_t next; /* Position of the next frame to start */
+	size_t frame_idx; /* Frame in flight */
+	uint64_t start;
+	int busy;
+	int done;
+} tester_vstream_state_t;
+
+/* A stream ran out of frames, or the engine failed under it */
+static void tester_vstream_finish(const platform_t *platform,
+				  tester_vstream_state_t *st)
+{
+	tester_vstream_t *vs = st->vs;
+
+	st->done = 1;
+	vs->res.time_taken_ns = st->start ? timing_elapsed(st->start) : 0;
+	tester_run_finish(platform, &vs->params, &vs->res, st->seq);
+	st->seq = NULL;
+}
+
+/*
+ * Start the next frame of every idle stream that is due. Returns the
+ * earliest deadline of an idle stream that isn't, UINT64_MAX if none.
+ */
+static uint64_t tester_vstreams_start(const platform_t *platform,
+				      platform_aio_t *aio, test_op_t op,
+				      tester_vstream_state_t *states,
+				      size_t cnt, size_t depth,
+				      size_t *inflight, size_t *first,
+				      size_t *active)
+{
+	uint64_t wake = UINT64_MAX;
+	size_t scanned;
+
+	/* Rotate the first stream so scarce slots are handed out fairly */
+	for (scanned = 0; scanned < cnt; scanned++) {
+		size_t k = (*first + scanned) % cnt;
+		tester_vstream_state_t *st = &states[k];
+		tester_vstream_t *vs = st->vs;
+		test_frame_timing_t *comp = &st->comp;
+
+		if (st->busy || st->done)
+			continue;
+		if (!tester_next_frame(&vs->params, st->seq, st->next,
+				       &st->frame_idx)) {
+			tester_vstream_finish(platform, st);
+			--*active;
 			continue;
 		}
+		if (!tester_pacer_due(&st->pacer, st->next)) {
+			uint64_t deadline =
+				tester_pacer_deadline(&st->pacer, st->next);
 
-		res.completion[i - start_frame].frame = timing_elapsed(frame_start);
-		++res.frames_written;
-		res.frames_succeeded++;
-		res.bytes_written += frame->size;
-		success = 1;
-		io_mode = res.completion[i - start_frame].io_mode;
-
-		if (io_mode == IO_MODE_DIRECT)
-			res.frames_direct_io++;
-		else if (io_mode == IO_MODE_BUFFERED) {
-			res.frames_buffered_io++;
-			res.fallback_count++;
+			if (deadline < wake)
+				wake = deadline;
+			continue;
 		}
+		if (*inflight >= depth)
+			continue;
 
-		frame_time_ns = timing_elapsed(frame_start);
-		if (frame_time_ns > 0) {
-			if (frame_time_ns < res.min_frame_time_ns)
-				res.min_frame_time_ns = frame_time_ns;
-			if (frame_time_ns > res.max_frame_time_ns)
-				res.max_frame_time_ns = frame_time_ns;
+		memset(comp, 0, sizeof(*comp));
+		tester_async_prepare(&vs->params, op, st->frame_idx, 0,
+				     vs->res.is_remote_filesystem, &st->req);
+		tester_frame_stamp(&vs->params, op, st->req.buf, st->frame_idx);
+		st->req.tag = st->next;
+		comp->start = timing_start();
+		comp->intended = tester_pacer_intended(&st->pacer, st->next);
+		if (!st->start)
+			st->start = comp->start;
+		++st->next;
+		if (platform->aio_submit(aio, &st->req)) {
+			tester_frame_failed(&vs->res, &vs->params, op,
+					    st->frame_idx, EAGAIN);
+			continue;
 		}
+		st->busy = 1;
+		++*inflight;
+		*first = (k + 1) % cnt;
+	}
 
-		if (cb)
-			cb(cb_ctx, res.frames_written + res.frames_failed,
-			   frame->size, frame_time_ns, io_mode, success);
+	return wake;
+}
 
-		if (fps && budget) {
-			uint64_t frame_elapsed = timing_elapsed(frame_start);
-			while (frame_elapsed < budget) {
-				platform->usleep(100);
-				frame_elapsed = timing_elapsed(frame_start);
-			}
-		}
-	}
+/*
+ * Earliest time a frame in flight may be needed back: the deadline of the
+ * next frame of its stream, no sooner than a short poll interval.
+ */
+static uint64_t tester_vstreams_busy_wake(const tester_vstream_state_t *states,
+					  size_t cnt)
+{
+	uint64_t poll = timing_time() + TESTER_VSTREAM_POLL_NS;
+	uint64_t wake = UINT64_MAX;
+	size_t k;
 
-	if (res.frames_succeeded + res.frames_failed > 0) {
-		res.success_rate_percent =
-			(res.frames_succeeded * 100.0) /
-			(res.frames_succeeded + res.frames_failed);
-	}
-	if (res.frames_direct_io + res.frames_buffered_io > 0) {
-		res.direct_io_success_rate =
-			(res.frames_direct_io * 100.0) /
-			(res.frames_direct_io + res.frames_buffered_io);
-	}
-	if (res.frames_succeeded > 0 && res.min_frame_time_ns != UINT64_MAX) {
-		uint64_t total_frame_time = 0;
-		for (size_t j = 0; j < frames; j++) {
-			if (res.completion[j].frame > 0)
-				total_frame_time += res.completion[j].frame;
+	for (k = 0; k < cnt; k++) {
+		const tester_vstream_state_t *st = &states[k];
+		uint64_t deadline = poll;
+
+		if (!st->busy)
+			continue;
+		if (st->pacer.fps &&
+		    (st->vs->params.end || st->next < st->vs->params.frames)) {
+			deadline = tester_pacer_deadline(&st->pacer, st->next);
+			if (deadline < poll)
+				deadline = poll;
 		}
-		res.avg_frame_time_ns =
-			(res.frames_succeeded > 0) ?
-				(total_frame_time / res.frames_succeeded) :
-				0;
+		if (deadline < wake)
+			wake = deadline;
 	}
 
-	if (seq)
-		platform->free(seq);
-	return res;
+	return wake;
 }
 
-test_result_t tester_run_read_cb(const platform_t *platform, const char *path,
-				 frame_t *frame, size_t start_frame,
-				 size_t frames, size_t fps, test_mode_t mode,
-				 test_files_t files, tester_progress_cb cb,
-				 void *cb_ctx)
+/*
+ * One set of histograms for all streams of the loop, hundreds of streams
+ * with one each would take hundreds of times the memory.
+ */
+static int tester_vstreams_hist(const tester_vstream_t *vstreams, size_t cnt,
+				test_result_t *hist_res)
 {
-	test_result_t res = { 0 };
-	size_t i;
-	size_t budget;
-	size_t end_frame;
-	size_t *seq = NULL;
+	unsigned int digits = vstreams[0].params.hist_digits;
+	size_t k;
 
-	res.completion = platform->calloc(frames, sizeof(*res.completion));
-	if (!res.completion)
-		return res;
+	if (!digits)
+		return 0;
+	hist_res->hist = hist_create(HIST_LOWEST, HIST_HIGHEST, digits);
+	if (!hist_res->hist)
+		return 1;
+	for (k = 0; k < cnt && !vstreams[k].params.fps; k++)
+		;
+	if (k == cnt)
+		return 0;
+	hist_res->hist_intended = hist_create(HIST_LOWEST, HIST_HIGHEST, digits);
 
-	res.frames_failed = 0;
-	res.frames_succeeded = 0;
-	res.error_count = 0;
-	res.max_errors = 0;
-	res.errors = NULL;
-	res.direct_io_available = 1;
-	res.frames_direct_io = 0;
-	res.frames_buffered_io = 0;
-	res.fallback_count = 0;
-	res.direct_io_success_rate = 0.0;
+	return !hist_res->hist_intended;
+}
 
-	budget = fps ? (SEC_IN_NS / fps) : 0;
-	end_frame = start_frame + frames;
+int tester_run_vstreams(const platform_t *platform, test_op_t op,
+			tester_vstream_t *vstreams, size_t cnt,
+			platform_engine_t engine, size_t depth,
+			test_result_t *hist_res)
+{
+	tester_vstream_state_t *states;
+	platform_aio_t *aio;
+	size_t inflight = 0;
+	size_t active = 0;
+	size_t first = 0;
+	uint64_t start;
+	size_t k;
+
+	if (!cnt)
+		return 0;
+	if (!platform->aio_create)
+		return 1;
+	if (!depth || depth > cnt)
+		depth = cnt;
 
-	if (mode == TEST_MODE_RANDOM) {
-		seq = platform->malloc(sizeof(*seq) * frames);
-		if (!seq) {
-			platform->free(res.completion);
-			res.completion = NULL;
-			return res;
-		}
-		for (i = 0; i < frames; i++)
-			seq[i] = i + start_frame;
-		shuffle_array(seq, frames);
+	if (tester_vstreams_hist(vstreams, cnt, hist_res))
+		return 1;
+	states = platform->calloc(cnt, sizeof(*states));
+	if (!states)
+		return 1;
+	aio = platform->aio_create(engine, depth);
+	if (!aio) {
+		platform->free(states);
+		return 1;
 	}
 
-	for (i = start_frame; i < start_frame + frames; i++) {
-		uint64_t frame_start = timing_start();
-		size_t frame_idx;
-		int success = 0;
-		uint64_t frame_time_ns = 0;
-		io_mode_t io_mode = IO_MODE_UNKNOWN;
-
-		res.completion[i - start_frame].start = frame_start;
-		switch (mode) {
-		case TEST_MODE_REVERSE:
-			frame_idx = end_frame - i + start_frame - 1;
-			break;
-		case TEST_MODE_RANDOM:
-			frame_idx = seq[i - start_frame];
-			break;
-		case TEST_MODE_NORM:
-		default:
-			frame_idx = i;
-			break;
+	start = timing_start();
+	for (k = 0; k < cnt; k++) {
+		tester_vstream_state_t *st = &states[k];
+		tester_params_t params = vstreams[k].params;
+
+		st->vs = &vstreams[k];
+		memset(&st->vs->res, 0, sizeof(st->vs->res));
+		/* Recorded into the histograms of the loop instead */
+		params.hist_digits = 0;
+		if (tester_run_init(platform, &params, &st->vs->res,
+				    &st->seq)) {
+			st->done = 1;
+			continue;
 		}
+		st->vs->res.hist = hist_res->hist;
+		if (params.fps)
+			st->vs->res.hist_intended = hist_res->hist_intended;
+		tester_pacer_init(&st->pacer, &st->vs->params);
+		if (st->pacer.fps)
+			st->pacer.t0 = start + st->vs->offset_ns;
+		++active;
+	}
+
+	while (active) {
+		tester_vstream_state_t *st;
+		platform_aio_req_t *req;
+		uint64_t wake;
 
-		if (!tester_frame_read(platform, path, frame, frame_idx, files,
-				       &res.completion[i - start_frame],
-				       res.is_remote_filesystem)) {
-			res.frames_failed++;
-			record_error(&res, errno, "read", frame_idx, 0);
-			if (cb)
-				cb(cb_ctx,
-				   res.frames_written + res.frames_failed, 0, 0,
-				   IO_MODE_UNKNOWN, 0);
+		wake = tester_vstreams_start(platform, aio, op, states, cnt,
+					     depth, &inflight, &first, &active);
+		if (!inflight) {
+			if (wake != UINT64_MAX)
+				tester_sleep_until(platform, wake);
 			continue;
 		}
 
-		res.completion[i - start_frame].frame = timing_elapsed(frame_start);
-		++res.frames_written;
-		res.frames_succeeded++;
-		res.bytes_written += frame->size;
-		success = 1;
-		io_mode = res.completion[i - start_frame].io_mode;
-
-		if (io_mode == IO_MODE_DIRECT)
-			res.frames_direct_io++;
-		else if (io_mode == IO_MODE_BUFFERED) {
-			res.frames_buffered_io++;
-			res.fallback_count++;
+		if (wake == UINT64_MAX) {
+			/* Nothing is waiting for a deadline, block */
+			req = platform->aio_reap(aio, 1);
+			if (!req)
+				break;
+		} else {
+			req = platform->aio_reap(aio, 0);
+			if (!req) {
+				uint64_t busy = tester_vstreams_busy_wake(
+					states, cnt);
+
+				tester_sleep_until(platform,
+						   busy < wake ? busy : wake);
+				continue;
+			}
 		}
 
-		frame_time_ns = timing_elapsed(frame_start);
-		if (frame_time_ns > 0) {
-			if (frame_time_ns < res.min_frame_time_ns)
-				res.min_frame_time_ns = frame_time_ns;
-			if (frame_time_ns > res.max_frame_time_ns)
-				res.max_frame_time_ns = frame_time_ns;
-		}
+		st = (tester_vstream_state_t *)((char *)req -
+						offsetof(tester_vstream_state_t,
+							 req));
+		if (tester_async_complete(platform, aio, op, &st->vs->params,
+					  st->frame_idx, req, &st->comp,
+					  &st->vs->res))
+			continue;
+		st->busy = 0;
+		--inflight;
+	}
 
-		if (cb)
-			cb(cb_ctx, res.frames_written + res.frames_failed,
-			   frame->size, frame_time_ns, io_mode, success);
+	/* Streams still running lost their engine, account what was in flight */
+	for (k = 0; k < cnt; k++) {
+		tester_vstream_state_t *st = &states[k];
 
-		if (fps && budget) {
-			uint64_t frame_elapsed = timing_elapsed(frame_start);
-			while (frame_elapsed < budget) {
-				platform->usleep(100);
-				frame_elapsed = timing_elapsed(frame_start);
-			}
-		}
+		if (st->done)
+			continue;
+		if (st->busy)
+			tester_frame_failed(&st->vs->res, &st->vs->params, op,
+					    st->frame_idx, EIO);
+		tester_vstream_finish(platform, st);
+	}
+	for (k = 0; k < cnt; k++) {
+		vstreams[k].res.hist = NULL;
+		vstreams[k].res.hist_intended = NULL;
 	}
 
-	if (res.frames_succeeded + res.frames_failed > 0) {
-		res.success_rate_percent =
-			(res.frames_succeeded * 100.0) /
-			(res.frames_succeeded + res.frames_failed);
+	platform->aio_destroy(aio);
+	platform->free(states);
+
+	return 0;
+}
+
+void tester_vstream_stats(const tester_vstream_t *vs, stream_stats_t *stats)
+{
+	const test_result_t *res = &vs->res;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->frames = res->frames_written;
+	stats->failed = res->frames_failed;
+	stats->bytes = res->bytes_written;
+	stats->time_ns = res->time_taken_ns;
+	stats->dropped = res->playback_stats.dropped;
+	/* Of the steady state, the histograms are shared by the streams */
+	stats->avg_frame_ns = res->avg_frame_time_ns;
+	stats->max_frame_ns = res->max_frame_time_ns;
+}
+
+int tester_run_load(const platform_t *platform, complog_reader_t *rd,
+		    const tester_params_t *params, test_result_t *res)
+{
+	tester_params_t p = *params;
+	test_completion_t comp;
+	uint64_t end = 0;
+	size_t *seq;
+	int ret;
+
+	memset(res, 0, sizeof(*res));
+	p.fps = rd->hdr.fps;
+	p.begin = rd->hdr.begin;
+	p.mode = TEST_MODE_NORM;
+	p.dispatch = NULL;
+	p.playback = 0;
+	if (tester_run_init(platform, &p, res, &seq))
+		return 1;
+
+	while ((ret = complog_reader_next(rd, &comp)) > 0) {
+		uint64_t done = comp.start + test_completion_frame(&comp);
+
+		tester_frame_record(res, &p, &comp);
+		res->bytes_written += rd->hdr.frame_size;
+		if (done > end)
+			end = done;
 	}
-	if (res.frames_direct_io + res.frames_buffered_io > 0) {
-		res.direct_io_success_rate =
-			(res.frames_direct_io * 100.0) /
-			(res.frames_direct_io + res.frames_buffered_io);
+	if (res->frames_written)
+		res->time_taken_ns = end - res->first_start;
+
+	tester_run_finish(platform, &p, res, seq);
+	return ret < 0;
+}
+
+test_result_t tester_run(const platform_t *platform, test_op_t op,
+			 const tester_params_t *params)
+{
+	test_result_t res = { 0 };
+	platform_aio_t *aio = NULL;
+	tester_handle_t *handles = NULL;
+	tester_handle_t stream = { 0 };
+	int striped = 0;
+	size_t *seq = NULL;
+
+	if (tester_run_init(platform, params, &res, &seq))
+		return res;
+
+	/* The handle cache and the shared stream only back the sync path */
+	if (params->files == TEST_FILES_SINGLE && params->stream > 0) {
+		stream.f = params->stream;
+		stream.io_mode = params->stream_io_mode;
+		handles = &stream;
+	} else if (params->preopen) {
+		handles = tester_handles_open(platform, op, params, &res);
 	}
-	if (res.frames_succeeded > 0 && res.min_frame_time_ns != UINT64_MAX) {
-		uint64_t total_frame_time = 0;
-		for (size_t j = 0; j < frames; j++) {
-			if (res.completion[j].frame > 0)
-				total_frame_time += res.completion[j].frame;
-		}
-		res.avg_frame_time_ns =
-			(res.frames_succeeded > 0) ?
-				(total_frame_time / res.frames_succeeded) :
-				0;
+
+	/* Engines that can't be set up fall back to synchronous I/O */
+	if (!handles && params->stripes > 1 && platform->aio_create) {
+		/* Stripes need requests in flight, helper threads by default */
+		platform_engine_t engine = params->engine;
+
+		if (engine == PLATFORM_ENGINE_SYNC)
+			engine = PLATFORM_ENGINE_THREADS;
+		aio = platform->aio_create(engine, params->stripes);
+		striped = aio != NULL;
+	} else if (!handles && params->engine != PLATFORM_ENGINE_SYNC &&
+		   platform->aio_create) {
+		aio = platform->aio_create(params->engine, params->queue_depth);
 	}
 
-	if (seq)
-		platform->free(seq);
+	if (aio) {
+		if (striped)
+			tester_run_striped(platform, aio, op, params, seq,
+					   &res);
+		else
+			tester_run_async(platform, aio, op, params, seq, &res);
+		platform->aio_destroy(aio);
+	} else {
+		tester_run_sync(platform, op, params, seq, handles, &res);
+	}
+
+	if (handles && handles != &stream)
+		tester_handles_close(platform, params, handles, &res);
+
+	tester_run_finish(platform, params, &res, seq);
 	return res;
 }
+
+static inline tester_params_t
+tester_params(const char *path, frame_t *frame, size_t start_frame,
+	      size_t frames, size_t fps, test_mode_t mode, test_files_t files,
+	      tester_progress_cb cb, void *cb_ctx)
+{
+	tester_params_t params = { 0 };
+
+	params.path = path;
+	params.frame = frame;
+	params.start_frame = start_frame;
+	params.frames = frames;
+	params.fps = fps;
+	params.mode = mode;
+	params.files = files;
+	params.engine = PLATFORM_ENGINE_SYNC;
+	params.queue_depth = 1;
+	params.cb = cb;
+	params.cb_ctx = cb_ctx;
+
+	return params;
+}
+
+test_result_t tester_run_write(const platform_t *platform, const char *path,
+			       frame_t *frame, size_t start_frame,
+			       size_t frames, size_t fps, test_mode_t mode,
+			       test_files_t files)
+{
+	tester_params_t params = tester_params(path, frame, start_frame, frames,
+					       fps, mode, files, NULL, NULL);
+
+	return tester_run(platform, TEST_OP_WRITE, &params);
+}
+
+test_result_t tester_run_read(const platform_t *platform, const char *path,
+			      frame_t *frame, size_t start_frame, size_t frames,
+			      size_t fps, test_mode_t mode, test_files_t files)
+{
+	tester_params_t params = tester_params(path, frame, start_frame, frames,
+					       fps, mode, files, NULL, NULL);
+
+	return tester_run(platform, TEST_OP_READ, &params);
+}
+
+/* Callback-enabled versions for TUI progress updates */
+
+test_result_t tester_run_write_cb(const platform_t *platform, const char *path,
+				  frame_t *frame, size_t start_frame,
+				  size_t frames, size_t fps, test_mode_t mode,
+				  test_files_t files, tester_progress_cb cb,
+				  void *cb_ctx)
+{
+	tester_params_t params = tester_params(path, frame, start_frame, frames,
+					       fps, mode, files, cb, cb_ctx);
+
+	return tester_run(platform, TEST_OP_WRITE, &params);
+}
+
+test_result_t tester_run_read_cb(const platform_t *platform, const char *path,
+				 frame_t *frame, size_t start_frame,
+				 size_t frames, size_t fps, test_mode_t mode,
+				 test_files_t files, tester_progress_cb cb,
+				 void *cb_ctx)
+{
+	tester_params_t params = tester_params(path, frame, start_frame, frames,
+					       fps, mode, files, cb, cb_ctx);
+
+	return tester_run(platform, TEST_OP_READ, &params);
+}
@@ -25,8 +25,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include "complog.h"
 #include "frametest.h"
 #include "frame.h"
+#include "histogram.h"
 #include "platform.h"
 #include "timing.h"
 
@@ -52,11 +54,157 @@ typedef enum test_files_t {
 	TEST_FILES_SINGLE = 1,
 } test_files_t;
 
+typedef enum test_op_t {
+	TEST_OP_WRITE = 0,
+	TEST_OP_READ = 1,
+} test_op_t;
+
+/*
+ * Shared frame cursor of dynamically scheduled workers: every worker
+ * takes the next frame when it's ready for one, so a stalled thread
+ * doesn't hold back a block of frames.
+ */
+typedef struct tester_dispatch_t {
+	size_t next; /* Updated atomically */
+	size_t start_frame;
+	size_t frames;
+	test_mode_t mode;
+	size_t *seq; /* Order of TEST_MODE_RANDOM */
+} tester_dispatch_t;
+
+int tester_dispatch_init(const platform_t *platform,
+			 tester_dispatch_t *dispatch, size_t start_frame,
+			 size_t frames, test_mode_t mode);
+void tester_dispatch_free(const platform_t *platform,
+			  tester_dispatch_t *dispatch);
+/* Frame number of the pos-th frame handed out */
+size_t tester_dispatch_index(const tester_dispatch_t *dispatch, size_t pos);
+
 /* Progress callback for TUI updates */
 typedef void (*tester_progress_cb)(void *ctx, size_t frames_done,
 				   size_t bytes_written, uint64_t frame_time_ns,
 				   io_mode_t io_mode, int success);
 
+/* Parameters of one tester run, usually one per worker thread */
+typedef struct tester_params_t {
+	const char *path;
+	frame_t *frame;
+	size_t start_frame;
+	size_t frames;
+	size_t fps;
+	/* With fps: busy-wait this many ns before each frame's deadline */
+	uint64_t pace_spin;
+	/* With fps: judge frames against display deadlines after prebuffer */
+	int playback;
+	/*
+	 * Absolute end of a time-bounded run, 0 to stop after frames. Until
+	 * then the frame range wraps around.
+	 */
+	uint64_t end;
+	uint64_t begin; /* Start of the run, for a warm-up in time */
+	/*
+	 * Steady state: completions of the first and last frames are kept
+	 * but flagged and left out of the statistics. Counts of frames, or
+	 * ns from begin and before the last frame.
+	 */
+	size_t warmup_frames;
+	size_t cooldown_frames;
+	uint64_t warmup;
+	uint64_t cooldown;
+	/* Record completion histograms to this many digits, 0 for none */
+	unsigned int hist_digits;
+	size_t prebuffer;
+	test_mode_t mode;
+	test_files_t files;
+
+	/*
+	 * Shared cursor, NULL for the static start_frame/frames range.
+	 * frames is then the upper bound of frames this worker may take.
+	 */
+	tester_dispatch_t *dispatch;
+	/* Records kept of the last frames, 0 for frames; the ring wraps */
+	size_t records;
+
+	/* I/O engine, asynchronous engines keep queue_depth frames in flight */
+	platform_engine_t engine;
+	size_t queue_depth;
+
+	/*
+	 * Buffers of the frames in flight, slot n transfers to
+	 * bufs[n % buf_cnt]; each holds a copy of frame. NULL to use
+	 * frame->data for all.
+	 */
+	void **bufs;
+	size_t buf_cnt;
+	/*
+	 * Make every frame written unique with frame_stamp() of seed on its
+	 * buffer first, for frame_fill_random() content. Needs buffers no
+	 * other slot or worker writes from.
+	 */
+	int stamp;
+	uint64_t seed;
+
+	/* Bytes per I/O request, frames are split in chunks; 0 for whole */
+	size_t request_size;
+
+	/* Stripe each frame in byte ranges transferred in parallel, 0/1 off */
+	size_t stripes;
+
+	/* Open all frame files before the measured loop, sync engine only */
+	int preopen;
+
+	/*
+	 * Single-file mode: descriptor of the stream file shared by all
+	 * workers, accessed with positional I/O. 0 to open it per frame.
+	 */
+	platform_handle_t stream;
+	io_mode_t stream_io_mode;
+
+	/* Optional progress callback */
+	tester_progress_cb cb;
+	void *cb_ctx;
+
+	/* Append every completion to this log as well, NULL for none */
+	complog_t *log;
+} tester_params_t;
+
+test_result_t tester_run(const platform_t *platform, test_op_t op,
+			 const tester_params_t *params);
+/*
+ * Rebuild the result of a logged run from its completion log: records
+ * (the last params->frames), histograms and steady state as tester_run()
+ * left them, from fps, warm-up, cool-down and hist_digits of params.
+ * Frame failures and playback deadlines aren't logged. Returns non-zero
+ * on read errors, res then holds the records read up to there.
+ */
+int tester_run_load(const platform_t *platform, complog_reader_t *rd,
+		    const tester_params_t *params, test_result_t *res);
+
+/*
+ * Virtual stream (--streams): a small state machine with its own frame
+ * range, order and fps, one frame in flight at a time. Many of them are
+ * multiplexed onto one thread by tester_run_vstreams().
+ */
+typedef struct tester_vstream_t {
+	tester_params_t params;
+	/* Paced streams: delay of the first frame, to spread their phases */
+	uint64_t offset_ns;
+	test_result_t res;
+} tester_vstream_t;
+
+/*
+ * Drive cnt virtual streams from the calling thread on an asynchronous
+ * engine with at most depth frames in flight, 0 for one per stream.
+ * Every stream gets its counters and records in its res, the latencies
+ * of all of them go to one set of histograms in hist_res. Returns
+ * non-zero if the engine or the histograms could not be set up.
+ */
+int tester_run_vstreams(const platform_t *platform, test_op_t op,
+			tester_vstream_t *vstreams, size_t cnt,
+			platform_engine_t engine, size_t depth,
+			test_result_t *hist_res);
+void tester_vstream_stats(const tester_vstream_t *vs, stream_stats_t *stats);
+
 test_result_t tester_run_write(const platform_t *platform, const char *path,
 			       frame_t *frame, size_t start_frame,
 			       size_t frames, size_t fps, test_mode_t mode,
@@ -76,8 +224,14 @@ test_result_t tester_run_read_cb(const platform_t *platform, const char *path,
 				 size_t frames, size_t fps, test_mode_t mode,
 				 test_files_t files, tester_progress_cb cb,
 				 void *cb_ctx);
+/* Open the stream file of single-file mode once for all workers */
+platform_handle_t tester_stream_open(const platform_t *platform,
+				     const char *path, test_op_t op,
+				     io_mode_t *io_mode);
 frame_t *tester_get_frame_read(const platform_t *platform, const char *path,
 			       size_t header_size);
+int tester_frames_present(const platform_t *platform, const char *path,
+			  size_t start, size_t frames, size_t size);
 
 static inline void result_free(const platform_t *platform, test_result_t *res)
 {
@@ -86,6 +240,13 @@ static inline void result_free(const platform_t *platform, test_result_t *res)
 	if (res->completion)
 		platform->free(res->completion);
 	res->completion = NULL;
+	res->completion_cnt = 0;
+	res->completion_cap = 0;
+	res->completion_excluded = 0;
+	hist_destroy(res->hist);
+	hist_destroy(res->hist_intended);
+	res->hist = NULL;
+	res->hist_intended = NULL;
 
 	/* Phase 1: Free error array */
 	if (res->errors) {
@@ -94,31 +255,259 @@ static inline void result_free(const platform_t *platform, test_result_t *res)
 	}
 	res->error_count = 0;
 	res->max_errors = 0;
+
+	if (res->thread_frames) {
+		free(res->thread_frames);
+		res->thread_frames = NULL;
+	}
+	res->thread_count = 0;
+	if (res->stream_stats) {
+		free(res->stream_stats);
+		res->stream_stats = NULL;
+	}
+	res->stream_count = 0;
+	if (res->node_stats) {
+		free(res->node_stats);
+		res->node_stats = NULL;
+	}
+	res->node_count = 0;
+}
+
+#define COMPLETION_SHIFT_BITS 5
+
+/* Pack a duration into bits bits, see test_completion_t */
+static inline uint32_t test_completion_pack_ns(uint64_t ns, unsigned int bits)
+{
+	unsigned int mant = bits - COMPLETION_SHIFT_BITS;
+	unsigned int shift = 0;
+
+	while ((ns >> shift) >> mant) {
+		if (++shift == 1u << COMPLETION_SHIFT_BITS)
+			return (uint32_t)((1ull << bits) - 1);
+	}
+
+	return (uint32_t)(shift << mant) | (uint32_t)(ns >> shift);
+}
+
+static inline uint64_t test_completion_unpack_ns(uint32_t val,
+						 unsigned int bits)
+{
+	unsigned int mant = bits - COMPLETION_SHIFT_BITS;
+	uint32_t mask = (1u << mant) - 1;
+
+	val &= (uint32_t)((1ull << bits) - 1);
+	return (uint64_t)(val & mask) << (val >> mant);
+}
+
+/* Time between two timestamps, 0 if they are out of order */
+static inline uint64_t test_completion_span(uint64_t from, uint64_t to)
+{
+	return to > from ? to - from : 0;
+}
+
+#define COMPLETION_LATE_BITS (32 - COMPLETION_FLAG_BITS)
+
+/* Record a completed frame, close is taken as its completion */
+static inline void test_completion_pack(test_completion_t *comp,
+					const test_frame_timing_t *t)
+{
+	uint32_t flags = (uint32_t)t->io_mode & COMPLETION_IO_MODE_MASK;
+	uint64_t late = 0;
+	uint64_t open = t->open > t->start ? t->open : t->start;
+	uint64_t io = t->io > open ? t->io : open;
+
+	if (t->intended) {
+		flags |= COMPLETION_PACED;
+		late = test_completion_span(t->intended, t->start);
+	}
+	comp->start = t->start;
+	comp->open = test_completion_pack_ns(open - t->start, 32);
+	comp->io = test_completion_pack_ns(io - open, 32);
+	comp->close = test_completion_pack_ns(test_completion_span(io, t->close),
+					      32);
+	comp->late = test_completion_pack_ns(late, COMPLETION_LATE_BITS) |
+		     flags << COMPLETION_LATE_BITS;
+}
+
+static inline uint32_t test_completion_flags(const test_completion_t *comp)
+{
+	return comp->late >> COMPLETION_LATE_BITS;
+}
+
+static inline io_mode_t test_completion_io_mode(const test_completion_t *comp)
+{
+	return (io_mode_t)(test_completion_flags(comp) &
+			   COMPLETION_IO_MODE_MASK);
+}
+
+static inline int test_completion_excluded(const test_completion_t *comp)
+{
+	return !!(test_completion_flags(comp) & COMPLETION_EXCLUDED);
+}
+
+static inline void test_completion_exclude(test_completion_t *comp,
+					   int excluded)
+{
+	comp->late &= ~((uint32_t)COMPLETION_EXCLUDED << COMPLETION_LATE_BITS);
+	if (excluded)
+		comp->late |= (uint32_t)COMPLETION_EXCLUDED
+			      << COMPLETION_LATE_BITS;
+}
+
+/* Phase times, from the start of the frame, the open and the I/O */
+static inline uint64_t test_completion_open(const test_completion_t *comp)
+{
+	return test_completion_unpack_ns(comp->open, 32);
+}
+
+static inline uint64_t test_completion_io(const test_completion_t *comp)
+{
+	return test_completion_unpack_ns(comp->io, 32);
+}
+
+static inline uint64_t test_completion_close(const test_completion_t *comp)
+{
+	return test_completion_unpack_ns(comp->close, 32);
+}
+
+/* Frame time, from the start to the close */
+static inline uint64_t test_completion_frame(const test_completion_t *comp)
+{
+	return test_completion_open(comp) + test_completion_io(comp) +
+	       test_completion_close(comp);
+}
+
+static inline uint64_t test_completion_late(const test_completion_t *comp)
+{
+	return test_completion_unpack_ns(comp->late, COMPLETION_LATE_BITS);
+}
+
+/* Scheduled start with fps pacing, 0 otherwise */
+static inline uint64_t test_completion_intended(const test_completion_t *comp)
+{
+	if (!(test_completion_flags(comp) & COMPLETION_PACED))
+		return 0;
+	return comp->start - test_completion_late(comp);
+}
+
+/*
+ * Time from the intended start of a paced frame to its completion: the
+ * queueing delay behind late frames plus the service time.
+ */
+static inline uint64_t test_completion_intended_time(
+	const test_completion_t *comp)
+{
+	return test_completion_late(comp) + test_completion_frame(comp);
+}
+
+/* Frames in the statistics: the histogram's, or the unflagged records */
+static inline size_t test_result_steady_frames(const test_result_t *res)
+{
+	if (res->hist)
+		return res->hist->total;
+	if (res->completion_cnt < res->completion_excluded)
+		return 0;
+	return res->completion_cnt - res->completion_excluded;
+}
+
+/*
+ * Free the per-frame records of a finished run. Counters, histograms and
+ * the number of excluded frames stay, and so does everything reported
+ * but --frametimes and the --times breakdown.
+ */
+static inline void test_result_drop_records(const platform_t *platform,
+					    test_result_t *res)
+{
+	if (res->completion)
+		platform->free(res->completion);
+	res->completion = NULL;
+	res->completion_cnt = 0;
+	res->completion_cap = 0;
+}
+
+/* Playback qualification verdict, every frame displayed in time */
+static inline int test_result_playback_ok(const test_result_t *res)
+{
+	return res->playback_stats.frames && !res->playback_stats.dropped;
 }
 
 static inline int test_result_aggregate(test_result_t *dst,
 					const test_result_t *src)
 {
 	test_completion_t *tmp;
-	size_t frm;
+	size_t cnt;
+	size_t dn;
+	size_t sn;
+	int ret = 0;
 
 	if (!dst || !src)
 		return 1;
 
-	frm = (dst->frames_written + src->frames_written);
-	if (frm && src->frames_written && src->completion) {
+	/* Phase 3: Frame time metrics, weighted by the steady-state frames */
+	dn = test_result_steady_frames(dst);
+	sn = test_result_steady_frames(src);
+	if (sn && src->min_frame_time_ns != UINT64_MAX) {
+		if (!dn || src->min_frame_time_ns < dst->min_frame_time_ns)
+			dst->min_frame_time_ns = src->min_frame_time_ns;
+		if (src->max_frame_time_ns > dst->max_frame_time_ns)
+			dst->max_frame_time_ns = src->max_frame_time_ns;
+		dst->avg_frame_time_ns = (dst->avg_frame_time_ns * dn +
+					  src->avg_frame_time_ns * sn) /
+					 (dn + sn);
+		dst->performance_trend = (dst->performance_trend * dn +
+					  src->performance_trend * sn) /
+					 (dn + sn);
+	}
+
+	if ((src->hist && hist_merge(&dst->hist, src->hist)) ||
+	    (src->hist_intended &&
+	     hist_merge(&dst->hist_intended, src->hist_intended)))
+		ret = 1;
+	if (src->first_start &&
+	    (!dst->first_start || src->first_start < dst->first_start))
+		dst->first_start = src->first_start;
+
+	/* Records are only around when asked for, histograms cover the rest */
+	dst->completion_excluded += src->completion_excluded;
+	cnt = dst->completion_cnt + src->completion_cnt;
+	if (src->completion_cnt && src->completion) {
 		tmp = (test_completion_t *)realloc(dst->completion,
-						   sizeof(*tmp) * frm);
+						   sizeof(*tmp) * cnt);
 		if (tmp) {
-			memcpy(tmp + dst->frames_written, src->completion,
-			       sizeof(*tmp) * src->frames_written);
+			memcpy(tmp + dst->completion_cnt, src->completion,
+			       sizeof(*tmp) * src->completion_cnt);
 			dst->completion = tmp;
+			dst->completion_cnt = cnt;
+			dst->completion_cap = cnt;
 		}
 	}
 
 	dst->frames_written += src->frames_written;
 	dst->bytes_written += src->bytes_written;
 	dst->time_taken_ns += src->time_taken_ns;
+	/* Threads open their handles concurrently, count the slowest one */
+	if (src->handle_time_ns > dst->handle_time_ns)
+		dst->handle_time_ns = src->handle_time_ns;
+
+	/* Every worker plays its own stream, the worst one decides */
+	if (src->playback) {
+		playback_stats_t *d = &dst->playback_stats;
+		const playback_stats_t *s = &src->playback_stats;
+
+		if (!dst->playback || s->min_slack_ns < d->min_slack_ns)
+			d->min_slack_ns = s->min_slack_ns;
+		dst->playback = 1;
+		dst->prebuffer = src->prebuffer;
+		d->frames += s->frames;
+		d->late += s->late;
+		d->dropped += s->dropped;
+		if (s->max_miss_run > d->max_miss_run)
+			d->max_miss_run = s->max_miss_run;
+		if (s->startup_ns > d->startup_ns)
+			d->startup_ns = s->startup_ns;
+		if (s->startup_frames > d->startup_frames)
+			d->startup_frames = s->startup_frames;
+	}
 
 	/* Phase 1: Aggregate error tracking and success metrics */
 	dst->frames_failed += src->frames_failed;
@@ -143,7 +532,7 @@ static inline int test_result_aggregate(test_result_t *dst,
 			(dst->frames_direct_io * 100.0) / total_frames;
 	}
 
-	return 0;
+	return ret;
 }
 
 #endif
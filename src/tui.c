@@ -31,6 +31,7 @@
 #include <sys/ioctl.h>
 #endif
 
+#include "histogram.h"
 #include "tui.h"
 #include "tui_format.h"
 
@@ -567,25 +568,15 @@ void tui_render_summary(const tui_metrics_t *metrics,
 		iops_val = (double)result->frames_written / elapsed_sec;
 	}
 
-	/* Calculate latency from completion data (most reliable source) */
+	/* Latency from the histogram recorded during the run */
 	uint64_t min_ns = UINT64_MAX;
 	uint64_t max_ns = 0;
 	uint64_t avg_ns = 0;
 
-	if (result->completion && result->frames_written > 0) {
-		uint64_t total = 0;
-		for (size_t i = 0; i < result->frames_written; i++) {
-			uint64_t frame_dur = result->completion[i].frame -
-					     result->completion[i].start;
-			if (frame_dur > 0) {
-				total += frame_dur;
-				if (frame_dur < min_ns)
-					min_ns = frame_dur;
-				if (frame_dur > max_ns)
-					max_ns = frame_dur;
-			}
-		}
-		avg_ns = total / result->frames_written;
+	if (result->hist && result->hist->total) {
+		min_ns = result->hist->min;
+		max_ns = result->hist->max;
+		avg_ns = hist_mean(result->hist);
 	}
 
 	/* Fallback to metrics if completion data not available */
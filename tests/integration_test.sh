@@ -86,6 +86,14 @@ else
     log_fail "Help output"
 fi
 
+# Every option comes with its own description
+log_info "Help descriptions"
+if $VFRAMETEST --help 2>&1 | grep -qE '^ +(-[a-zA-Z], )?--[a-z-]+ *$'; then
+    log_fail "Help descriptions"
+else
+    log_pass "Help descriptions"
+fi
+
 run_test "List profiles" \
     "$VFRAMETEST --list-profiles"
 
@@ -174,6 +182,9 @@ rm -rf "$TEST_DIR"/*
 run_test "Frametimes output" \
     "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES --frametimes $TEST_DIR"
 
+run_test "Frame times of every frame with dynamic scheduling" \
+    "test \$($VFRAMETEST -w SD-32bit-cmp -n 200 -t 4 --frametimes $TEST_DIR | grep -cE '^[0-9]+,') -eq 200"
+
 # -------------------------------------------
 # Threading tests
 # -------------------------------------------
@@ -202,6 +213,130 @@ rm -rf "$TEST_DIR"/*
 run_test "FPS limited write (60fps)" \
     "$VFRAMETEST -w SD-32bit-cmp -n 10 --fps 60 $TEST_DIR"
 
+run_test "FPS limited write with pace spin" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 10 --fps 60 --pace-spin 200 $TEST_DIR"
+
+run_test "FPS limited write reports intended-start latency" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 10 --fps 60 --json $TEST_DIR | grep -q completion_intended"
+
+run_test "Playback qualification passes at 60fps" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 10 --fps 60 --playback --prebuffer 2 $TEST_DIR | grep -q 'Playback.*PASS'"
+
+run_test "Playback qualification exits 2 on drops" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 10 --fps 1000000 --playback $TEST_DIR; test \$? -eq 2"
+
+run_test "Playback requires --fps" \
+    "! $VFRAMETEST -w SD-32bit-cmp -n 10 --playback $TEST_DIR"
+
+run_test "FPS limited uring write" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 10 --fps 60 --io-engine uring $TEST_DIR"
+
+# -------------------------------------------
+# I/O engines
+# -------------------------------------------
+echo ""
+echo "--- I/O Engine Tests ---"
+
+rm -rf "$TEST_DIR"/*
+if "$VFRAMETEST" -w SD-32bit-cmp -n 1 --io-engine uring "$TEST_DIR" > /dev/null 2>&1; then
+    rm -rf "$TEST_DIR"/*
+    run_test "io_uring write (qd 16)" \
+        "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES --io-engine uring --queue-depth 16 $TEST_DIR"
+
+    run_test "io_uring read (qd 16)" \
+        "$VFRAMETEST -r -n $FRAMES --io-engine uring --queue-depth 16 $TEST_DIR"
+
+    run_test "io_uring chunked read (64k requests)" \
+        "$VFRAMETEST -r -n $FRAMES --io-engine uring --request-size 64k $TEST_DIR"
+
+    run_test "io_uring streaming write" \
+        "touch $TEST_DIR/stream.raw && $VFRAMETEST -w SD-32bit-cmp -n $FRAMES --io-engine uring -s $TEST_DIR/stream.raw"
+else
+    echo "io_uring not available, skipping"
+fi
+
+rm -rf "$TEST_DIR"/*
+run_test "Helper thread write (qd 8, 2 threads)" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -t 2 --io-engine threads --queue-depth 8 $TEST_DIR"
+
+run_test "Helper thread read (qd 8, random)" \
+    "$VFRAMETEST -r -n $FRAMES --random --io-engine threads --queue-depth 8 $TEST_DIR"
+
+rm -rf "$TEST_DIR"/*
+run_test "Chunked write (64k requests)" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES --request-size 64k $TEST_DIR"
+
+run_test "Chunked read (helper threads, 64k requests)" \
+    "$VFRAMETEST -r -n $FRAMES --io-engine threads --request-size 64k $TEST_DIR"
+
+run_test "Unaligned request size rejected" \
+    "! $VFRAMETEST -w SD-32bit-cmp -n 1 --request-size 1000 $TEST_DIR"
+
+rm -rf "$TEST_DIR"/*
+run_test "Static schedule write (4 threads)" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -t 4 --schedule static $TEST_DIR"
+
+run_test "Dynamic schedule random read (4 threads)" \
+    "$VFRAMETEST -r -n $FRAMES -t 4 --random --json $TEST_DIR | grep -q thread_frames"
+
+rm -rf "$TEST_DIR"/*
+run_test "Virtual streams write (20 streams, 2 threads)" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES --streams 20 -t 2 $TEST_DIR"
+
+run_test "Virtual streams frame time metrics" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 40 --streams 4 -t 2 -f 200 -c $TEST_DIR | tail -n 1 | cut -d, -f22-24 | grep -qE '^[1-9][0-9]*,[1-9][0-9]*,[1-9][0-9]*$'"
+
+run_test "Virtual streams reject fewer fps than streams" \
+    "! $VFRAMETEST -w SD-32bit-cmp -n 16 --streams 8 -f 4 $TEST_DIR 2>/dev/null"
+
+run_test "Virtual streams random read" \
+    "$VFRAMETEST -r -n $FRAMES --streams 20 -t 2 --random $TEST_DIR"
+
+run_test "Virtual streams on helper threads, paced playback" \
+    "$VFRAMETEST -r -n $FRAMES --streams 10 --io-engine threads -f 500 --playback --prebuffer 2 --json $TEST_DIR | grep -q '\"streams\"'"
+
+rm -rf "$TEST_DIR"/*
+run_test "Mixed write and random read" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -t 2 --mixed --read-threads 3 --read-order random $TEST_DIR | grep -q 'Results mixed'"
+
+run_test "Mixed paced playback under ingest (CSV)" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES --mixed -f 200 --read-fps 400 --playback --prebuffer 2 --csv $TEST_DIR | grep -c '^\"\(write\|read\|mixed\)\"' | grep -q 3"
+
+run_test "Saturation search over fps" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 10 --search fps -f 100 --search-max 400 $TEST_DIR | grep -q 'Highest sustainable fps'"
+
+run_test "Saturation search over streams (JSON curve)" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 5 -t 2 --search streams -f 50 --search-max 8 --search-p99 1000 --json $TEST_DIR | grep -q '\"curve\"'"
+
+run_test "Thread sweep (CSV table)" \
+    "$VFRAMETEST -r -n $FRAMES --sweep-threads 1,2,4 --csv $TEST_DIR | grep -c '^\"' | grep -q 3"
+
+run_test "Thread and queue depth sweep (JSON)" \
+    "$VFRAMETEST -r -n $FRAMES --io-engine threads --sweep-threads 1,2 --sweep-queue-depth 1,4 --json $TEST_DIR | grep -q '\"efficiency\"'"
+
+run_test "Time-bounded write wraps around the frames" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 3 -f 20 --duration 0.5 $TEST_DIR | grep -q 'frames: 1[0-9]'"
+
+run_test "Warm-up and cool-down frames flagged in frame times" \
+    "$VFRAMETEST -w SD-32bit-cmp -n 10 --warmup 2 --cooldown 1s --frametimes --csv $TEST_DIR | grep -q ',1$'"
+
+run_test "Time-bounded read (async engine)" \
+    "$VFRAMETEST -r -n 3 --io-engine threads --queue-depth 2 --duration 0.2s $TEST_DIR"
+
+rm -rf "$TEST_DIR"/*
+run_test "Striped write (4 stripes)" \
+    "$VFRAMETEST -w FULLHD-24bit -n $FRAMES --stripes 4 $TEST_DIR"
+
+run_test "Striped read (4 stripes, 2 threads)" \
+    "$VFRAMETEST -r -n $FRAMES -t 2 --stripes 4 $TEST_DIR"
+
+rm -rf "$TEST_DIR"/*
+run_test "Pre-opened handles write" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES --preopen $TEST_DIR"
+
+run_test "Pre-opened handles read (JSON)" \
+    "$VFRAMETEST -r -n $FRAMES --preopen --json $TEST_DIR | grep -q open_exclusive_mibps"
+
 # -------------------------------------------
 # Empty frames test
 # -------------------------------------------
@@ -226,6 +361,31 @@ rm -rf "$TEST_DIR"/*
 run_test "Large profile (4K)" \
     "$VFRAMETEST -w 4K-24bit -n 20 --histogram $TEST_DIR"
 
+run_test "Histogram export (hgrm)" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -f 100 --hist-digits 2 --hist-export $TEST_DIR/lat $TEST_DIR >/dev/null && grep -q 'Total count' $TEST_DIR/lat-write-intended.hgrm"
+
+run_test "Completion log and analysis" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -t 2 --log $TEST_DIR/run $TEST_DIR >/dev/null && $VFRAMETEST --analyze-log $TEST_DIR/run --csv | grep -q '^\"write\",\"SD-32bit-cmp\",2,$FRAMES,'"
+
+rm -rf "$TEST_DIR"/*
+run_test "Huge page frame buffers" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -t 2 --huge-pages 2m $TEST_DIR | grep -q '^Frame buffers: 2 on '"
+
+rm -rf "$TEST_DIR"/*
+run_test "NUMA placement" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -t 2 --numa rr $TEST_DIR 2>&1 | grep -qE '^NUMA node [0-9]+: |No NUMA topology'"
+
+rm -rf "$TEST_DIR"/*
+run_test "Worker CPU and I/O scheduling" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -t 2 --cpus 0 --nice 1 --ioprio be:7 $TEST_DIR"
+
+run_test "Reject overlapping TUI CPUs" \
+    "! $VFRAMETEST -w SD-32bit-cmp -n $FRAMES --tui --cpus 0 --tui-cpus 0 $TEST_DIR"
+
+rm -rf "$TEST_DIR"/*
+run_test "Random frame content" \
+    "$VFRAMETEST -w SD-32bit-cmp -n $FRAMES -t 2 --fill random:50 --seed 7 $TEST_DIR && ! cmp -s $TEST_DIR/frame000000.tst $TEST_DIR/frame000001.tst"
+
 rm -rf "$TEST_DIR"/*
 run_test "Combined options" \
     "$VFRAMETEST -w HD-24bit -n $FRAMES -t 2 --histogram --times --csv $TEST_DIR"
@@ -0,0 +1,172 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/* mkstemp() */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <unistd.h>
+#include "unittest.h"
+#include "complog.h"
+#include "complog.c"
+
+/* Records that tell apart where they landed */
+static void complog_rec(test_completion_t *comp, size_t i)
+{
+	memset(comp, 0, sizeof(*comp));
+	comp->start = 1000 + i;
+	comp->io = (uint32_t)i;
+}
+
+static size_t complog_check(const platform_t *platform, const char *path,
+			    size_t expect)
+{
+	complog_reader_t rd;
+	test_completion_t comp;
+	size_t i = 0;
+	int ret;
+
+	if (complog_reader_open(platform, &rd, path))
+		return (size_t)-1;
+	while ((ret = complog_reader_next(&rd, &comp)) > 0) {
+		if (comp.start != 1000 + i || comp.io != i)
+			break;
+		++i;
+	}
+	if (ret || rd.records != expect || rd.hdr.fps != 24 ||
+	    rd.hdr.frame_size != 4096)
+		i = (size_t)-1;
+	complog_reader_close(&rd);
+
+	return i;
+}
+
+static int complog_write_read(const platform_t *platform, const char *path)
+{
+	complog_header_t hdr = { { 0 } };
+	complog_writer_t *w;
+	complog_t *log;
+	test_completion_t comp;
+	size_t frames = COMPLOG_BUF_RECORDS * (COMPLOG_BUFS + 2) + 5;
+	size_t i;
+
+	hdr.frame_size = 4096;
+	hdr.fps = 24;
+	w = complog_writer_create(platform);
+	TEST_ASSERT(w);
+	log = complog_open(w, path, &hdr);
+	TEST_ASSERT(log);
+	for (i = 0; i < frames; i++) {
+		complog_rec(&comp, i);
+		TEST_ASSERT_EQ(complog_append(log, &comp), 0);
+	}
+	TEST_ASSERT_EQ(complog_close(log), 0);
+	complog_writer_destroy(w);
+
+	TEST_ASSERT_EQ(complog_check(platform, path, frames), frames);
+
+	return 0;
+}
+
+int test_complog_inline(void)
+{
+	const platform_t *platform = test_platform_get();
+
+	/* No threads on the test platform, workers write themselves */
+	TEST_ASSERT_EQ(complog_write_read(platform, "inline.vfl"), 0);
+	test_platform_finalize();
+
+	return 0;
+}
+
+int test_complog_threaded(void)
+{
+	const platform_t *platform = platform_get();
+	char path[] = "/tmp/test_complog_XXXXXX";
+	int fd = mkstemp(path);
+
+	TEST_ASSERT(fd >= 0);
+	close(fd);
+	TEST_ASSERT_EQ(complog_write_read(platform, path), 0);
+	unlink(path);
+
+	return 0;
+}
+
+int test_complog_partial(void)
+{
+	const platform_t *platform = test_platform_get();
+	complog_header_t hdr = { { 0 } };
+	complog_reader_t rd;
+	test_completion_t comp;
+	platform_handle_t f;
+	size_t i;
+
+	/* A crash leaves the header, whole records and half a record */
+	hdr.frame_size = 4096;
+	hdr.fps = 24;
+	memcpy(hdr.magic, COMPLOG_MAGIC, sizeof(COMPLOG_MAGIC));
+	hdr.version = COMPLOG_VERSION;
+	hdr.record_size = sizeof(comp);
+	f = platform->open("partial.vfl", PLATFORM_OPEN_CREATE, 0666);
+	TEST_ASSERT(f > 0);
+	TEST_ASSERT_EQ(platform->write(f, (char *)&hdr, sizeof(hdr)),
+		       sizeof(hdr));
+	for (i = 0; i < 3; i++) {
+		complog_rec(&comp, i);
+		TEST_ASSERT_EQ(platform->write(f, (char *)&comp, sizeof(comp)),
+			       sizeof(comp));
+	}
+	TEST_ASSERT_EQ(platform->write(f, (char *)&comp, sizeof(comp) / 2),
+		       sizeof(comp) / 2);
+	platform->close(f);
+
+	TEST_ASSERT_EQ(complog_check(platform, "partial.vfl", 3), 3);
+	TEST_ASSERT_EQ(complog_reader_open(platform, &rd, "partial.vfl"), 0);
+	while (complog_reader_next(&rd, &comp) > 0)
+		;
+	TEST_ASSERT(rd.truncated);
+	complog_reader_close(&rd);
+
+	/* Anything else isn't a log */
+	f = platform->open("other.vfl", PLATFORM_OPEN_CREATE, 0666);
+	TEST_ASSERT(f > 0);
+	TEST_ASSERT_EQ(platform->write(f, (char *)&comp, sizeof(comp)),
+		       sizeof(comp));
+	platform->close(f);
+	TEST_ASSERT(complog_reader_open(platform, &rd, "other.vfl"));
+	TEST_ASSERT(complog_reader_open(platform, &rd, "missing.vfl"));
+	test_platform_finalize();
+
+	return 0;
+}
+
+int test_complog(void)
+{
+	TEST_INIT();
+
+	TEST(complog_inline);
+	TEST(complog_threaded);
+	TEST(complog_partial);
+
+	TEST_END();
+}
+
+TEST_MAIN(complog)
@@ -124,6 +124,83 @@ int test_frame_fill(void **state)
 	return 0;
 }
 
+static size_t count_zero(const unsigned char *p, size_t size)
+{
+	size_t cnt = 0;
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		cnt += !p[i];
+	return cnt;
+}
+
+int test_frame_fill_random(void **state)
+{
+	static unsigned char a[3 * FRAME_BLOCK + 100];
+	static unsigned char b[sizeof(a)];
+	size_t i;
+
+	(void)state;
+
+	/* Same seed, same data; the blocks differ from each other */
+	frame_fill_random(a, sizeof(a), 1, 0);
+	frame_fill_random(b, sizeof(b), 1, 0);
+	TEST_ASSERT_EQ(memcmp(a, b, sizeof(a)), 0);
+	TEST_ASSERT(count_zero(a, sizeof(a)) < 100);
+	TEST_ASSERT_NE(memcmp(a, a + FRAME_BLOCK, FRAME_BLOCK), 0);
+	frame_fill_random(b, sizeof(b), 2, 0);
+	TEST_ASSERT_NE(memcmp(a, b, FRAME_BLOCK), 0);
+
+	/* Half of every block compresses, the short last one too */
+	frame_fill_random(a, sizeof(a), 1, 50);
+	for (i = 0; i < 3; i++) {
+		TEST_ASSERT(count_zero(a + i * FRAME_BLOCK, FRAME_BLOCK / 2) <
+			    50);
+		TEST_ASSERT_EQI(i, count_zero(a + i * FRAME_BLOCK +
+						      FRAME_BLOCK / 2,
+					      FRAME_BLOCK / 2),
+				FRAME_BLOCK / 2);
+	}
+	TEST_ASSERT(count_zero(a + 3 * FRAME_BLOCK, 100) < 10);
+
+	/* Capped, so there's room for the stamp */
+	frame_fill_random(a, FRAME_BLOCK, 1, 100);
+	TEST_ASSERT(count_zero(a, FRAME_BLOCK) < FRAME_BLOCK - 16);
+
+	return 0;
+}
+
+int test_frame_stamp(void **state)
+{
+	static unsigned char a[2 * FRAME_BLOCK];
+	static unsigned char b[sizeof(a)];
+	size_t i;
+
+	(void)state;
+
+	frame_fill_random(a, sizeof(a), 1, 90);
+	memcpy(b, a, sizeof(a));
+	frame_stamp(a, sizeof(a), 1, 10);
+	frame_stamp(b, sizeof(b), 1, 11);
+	/* Every block differs from the other frame in its first 16 bytes */
+	for (i = 0; i < 2; i++) {
+		TEST_ASSERT_NE(memcmp(a + i * FRAME_BLOCK, b + i * FRAME_BLOCK,
+				      16),
+			       0);
+		TEST_ASSERT_EQI(i, memcmp(a + i * FRAME_BLOCK + 16,
+					  b + i * FRAME_BLOCK + 16,
+					  FRAME_BLOCK - 16), 0);
+	}
+
+	/* Stamping again for the same frame restores the same content */
+	frame_stamp(b, sizeof(b), 1, 10);
+	TEST_ASSERT_EQ(memcmp(a, b, sizeof(a)), 0);
+	frame_stamp(b, sizeof(b), 2, 10);
+	TEST_ASSERT_NE(memcmp(a, b, 16), 0);
+
+	return 0;
+}
+
 int test_frame_write_read(void **state)
 {
 	const platform_t *platform = *state;
@@ -166,6 +243,86 @@ int test_frame_write_read(void **state)
 	return 0;
 }
 
+int test_frame_write_read_chunked(void **state)
+{
+	const platform_t *platform = *state;
+	frame_t *frm;
+	frame_t *frm_read;
+	size_t fw;
+	int fd;
+
+	frm = gen_default_frame(platform);
+	frm_read = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+	TEST_ASSERT(frm_read);
+	TEST_ASSERT(frm->size > 3 * ALIGN_SIZE);
+
+	TEST_ASSERT_EQ(frame_fill(frm, 0x44), frm->size);
+	fd = platform->open("tst_chunk",
+			    PLATFORM_OPEN_WRITE | PLATFORM_OPEN_CREATE, 0666);
+	fw = frame_write_chunked(platform, fd, frm, 3 * ALIGN_SIZE);
+	TEST_ASSERT_EQ(fw, frm->size);
+	platform->close(fd);
+
+	fd = platform->open("tst_chunk", PLATFORM_OPEN_READ, 0666);
+	fw = frame_read_chunked(platform, fd, frm_read, ALIGN_SIZE);
+	TEST_ASSERT_EQ(fw, frm->size);
+	TEST_ASSERT_EQ(((unsigned char *)frm_read->data)[0], 0x44);
+	TEST_ASSERT_EQ(((unsigned char *)frm_read->data)[frm->size - 1],
+		       0x44);
+	platform->close(fd);
+
+	frame_destroy(platform, frm);
+	frame_destroy(platform, frm_read);
+
+	return 0;
+}
+
+int test_frame_pwrite_pread(void **state)
+{
+	const platform_t *platform = *state;
+	frame_t *frm;
+	frame_t *frm_read;
+	size_t fw;
+	int fd;
+
+	frm = gen_default_frame(platform);
+	frm_read = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+	TEST_ASSERT(frm_read);
+
+	fd = platform->open("tst_pos",
+			    PLATFORM_OPEN_WRITE | PLATFORM_OPEN_CREATE, 0666);
+
+	/* Second frame first, the gap before it must not matter */
+	TEST_ASSERT_EQ(frame_fill(frm, 0x43), frm->size);
+	fw = frame_pwrite(platform, fd, frm, frm->size, 0);
+	TEST_ASSERT_EQ(fw, frm->size);
+	TEST_ASSERT_EQ(frame_fill(frm, 0x42), frm->size);
+	fw = frame_pwrite(platform, fd, frm, 0, 0);
+	TEST_ASSERT_EQ(fw, frm->size);
+	platform->close(fd);
+
+	fd = platform->open("tst_pos", PLATFORM_OPEN_READ, 0666);
+	fw = frame_pread(platform, fd, frm_read, frm->size, 0);
+	TEST_ASSERT_EQ(fw, frm->size);
+	TEST_ASSERT_EQ(((unsigned char *)frm_read->data)[0], 0x43);
+	fw = frame_pread(platform, fd, frm_read, 0, ALIGN_SIZE);
+	TEST_ASSERT_EQ(fw, frm->size);
+	TEST_ASSERT_EQ(((unsigned char *)frm_read->data)[0], 0x42);
+	TEST_ASSERT_EQ(((unsigned char *)frm_read->data)[frm->size - 1],
+		       0x42);
+	/* Past the end */
+	fw = frame_pread(platform, fd, frm_read, 2 * frm->size, 0);
+	TEST_ASSERT_EQ(fw, 0);
+	platform->close(fd);
+
+	frame_destroy(platform, frm);
+	frame_destroy(platform, frm_read);
+
+	return 0;
+}
+
 int test_frame_from_file(void **state)
 {
 	const platform_t *platform = *state;
@@ -205,14 +362,131 @@ int test_frame_from_file(void **state)
 	return 0;
 }
 
+int test_frame_pool(void **state)
+{
+	const platform_t *platform = *state;
+	frame_pool_t pool;
+	frame_t *frm;
+	size_t i;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	TEST_ASSERT_EQ(frame_pool_create(platform, &pool, frm, 4, 0,
+					 PLATFORM_PAGES_DEFAULT),
+		       0);
+	TEST_ASSERT_EQ(pool.cnt, 4);
+	TEST_ASSERT_EQ(pool.stride % ALIGN_SIZE, 0);
+	TEST_ASSERT(pool.stride >= frm->size);
+	for (i = 0; i < pool.cnt; i++) {
+		char *buf = frame_pool_buf(&pool, i);
+
+		frame_pool_fill(&pool, frm, i);
+		TEST_ASSERT_EQ((size_t)buf % ALIGN_SIZE, 0);
+		TEST_ASSERT_EQ(memcmp(buf, frm->data, frm->size), 0);
+	}
+	TEST_ASSERT(frame_pool_buf(&pool, 0) != frame_pool_buf(&pool, 1));
+	TEST_ASSERT(frame_pool_buf(&pool, 4) == frame_pool_buf(&pool, 0));
+	frame_pool_destroy(platform, &pool);
+
+	/* The budget caps the buffers, but there's always one */
+	TEST_ASSERT_EQ(frame_pool_create(platform, &pool, frm, 4,
+					 frm->size * 2 + ALIGN_SIZE * 2,
+					 PLATFORM_PAGES_DEFAULT),
+		       0);
+	TEST_ASSERT_EQ(pool.cnt, 2);
+	TEST_ASSERT(frame_pool_buf(&pool, 3) == frame_pool_buf(&pool, 1));
+	frame_pool_destroy(platform, &pool);
+
+	TEST_ASSERT_EQ(frame_pool_create(platform, &pool, frm, 4, 1,
+					 PLATFORM_PAGES_DEFAULT),
+		       0);
+	TEST_ASSERT_EQ(pool.cnt, 1);
+	frame_pool_destroy(platform, &pool);
+	TEST_ASSERT(!pool.arena);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+static size_t fake_pages_mapped;
+
+/* Hands out 2M pages whatever is asked for, on the heap */
+static int fake_page_alloc(void **res, size_t size, platform_pages_t want,
+			   platform_pages_t *got)
+{
+	(void)want;
+	if (posix_memalign(res, ALIGN_SIZE, size))
+		return 1;
+	*got = PLATFORM_PAGES_HUGE_2M;
+	fake_pages_mapped += size;
+	return 0;
+}
+
+static void fake_page_free(void *mem, size_t size, platform_pages_t pages)
+{
+	if (pages == PLATFORM_PAGES_HUGE_2M)
+		fake_pages_mapped -= size;
+	free(mem);
+}
+
+int test_frame_pool_pages(void **state)
+{
+	platform_t platform = *(const platform_t *)*state;
+	frame_pool_t pool;
+	frame_t *frm;
+
+	frm = gen_default_frame(&platform);
+	TEST_ASSERT(frm);
+
+	/* Without page_alloc the pool stays on regular pages */
+	platform.page_alloc = NULL;
+	TEST_ASSERT_EQ(frame_pool_create(&platform, &pool, frm, 2, 0,
+					 PLATFORM_PAGES_HUGE_1G),
+		       0);
+	TEST_ASSERT_EQ(pool.pages, PLATFORM_PAGES_DEFAULT);
+	frame_pool_destroy(&platform, &pool);
+
+	platform.page_alloc = fake_page_alloc;
+	platform.page_free = fake_page_free;
+	TEST_ASSERT_EQ(frame_pool_create(&platform, &pool, frm, 2, 0,
+					 PLATFORM_PAGES_HUGE_1G),
+		       0);
+	TEST_ASSERT_EQ(pool.pages, PLATFORM_PAGES_HUGE_2M);
+	TEST_ASSERT_EQ(fake_pages_mapped, pool.stride * 2);
+	frame_pool_fill(&pool, frm, 1);
+	TEST_ASSERT_EQ(memcmp(frame_pool_buf(&pool, 1), frm->data, frm->size),
+		       0);
+	frame_pool_destroy(&platform, &pool);
+	TEST_ASSERT_EQ(fake_pages_mapped, 0);
+
+	/* Regular pages don't go through page_alloc */
+	TEST_ASSERT_EQ(frame_pool_create(&platform, &pool, frm, 2, 0,
+					 PLATFORM_PAGES_DEFAULT),
+		       0);
+	TEST_ASSERT_EQ(fake_pages_mapped, 0);
+	frame_pool_destroy(&platform, &pool);
+
+	frame_destroy(&platform, frm);
+
+	return 0;
+}
+
 int test_frame(void)
 {
 	TEST_INIT();
 
 	TESTF(frame_gen, test_setup, test_teardown);
 	TESTF(frame_fill, test_setup, test_teardown);
+	TESTF(frame_fill_random, test_setup, test_teardown);
+	TESTF(frame_stamp, test_setup, test_teardown);
 	TESTF(frame_write_read, test_setup, test_teardown);
+	TESTF(frame_write_read_chunked, test_setup, test_teardown);
+	TESTF(frame_pwrite_pread, test_setup, test_teardown);
 	TESTF(frame_from_file, test_setup, test_teardown);
+	TESTF(frame_pool, test_setup, test_teardown);
+	TESTF(frame_pool_pages, test_setup, test_teardown);
 
 	TEST_END();
 }
@@ -22,164 +22,172 @@
 #include "histogram.h"
 #include "histogram.c"
 
-int test_histogram_time_bucket(void)
+int test_histogram_create(void)
 {
-	size_t bucket;
-
-	bucket = time_get_bucket(0);
-	TEST_ASSERT_EQ(bucket, 0);
-
-	bucket = time_get_bucket(1);
-	TEST_ASSERT_EQ(bucket, 0);
-
-	bucket = time_get_bucket(200001);
-	TEST_ASSERT_EQ(bucket, 1);
-
-	bucket = time_get_bucket(2000001);
-	TEST_ASSERT_EQ(bucket, 4);
-
-	bucket = time_get_bucket(20000001);
-	TEST_ASSERT_EQ(bucket, 7);
-
-	bucket = time_get_bucket(200000001);
-	TEST_ASSERT_EQ(bucket, 10);
-
-	bucket = time_get_bucket(2000000001);
-	TEST_ASSERT_EQ(bucket, 12);
-
-	bucket = time_get_bucket(20000000001);
-	TEST_ASSERT_EQ(bucket, 12);
-
-	bucket = time_get_bucket(200000000001);
-	TEST_ASSERT_EQ(bucket, 12);
+	hist_t *hist;
+
+	/* 3 digits: 2048 sub buckets of 512 ns, 23 doublings up to 1 h */
+	hist = hist_create(HIST_LOWEST, HIST_HIGHEST, 3);
+	TEST_ASSERT(hist);
+	TEST_ASSERT_EQ(hist->unit_magnitude, 9);
+	TEST_ASSERT_EQ(hist->half_magnitude, 10);
+	TEST_ASSERT_EQ(hist->counts_len, 24 * 1024);
+	hist_destroy(hist);
+
+	TEST_ASSERT(!hist_create(0, HIST_HIGHEST, 3));
+	TEST_ASSERT(!hist_create(HIST_LOWEST, HIST_LOWEST, 3));
+	TEST_ASSERT(!hist_create(HIST_LOWEST, HIST_HIGHEST, 0));
+	TEST_ASSERT(!hist_create(HIST_LOWEST, HIST_HIGHEST,
+				 HIST_DIGITS_MAX + 1));
 
 	return 0;
 }
 
-int test_histogram_time_sub_bucket(void)
+int test_histogram_precision(void)
 {
-	size_t bucket;
-
-	bucket = time_get_sub_bucket(0, 1);
-	TEST_ASSERT_EQ(bucket, 0);
-
-	bucket = time_get_sub_bucket(0, 40001);
-	TEST_ASSERT_EQ(bucket, 1);
-
-	bucket = time_get_sub_bucket(0, 80001);
-	TEST_ASSERT_EQ(bucket, 2);
-
-	bucket = time_get_sub_bucket(0, 120001);
-	TEST_ASSERT_EQ(bucket, 3);
-
-	bucket = time_get_sub_bucket(0, 199999);
-	TEST_ASSERT_EQ(bucket, 4);
-
-	/* Out of range - should return last sub bucket (fallback) */
-	bucket = time_get_sub_bucket(0, 2000000);
-	TEST_ASSERT_EQ(bucket, 4);
-
-	/* Time below bucket min - should return first sub bucket (fallback) */
-	bucket = time_get_sub_bucket(1, 0);
-	TEST_ASSERT_EQ(bucket, 0);
+	static const uint64_t vals[] = {
+		1, 999, 1000, 123456, 1048576, 9999999, 1000000000ULL,
+		HIST_HIGHEST,
+	};
+	hist_t *hist;
+	size_t i;
 
-	/* Time within bucket range */
-	bucket = time_get_sub_bucket(4, 2000200);
-	TEST_ASSERT_EQ(bucket, 0);
+	hist = hist_create(HIST_LOWEST, HIST_HIGHEST, 3);
+	TEST_ASSERT(hist);
+	for (i = 0; i < sizeof(vals) / sizeof(*vals); i++) {
+		size_t idx = hist_index(hist, vals[i]);
+		uint64_t low = hist_value_at(hist, idx);
+		uint64_t high = hist_highest_equivalent(hist, vals[i]);
+
+		TEST_ASSERT(idx < hist->counts_len);
+		TEST_ASSERT(low <= vals[i]);
+		TEST_ASSERT(high >= vals[i]);
+		/* Single unit near zero, three digits above that */
+		TEST_ASSERT(high - low < 512 || (high - low) * 1000 <= vals[i]);
+	}
+	hist_destroy(hist);
 
 	return 0;
 }
 
-void gen_completions(test_result_t *res)
+int test_histogram_percentile(void)
 {
+	hist_t *hist;
+	uint64_t val;
 	size_t i;
 
-	res->completion =
-		malloc(sizeof(*res->completion) * res->frames_written);
-	for (i = 0; i < res->frames_written; i++) {
-		res->completion[i].start = 1;
-		res->completion[i].open = 2;
-		res->completion[i].io = (i * 1) * (i * 1) * (i * 1) * 100UL;
-		res->completion[i].close = res->completion[i].io + 1;
-		res->completion[i].frame = res->completion[i].close + 2;
-	}
+	hist = hist_create(HIST_LOWEST, HIST_HIGHEST, 3);
+	TEST_ASSERT(hist);
+	TEST_ASSERT_EQ(hist_percentile(hist, 50), 0);
+
+	/* 1 to 10000 us */
+	for (i = 1; i <= 10000; i++)
+		hist_record(hist, i * 1000);
+	TEST_ASSERT_EQ(hist->total, 10000);
+	TEST_ASSERT_EQ(hist->min, 1000);
+	TEST_ASSERT_EQ(hist->max, 10000000);
+	TEST_ASSERT_EQ(hist_mean(hist), 5000500);
+
+	val = hist_percentile(hist, 50);
+	TEST_ASSERT(val >= 5000000 && val <= 5005000);
+	val = hist_percentile(hist, 99.9);
+	TEST_ASSERT(val >= 9990000 && val <= 10000000);
+	TEST_ASSERT_EQ(hist_percentile(hist, 100), 10000000);
+	TEST_ASSERT_EQ(hist_percentile(hist, 0), 1000);
+
+	/* Beyond the range values count as the highest one */
+	hist_record(hist, 2 * HIST_HIGHEST);
+	TEST_ASSERT_EQ(hist->max, HIST_HIGHEST);
+	hist_destroy(hist);
+
+	return 0;
 }
 
-int test_histogram_collect_cnts(void)
+int test_histogram_merge(void)
 {
-	test_result_t res = {
-		.frames_written = 100,
-	};
-	uint64_t cnts[SUB_BUCKET_CNT * (buckets_cnt + 1)] = { 0 };
-	uint64_t expected[SUB_BUCKET_CNT * (buckets_cnt + 1)] = {
-		8, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 2, 1,
-		1, 1, 2, 2, 2, 2, 1, 3, 2, 2, 1, 2, 3, 2, 3, 2, 2, 5,
-		5, 4, 4, 3, 5, 4, 4, 4, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-	};
-	size_t sbcnt;
-	size_t i;
-	size_t framecnt;
-
-	gen_completions(&res);
-	hist_collect_cnts(&res, cnts);
-	framecnt = 0;
-	sbcnt = hist_cnts();
-	for (i = 0; i < sbcnt; i++)
-		framecnt += cnts[i];
-	TEST_ASSERT_EQ(framecnt, res.frames_written);
-
-	for (i = 0; i < sbcnt; i++)
-		TEST_ASSERT_EQI(i, cnts[i], expected[i]);
-
-	free(res.completion);
+	hist_t *a;
+	hist_t *b;
+	hist_t *c;
+	hist_t *dst = NULL;
+
+	a = hist_create(HIST_LOWEST, HIST_HIGHEST, 3);
+	b = hist_create(HIST_LOWEST, HIST_HIGHEST, 3);
+	c = hist_create(HIST_LOWEST, HIST_HIGHEST, 2);
+	TEST_ASSERT(a && b && c);
+	hist_record(a, 2000);
+	hist_record(b, 5000000);
+	hist_record(c, 1000000000ULL);
+
+	/* The first merge takes the layout of its source */
+	TEST_ASSERT_EQ(hist_merge(&dst, a), 0);
+	TEST_ASSERT(dst);
+	TEST_ASSERT_EQ(dst->digits, 3);
+	TEST_ASSERT_EQ(hist_merge(&dst, b), 0);
+	TEST_ASSERT_EQ(hist_merge(&dst, c), 0);
+	TEST_ASSERT_EQ(dst->total, 3);
+	TEST_ASSERT_EQ(dst->min, 2000);
+	TEST_ASSERT_EQ(dst->max, 1000000000ULL);
+	TEST_ASSERT_EQ(hist_percentile(dst, 50),
+		       hist_highest_equivalent(dst, 5000000));
+
+	/* Removing an extreme falls back to its neighbour */
+	hist_remove(dst, 2000);
+	TEST_ASSERT_EQ(dst->total, 2);
+	TEST_ASSERT_EQ(dst->min, hist_value_at(dst, hist_index(dst, 5000000)));
+
+	TEST_ASSERT(hist_merge(&dst, NULL));
+
+	hist_destroy(a);
+	hist_destroy(b);
+	hist_destroy(c);
+	hist_destroy(dst);
 
 	return 0;
 }
 
-int test_histogram_cnts_max(void)
+int test_histogram_export(void)
 {
-	test_result_t res = {
-		.frames_written = 100,
-	};
-	uint64_t cnts[SUB_BUCKET_CNT * (buckets_cnt + 1)] = { 0 };
-	uint64_t max;
-	size_t sbcnt;
+	hist_t *hist;
+	FILE *f;
 
-	gen_completions(&res);
-	hist_collect_cnts(&res, cnts);
+	hist = hist_create(HIST_LOWEST, HIST_HIGHEST, 3);
+	TEST_ASSERT(hist);
+	hist_record(hist, 1000000);
+	hist_record(hist, 2000000);
 
-	sbcnt = hist_cnts();
-	max = hist_cnts_max(cnts, sbcnt);
-	TEST_ASSERT_EQ(max, 8);
+	f = tmpfile();
+	TEST_ASSERT(f);
+	TEST_ASSERT_EQ(hist_export(hist, f), 0);
+	TEST_ASSERT(ftell(f) > 0);
+	fclose(f);
 
-	free(res.completion);
+	TEST_ASSERT(hist_export(NULL, stdout));
+	hist_destroy(hist);
 
 	return 0;
 }
 
 int test_histogram_print(void)
 {
-	test_completion_t compl = {
-		.start = 1,
-		.open = 10,
-		.io = 20,
-		.close = 30,
-		.frame = 1,
-	};
-	test_result_t res = {
-		.frames_written = 1,
-	};
+	test_result_t res = { 0 };
 
 	test_ignore_printf(1);
 
 	print_histogram(&res);
 
-	res.completion = &compl;
+	res.hist = hist_create(HIST_LOWEST, HIST_HIGHEST, 3);
+	res.hist_intended = hist_create(HIST_LOWEST, HIST_HIGHEST, 3);
+	TEST_ASSERT(res.hist && res.hist_intended);
+	print_histogram(&res);
+	hist_record(res.hist, 1000);
+	hist_record(res.hist, 100000000);
 	print_histogram(&res);
 
 	test_ignore_printf(0);
 
+	hist_destroy(res.hist);
+	hist_destroy(res.hist_intended);
+
 	return 0;
 }
 
@@ -187,10 +195,11 @@ int test_histogram(void)
 {
 	TEST_INIT();
 
-	TEST(histogram_time_bucket);
-	TEST(histogram_time_sub_bucket);
-	TEST(histogram_collect_cnts);
-	TEST(histogram_cnts_max);
+	TEST(histogram_create);
+	TEST(histogram_precision);
+	TEST(histogram_percentile);
+	TEST(histogram_merge);
+	TEST(histogram_export);
 	TEST(histogram_print);
 
 	TEST_END();
@@ -0,0 +1,130 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/* mkdtemp() */
+#define _POSIX_C_SOURCE 200809L
+#include "numa.c"
+#include <unistd.h>
+#include "unittest.h"
+
+int test_numa_parse_cpulist(void)
+{
+	platform_cpuset_t set;
+
+	TEST_ASSERT_EQ(numa_parse_cpulist("0-3,8-11\n", &set), 0);
+	TEST_ASSERT_EQ(set.cnt, 8);
+	TEST_ASSERT(platform_cpuset_isset(&set, 3));
+	TEST_ASSERT(!platform_cpuset_isset(&set, 4));
+	TEST_ASSERT(platform_cpuset_isset(&set, 8));
+
+	TEST_ASSERT_EQ(numa_parse_cpulist("5", &set), 0);
+	TEST_ASSERT_EQ(set.cnt, 1);
+	TEST_ASSERT_EQ(numa_parse_cpulist("1-2,2-3", &set), 0);
+	TEST_ASSERT_EQ(set.cnt, 3);
+
+	/* Memory-only nodes have an empty list */
+	TEST_ASSERT_EQ(numa_parse_cpulist("\n", &set), 0);
+	TEST_ASSERT_EQ(set.cnt, 0);
+
+	TEST_ASSERT_NE(numa_parse_cpulist("3-1", &set), 0);
+	TEST_ASSERT_NE(numa_parse_cpulist("1,,2", &set), 0);
+	TEST_ASSERT_NE(numa_parse_cpulist("0-", &set), 0);
+	TEST_ASSERT_NE(numa_parse_cpulist("x", &set), 0);
+	TEST_ASSERT_NE(numa_parse_cpulist("1024", &set), 0);
+
+	return 0;
+}
+
+static int numa_fake_node(const char *root, const char *name,
+			  const char *cpus)
+{
+	char path[PATH_MAX];
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%s/%s", root, name);
+	if (mkdir(path, 0755))
+		return 1;
+	if (!cpus)
+		return 0;
+	snprintf(path, sizeof(path), "%s/%s/cpulist", root, name);
+	f = fopen(path, "w");
+	if (!f)
+		return 1;
+	fputs(cpus, f);
+	return fclose(f);
+}
+
+static void numa_fake_remove(const char *root, const char *name)
+{
+	char path[PATH_MAX];
+
+	snprintf(path, sizeof(path), "%s/%s/cpulist", root, name);
+	remove(path);
+	snprintf(path, sizeof(path), "%s/%s", root, name);
+	rmdir(path);
+}
+
+int test_numa_read(void)
+{
+	static const char *const names[] = { "node0", "node1", "node2",
+					     "nodes", "power" };
+	char root[] = "numa-XXXXXX";
+	numa_t numa;
+	size_t i;
+
+	TEST_ASSERT(mkdtemp(root));
+	/* Out of order, one node without CPUs and two that aren't nodes */
+	TEST_ASSERT_EQ(numa_fake_node(root, "node1", "4-7\n"), 0);
+	TEST_ASSERT_EQ(numa_fake_node(root, "node0", "0-3\n"), 0);
+	TEST_ASSERT_EQ(numa_fake_node(root, "node2", "\n"), 0);
+	TEST_ASSERT_EQ(numa_fake_node(root, "nodes", "8\n"), 0);
+	TEST_ASSERT_EQ(numa_fake_node(root, "power", NULL), 0);
+
+	TEST_ASSERT_EQ(numa_read(&numa, root), 0);
+	TEST_ASSERT_EQ(numa.node_cnt, 2);
+	TEST_ASSERT_EQ(numa.nodes[0].id, 0);
+	TEST_ASSERT_EQ(numa.nodes[1].id, 1);
+	TEST_ASSERT(numa_node(&numa, 1) == &numa.nodes[1]);
+	TEST_ASSERT_EQ(numa_node(&numa, 1)->cpus.cnt, 4);
+	TEST_ASSERT(platform_cpuset_isset(&numa_node(&numa, 1)->cpus, 7));
+	TEST_ASSERT(!numa_node(&numa, 2));
+	TEST_ASSERT(!numa_node(&numa, -1));
+
+	for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+		numa_fake_remove(root, names[i]);
+	TEST_ASSERT_EQ(rmdir(root), 0);
+
+	TEST_ASSERT_NE(numa_read(&numa, root), 0);
+	TEST_ASSERT_EQ(numa.node_cnt, 0);
+
+	return 0;
+}
+
+int test_numa(void)
+{
+	TEST_INIT();
+
+	TEST(numa_parse_cpulist);
+	TEST(numa_read);
+
+	TEST_END();
+}
+
+TEST_MAIN(numa)
@@ -156,6 +156,52 @@ static inline size_t test_platform_read(platform_handle_t handle, char *buf,
 	return cnt;
 }
 
+static inline size_t test_platform_pwrite(platform_handle_t handle,
+					  const char *buf, size_t size,
+					  platform_off_t offs)
+{
+	test_platform_file_t *f;
+	size_t end = offs + size;
+	char *tmp;
+
+	if (!handle || handle > file_cnt || offs < 0)
+		return 0;
+
+	f = &files[handle - 1];
+	if (end > f->size) {
+		tmp = realloc(f->data, end);
+		if (!tmp)
+			return 0;
+		memset(tmp + f->size, 0, end - f->size);
+		f->data = tmp;
+		f->size = end;
+	}
+	memmove(f->data + offs, buf, size);
+
+	return size;
+}
+
+static inline size_t test_platform_pread(platform_handle_t handle, char *buf,
+					 size_t size, platform_off_t offs)
+{
+	test_platform_file_t *f;
+	size_t cnt;
+
+	if (!handle || handle > file_cnt || offs < 0)
+		return 0;
+
+	f = &files[handle - 1];
+	if (!f->data || (size_t)offs >= f->size)
+		return 0;
+
+	cnt = size;
+	if (offs + cnt > f->size)
+		cnt = f->size - offs;
+	memmove(buf, f->data + offs, cnt);
+
+	return cnt;
+}
+
 static inline platform_off_t test_platform_seek(platform_handle_t handle,
 						platform_off_t offs,
 						platform_seek_flags_t whence)
@@ -242,6 +288,8 @@ static platform_t test_platform = {
 	.write = test_platform_write,
 	.read = test_platform_read,
 	.seek = test_platform_seek,
+	.pwrite = test_platform_pwrite,
+	.pread = test_platform_pread,
 
 	.usleep = test_platform_usleep,
 	.stat = test_platform_stat,
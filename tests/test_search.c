@@ -0,0 +1,145 @@
+/*
+ * This file is part of tframetest.
+ *
+ * Copyright (c) 2023-2025 Tuxera Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "unittest.h"
+#include "search.h"
+#include "search.c"
+
+/* Step through a search against a system sustaining up to limit */
+static size_t search_run(search_t *search, size_t limit, size_t *steps)
+{
+	size_t level;
+
+	*steps = 0;
+	for (level = search->level; level;
+	     level = search_next(search, level <= limit))
+		++*steps;
+
+	return search->pass;
+}
+
+int test_search_bisect(void)
+{
+	search_t search;
+	size_t steps;
+
+	search_init(&search, 24, 0);
+	TEST_ASSERT_EQ(search.level, 24);
+	TEST_ASSERT(search_run(&search, 150, &steps) <= 150);
+	TEST_ASSERT(search.fail > 150);
+	TEST_ASSERT((search.fail - search.pass) * SEARCH_RESOLUTION <=
+		    search.pass);
+	/* 24, 48, 96, 192 and then bisection of 96..192 */
+	TEST_ASSERT(steps <= 4 + 7);
+
+	search_init(&search, 1, 0);
+	TEST_ASSERT_EQ(search_run(&search, 5, &steps), 5);
+	TEST_ASSERT_EQ(search.fail, 6);
+
+	return 0;
+}
+
+int test_search_max(void)
+{
+	search_t search;
+	size_t steps;
+
+	search_init(&search, 10, 30);
+	TEST_ASSERT_EQ(search_run(&search, 1000, &steps), 30);
+	TEST_ASSERT_EQ(steps, 3);
+	TEST_ASSERT_EQ(search.fail, 0);
+
+	search_init(&search, 100, 30);
+	TEST_ASSERT_EQ(search.level, 30);
+
+	return 0;
+}
+
+int test_search_none(void)
+{
+	search_t search;
+	size_t steps;
+
+	search_init(&search, 4, 0);
+	TEST_ASSERT_EQ(search_run(&search, 0, &steps), 0);
+	TEST_ASSERT_EQ(search.fail, 1);
+	TEST_ASSERT_EQ(steps, 3);
+
+	return 0;
+}
+
+int test_search_percentile(void)
+{
+	test_completion_t comp[100] = { { 0 } };
+	test_result_t res = {
+		.frames_written = 100,
+		.completion = comp,
+		.completion_cnt = 100,
+	};
+	size_t i;
+
+	for (i = 0; i < 100; i++) {
+		test_frame_timing_t t = { .start = 1000 };
+
+		t.open = t.io = t.close = t.start + 100 - i;
+		test_completion_pack(&comp[i], &t);
+	}
+	TEST_ASSERT_EQ(search_percentile(&res, 50), 50);
+	TEST_ASSERT_EQ(search_percentile(&res, 99), 99);
+	TEST_ASSERT_EQ(search_percentile(&res, 100), 100);
+
+	/* Frames started late are charged from their intended start */
+	comp[0].late = test_completion_pack_ns(500, COMPLETION_LATE_BITS) |
+		       COMPLETION_PACED << COMPLETION_LATE_BITS;
+	TEST_ASSERT_EQ(search_percentile(&res, 100), 600);
+
+	return 0;
+}
+
+int test_search_sweep_efficiency(void)
+{
+	sweep_point_t points[3] = {
+		{ .threads = 1, .depth = 1, .mibps = 100 },
+		{ .threads = 2, .depth = 1, .mibps = 200 },
+		{ .threads = 4, .depth = 2, .mibps = 400 },
+	};
+
+	sweep_efficiency(points, 3);
+	TEST_ASSERT(points[0].efficiency == 1.0);
+	TEST_ASSERT(points[1].efficiency == 1.0);
+	TEST_ASSERT(points[2].efficiency == 0.5);
+
+	return 0;
+}
+
+int test_search(void)
+{
+	TEST_INIT();
+
+	TEST(search_bisect);
+	TEST(search_max);
+	TEST(search_none);
+	TEST(search_percentile);
+	TEST(search_sweep_efficiency);
+
+	TEST_END();
+}
+
+TEST_MAIN(search)
@@ -47,6 +47,36 @@ size_t frame_read(const platform_t *platform, platform_handle_t f,
 	return sizeof(*frame);
 }
 
+size_t frame_write_chunked(const platform_t *platform, platform_handle_t f,
+			   frame_t *frame, size_t req_size)
+{
+	(void)req_size;
+	return frame_write(platform, f, frame);
+}
+
+size_t frame_read_chunked(const platform_t *platform, platform_handle_t f,
+			  frame_t *frame, size_t req_size)
+{
+	(void)req_size;
+	return frame_read(platform, f, frame);
+}
+
+size_t frame_pwrite(const platform_t *platform, platform_handle_t f,
+		    frame_t *frame, platform_off_t offs, size_t req_size)
+{
+	(void)offs;
+	(void)req_size;
+	return frame_write(platform, f, frame);
+}
+
+size_t frame_pread(const platform_t *platform, platform_handle_t f,
+		   frame_t *frame, platform_off_t offs, size_t req_size)
+{
+	(void)offs;
+	(void)req_size;
+	return frame_read(platform, f, frame);
+}
+
 frame_t *frame_from_file(const platform_t *platform, const char *fname,
 			 size_t header_size)
 {
@@ -68,6 +98,21 @@ void frame_destroy(const platform_t *platform, frame_t *frame)
 	free(frame);
 }
 
+/* Frames stamped, and the sum of their numbers */
+static struct {
+	size_t cnt;
+	uint64_t sum;
+} fake_stamp;
+
+void frame_stamp(void *buf, size_t size, uint64_t seed, uint64_t n)
+{
+	(void)buf;
+	(void)size;
+	(void)seed;
+	++fake_stamp.cnt;
+	fake_stamp.sum += n;
+}
+
 profile_t profile_get_by_index(size_t idx)
 {
 	profile_t p = { "SD-32bit-cmp", PROF_SD, 720, 480, 4, 0 };
@@ -200,6 +245,375 @@ int test_tester_run_write_read_fps(void **state)
 	return res;
 }
 
+int test_tester_pacer(void **state)
+{
+	const platform_t *platform = *state;
+	tester_params_t params = { 0 };
+	tester_pacer_t pacer;
+	uint64_t start;
+
+	params.fps = 3;
+	params.pace_spin = 1000;
+	tester_pacer_init(&pacer, &params);
+
+	/* Deadlines are absolute, a third of a second does not accumulate */
+	pacer.t0 = 100;
+	TEST_ASSERT_EQ(tester_pacer_deadline(&pacer, 1), 100 + 333333333);
+	TEST_ASSERT_EQ(tester_pacer_deadline(&pacer, 3), 100 + SEC_IN_NS);
+	TEST_ASSERT_EQ(tester_pacer_deadline(&pacer, 3000),
+		       100 + 1000 * SEC_IN_NS);
+
+	/* First frame starts the clock, later ones wait for their slot */
+	TEST_ASSERT(tester_pacer_due(&pacer, 0));
+	start = pacer.t0;
+	TEST_ASSERT(!tester_pacer_due(&pacer, 2));
+	tester_pacer_wait(platform, &pacer, 2);
+	TEST_ASSERT(timing_time() >= start + 2 * SEC_IN_NS / 3);
+	TEST_ASSERT(tester_pacer_due(&pacer, 2));
+
+	/* Without fps everything is due */
+	params.fps = 0;
+	tester_pacer_init(&pacer, &params);
+	TEST_ASSERT(tester_pacer_due(&pacer, 5));
+
+	return 0;
+}
+
+int test_tester_run_intended(void **state)
+{
+	const platform_t *platform = *state;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	frame_t *frm;
+	size_t i;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = 3;
+	params.fps = 10;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+
+	/* Paced frames record their slot on the schedule */
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.frames_written, 3);
+	for (i = 0; i < 3; i++) {
+		TEST_ASSERT_EQ(test_completion_intended(&res.completion[i]),
+			       test_completion_intended(&res.completion[0]) +
+				       i * SEC_IN_NS / 10);
+		TEST_ASSERT(res.completion[i].start >=
+			    test_completion_intended(&res.completion[i]));
+	}
+	result_free(platform, &res);
+
+	/* Unpaced ones don't have one */
+	params.fps = 0;
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(test_completion_intended(&res.completion[1]), 0);
+	result_free(platform, &res);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_duration(void **state)
+{
+	const platform_t *platform = *state;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	frame_t *frm;
+	size_t i;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = 3;
+	params.fps = 10;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.end = timing_time() + SEC_IN_NS;
+
+	/* A second at 10 fps wraps around the three frames */
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT(res.frames_written >= 9);
+	TEST_ASSERT_EQ(res.frames_failed, 0);
+
+	/* Only the latest ones are kept, oldest first */
+	TEST_ASSERT_EQ(res.completion_cnt, 3);
+	for (i = 1; i < 3; i++)
+		TEST_ASSERT_EQ(test_completion_intended(&res.completion[i]),
+			       test_completion_intended(&res.completion[i - 1]) +
+				       SEC_IN_NS / 10);
+	result_free(platform, &res);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_steady_state(void **state)
+{
+	const platform_t *platform = *state;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	frame_t *frm;
+	size_t i;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = 10;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.warmup_frames = 2;
+	params.cooldown_frames = 3;
+	params.hist_digits = HIST_DIGITS;
+
+	/* Both ends are kept, but flagged */
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.completion_cnt, 10);
+	TEST_ASSERT_EQ(res.completion_excluded, 5);
+	for (i = 0; i < 10; i++)
+		TEST_ASSERT_EQ(test_completion_excluded(&res.completion[i]),
+			       i < 2 || i >= 7);
+	/* Only the steady state makes it into the histogram */
+	TEST_ASSERT(res.hist);
+	TEST_ASSERT_EQ(res.hist->total, 5);
+	result_free(platform, &res);
+
+	/* A warm-up in time counts from the start of the first frame */
+	params.warmup_frames = 0;
+	params.cooldown_frames = 0;
+	params.fps = 10;
+	params.warmup = SEC_IN_NS / 4;
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.completion_excluded, 3);
+	TEST_ASSERT(test_completion_excluded(&res.completion[2]));
+	TEST_ASSERT(!test_completion_excluded(&res.completion[3]));
+	result_free(platform, &res);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_completion_pack(void)
+{
+	test_frame_timing_t t = { 0 };
+	test_completion_t comp;
+
+	/* A 64-bit start and four 32-bit words */
+	TEST_ASSERT_EQ(sizeof(comp), 24);
+
+	t.start = 5 * SEC_IN_NS;
+	t.open = t.start + 1000;
+	t.io = t.open + 16 * 1000 * 1000;
+	t.close = t.io + 7;
+	t.intended = t.start - 1200;
+	t.io_mode = IO_MODE_BUFFERED;
+	test_completion_pack(&comp, &t);
+	TEST_ASSERT_EQ(comp.start, t.start);
+	TEST_ASSERT_EQ(test_completion_open(&comp), 1000);
+	TEST_ASSERT_EQ(test_completion_io(&comp), 16 * 1000 * 1000);
+	TEST_ASSERT_EQ(test_completion_close(&comp), 7);
+	TEST_ASSERT_EQ(test_completion_frame(&comp), t.close - t.start);
+	TEST_ASSERT_EQ(test_completion_intended(&comp), t.intended);
+	TEST_ASSERT_EQ(test_completion_intended_time(&comp),
+		       t.close - t.intended);
+	TEST_ASSERT_EQ(test_completion_io_mode(&comp), IO_MODE_BUFFERED);
+	TEST_ASSERT(!test_completion_excluded(&comp));
+	test_completion_exclude(&comp, 1);
+	TEST_ASSERT(test_completion_excluded(&comp));
+	TEST_ASSERT_EQ(test_completion_intended(&comp), t.intended);
+
+	/* Long phases keep their leading 27 bits */
+	t.intended = 0;
+	t.io = t.open + 3600 * SEC_IN_NS;
+	test_completion_pack(&comp, &t);
+	TEST_ASSERT(test_completion_io(&comp) <= 3600 * SEC_IN_NS);
+	TEST_ASSERT(3600 * SEC_IN_NS - test_completion_io(&comp) <
+		    (3600 * SEC_IN_NS >> 26));
+	TEST_ASSERT_EQ(test_completion_intended(&comp), 0);
+	TEST_ASSERT_EQ(test_completion_io_mode(&comp), IO_MODE_BUFFERED);
+
+	/* Out of order timestamps don't wrap around */
+	t.close = t.open - 1;
+	t.io = t.open;
+	test_completion_pack(&comp, &t);
+	TEST_ASSERT_EQ(test_completion_close(&comp), 0);
+
+	return 0;
+}
+
+int test_tester_aggregate_histograms(void **state)
+{
+	const platform_t *platform = *state;
+	tester_params_t params = { 0 };
+	test_result_t res[2];
+	test_result_t tres = { 0 };
+	frame_t *frm;
+	size_t i;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = 4;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.hist_digits = HIST_DIGITS;
+
+	/* Without their records, workers merge histograms and counters */
+	for (i = 0; i < 2; i++) {
+		res[i] = tester_run(platform, TEST_OP_WRITE, &params);
+		test_result_drop_records(platform, &res[i]);
+		TEST_ASSERT(!res[i].completion);
+		TEST_ASSERT_EQ(test_result_aggregate(&tres, &res[i]), 0);
+	}
+	TEST_ASSERT(!tres.completion);
+	TEST_ASSERT_EQ(tres.completion_cnt, 0);
+	TEST_ASSERT_EQ(tres.frames_written, 8);
+	TEST_ASSERT(tres.hist);
+	TEST_ASSERT_EQ(tres.hist->total, 8);
+	TEST_ASSERT_EQ(test_result_steady_frames(&tres), 8);
+	TEST_ASSERT_EQ(tres.hist->sum, res[0].hist->sum + res[1].hist->sum);
+
+	for (i = 0; i < 2; i++)
+		result_free(platform, &res[i]);
+	result_free(platform, &tres);
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_load(void **state)
+{
+	const platform_t *platform = *state;
+	tester_params_t params = { 0 };
+	complog_header_t hdr = { { 0 } };
+	complog_writer_t *w;
+	complog_reader_t rd;
+	test_result_t res;
+	test_result_t lres;
+	frame_t *frm;
+	size_t i;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = 10;
+	params.fps = 10;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.hist_digits = HIST_DIGITS;
+	params.warmup_frames = 2;
+
+	hdr.frame_size = frm->size;
+	hdr.fps = params.fps;
+	w = complog_writer_create(platform);
+	TEST_ASSERT(w);
+	params.log = complog_open(w, "run-write-0.vfl", &hdr);
+	TEST_ASSERT(params.log);
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(complog_close(params.log), 0);
+	complog_writer_destroy(w);
+
+	/* The log brings back what the run had in memory */
+	params.log = NULL;
+	params.fps = 0;
+	TEST_ASSERT_EQ(complog_reader_open(platform, &rd, "run-write-0.vfl"),
+		       0);
+	TEST_ASSERT_EQ(tester_run_load(platform, &rd, &params, &lres), 0);
+	complog_reader_close(&rd);
+	TEST_ASSERT_EQ(lres.frames_written, res.frames_written);
+	TEST_ASSERT_EQ(lres.bytes_written, res.bytes_written);
+	TEST_ASSERT_EQ(lres.completion_cnt, 10);
+	TEST_ASSERT_EQ(lres.completion_excluded, 2);
+	for (i = 0; i < 10; i++)
+		TEST_ASSERT(!memcmp(&lres.completion[i], &res.completion[i],
+				    sizeof(res.completion[i])));
+	TEST_ASSERT(lres.hist_intended);
+	TEST_ASSERT_EQ(lres.hist->total, 8);
+	TEST_ASSERT_EQ(lres.hist->sum, res.hist->sum);
+	TEST_ASSERT_EQ(lres.hist_intended->sum, res.hist_intended->sum);
+	TEST_ASSERT_EQ(lres.min_frame_time_ns, res.min_frame_time_ns);
+	TEST_ASSERT_EQ(lres.avg_frame_time_ns, res.avg_frame_time_ns);
+	result_free(platform, &lres);
+	result_free(platform, &res);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_playback(void **state)
+{
+	const platform_t *platform = *state;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	test_result_t tres = { 0 };
+	frame_t *frm;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = 4;
+	params.fps = 10;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.playback = 1;
+	params.prebuffer = 1;
+
+	/* Frames land well within 100 ms periods */
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT(res.playback);
+	TEST_ASSERT_EQ(res.playback_stats.frames, 4);
+	TEST_ASSERT_EQ(res.playback_stats.dropped, 0);
+	TEST_ASSERT_EQ(res.playback_stats.startup_frames, 0);
+	TEST_ASSERT(res.playback_stats.min_slack_ns > SEC_IN_NS / 10);
+	TEST_ASSERT(test_result_playback_ok(&res));
+	TEST_ASSERT_EQ(test_result_aggregate(&tres, &res), 0);
+	result_free(platform, &res);
+
+	/* Nanosecond periods can't be met, every frame misses */
+	params.fps = SEC_IN_NS;
+	params.prebuffer = 0;
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.playback_stats.late, 4);
+	TEST_ASSERT_EQ(res.playback_stats.dropped, 4);
+	TEST_ASSERT_EQ(res.playback_stats.max_miss_run, 4);
+	TEST_ASSERT(res.playback_stats.min_slack_ns < 0);
+	TEST_ASSERT(res.playback_stats.startup_frames > 0);
+	TEST_ASSERT(!test_result_playback_ok(&res));
+
+	/* Aggregated, the failing worker fails the whole run */
+	TEST_ASSERT_EQ(test_result_aggregate(&tres, &res), 0);
+	TEST_ASSERT_EQ(tres.playback_stats.frames, 8);
+	TEST_ASSERT_EQ(tres.playback_stats.dropped, 4);
+	TEST_ASSERT_EQ(tres.playback_stats.max_miss_run, 4);
+	TEST_ASSERT(tres.playback_stats.min_slack_ns < 0);
+	TEST_ASSERT(!test_result_playback_ok(&tres));
+	result_free(platform, &res);
+	result_free(platform, &tres);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
 int test_tester_run_write_read_single_file(void **state)
 {
 	const platform_t *platform = *state;
@@ -244,6 +658,541 @@ int test_tester_run_write_read_single_file(void **state)
 	return 0;
 }
 
+int test_tester_run_engine_fallback(void **state)
+{
+	const platform_t *platform = *state;
+	const size_t frames = 5;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	frame_t *frm;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	/* The test platform has no asynchronous engine, must run in sync */
+	params.path = ".";
+	params.frame = frm;
+	params.frames = frames;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.engine = PLATFORM_ENGINE_URING;
+	params.queue_depth = 4;
+
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT_EQ(res.bytes_written, frames * frm->size);
+	TEST_ASSERT(res.completion);
+	result_free(platform, &res);
+
+	res = tester_run(platform, TEST_OP_READ, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT(res.completion);
+	result_free(platform, &res);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_preopen(void **state)
+{
+	const platform_t *platform = *state;
+	const size_t frames = 6;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	frame_t *frm;
+	size_t i;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = frames;
+	params.mode = TEST_MODE_REVERSE;
+	params.files = TEST_FILES_MULTIPLE;
+	params.preopen = 1;
+
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT_EQ(res.frames_failed, 0);
+	TEST_ASSERT(res.handle_time_ns > 0);
+	/* Nothing is opened or closed inside the measured loop */
+	for (i = 0; i < frames; i++)
+		TEST_ASSERT_EQ(test_completion_close(&res.completion[i]), 0);
+	result_free(platform, &res);
+
+	res = tester_run(platform, TEST_OP_READ, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT(res.handle_time_ns > 0);
+	result_free(platform, &res);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_shared_stream(void **state)
+{
+	const platform_t *platform = *state;
+	const size_t frames = 4;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	io_mode_t io_mode;
+	frame_t *frm;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = "stream";
+	params.frame = frm;
+	params.frames = frames;
+	params.mode = TEST_MODE_RANDOM;
+	params.files = TEST_FILES_SINGLE;
+	params.stream = tester_stream_open(platform, params.path,
+					   TEST_OP_WRITE, &io_mode);
+	params.stream_io_mode = io_mode;
+	TEST_ASSERT(params.stream > 0);
+
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT_EQ(res.frames_failed, 0);
+	TEST_ASSERT_EQ(test_completion_io_mode(&res.completion[0]), io_mode);
+	/* Shared stream isn't closed by the tester */
+	TEST_ASSERT_EQ(platform->close(params.stream), 0);
+	result_free(platform, &res);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_dispatch(void **state)
+{
+	const platform_t *platform = *state;
+	const size_t frames = 8;
+	tester_dispatch_t dispatch;
+	tester_params_t params = { 0 };
+	test_result_t a;
+	test_result_t b;
+	unsigned int seen = 0;
+	frame_t *frm;
+	size_t i;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	TEST_ASSERT_EQ(tester_dispatch_init(platform, &dispatch, 10, frames,
+					    TEST_MODE_REVERSE),
+		       0);
+	TEST_ASSERT_EQ(tester_dispatch_index(&dispatch, 0), 17);
+	TEST_ASSERT_EQ(tester_dispatch_index(&dispatch, frames - 1), 10);
+	tester_dispatch_free(platform, &dispatch);
+
+	TEST_ASSERT_EQ(tester_dispatch_init(platform, &dispatch, 0, frames,
+					    TEST_MODE_RANDOM),
+		       0);
+	for (i = 0; i < frames; i++)
+		seen |= 1U << tester_dispatch_index(&dispatch, i);
+	TEST_ASSERT_EQ(seen, (1U << frames) - 1);
+
+	params.path = ".";
+	params.frame = frm;
+	params.mode = TEST_MODE_RANDOM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.dispatch = &dispatch;
+
+	/* Two workers share the cursor, the first one may take 3 at most */
+	params.frames = 3;
+	a = tester_run(platform, TEST_OP_WRITE, &params);
+	/* The second keeps records of its last 2 frames only */
+	params.frames = frames;
+	params.records = 2;
+	b = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(a.frames_written, 3);
+	TEST_ASSERT_EQ(b.frames_written, frames - 3);
+	TEST_ASSERT_EQ(b.completion_cnt, 2);
+	TEST_ASSERT_EQ(a.frames_failed + b.frames_failed, 0);
+	result_free(platform, &a);
+	result_free(platform, &b);
+
+	/* Nothing left for a late worker */
+	a = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(a.frames_written, 0);
+	result_free(platform, &a);
+
+	tester_dispatch_free(platform, &dispatch);
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+/* Minimal in-order asynchronous engine on top of the test platform */
+typedef struct fake_aio_t {
+	size_t depth;
+	size_t inflight;
+	size_t max_inflight;
+	size_t submitted;
+	const char *bufs[8]; /* Distinct buffers of the requests */
+	size_t buf_cnt;
+	platform_aio_req_t *done_head;
+	platform_aio_req_t *done_tail;
+} fake_aio_t;
+
+static fake_aio_t fake_aio;
+
+static platform_aio_t *fake_aio_create(platform_engine_t engine, size_t depth)
+{
+	(void)engine;
+	memset(&fake_aio, 0, sizeof(fake_aio));
+	fake_aio.depth = depth;
+	return (platform_aio_t *)&fake_aio;
+}
+
+static int fake_aio_submit(platform_aio_t *aio, platform_aio_req_t *req)
+{
+	fake_aio_t *fa = (fake_aio_t *)aio;
+	const platform_t *platform = test_platform_get();
+	platform_handle_t f;
+	size_t i;
+
+	if (fa->inflight >= fa->depth)
+		return 1;
+
+	req->res = 0;
+	req->error = 0;
+	req->open_failed = 0;
+	f = platform->open(req->name, req->flags, req->mode);
+	req->open_ns = timing_time();
+	if (f < 0) {
+		req->error = ENOENT;
+		req->open_failed = 1;
+	} else {
+		req->res = req->size;
+		req->io_ns = timing_time();
+		platform->close(f);
+		req->close_ns = timing_time();
+	}
+
+	req->next = NULL;
+	if (fa->done_tail)
+		fa->done_tail->next = req;
+	else
+		fa->done_head = req;
+	fa->done_tail = req;
+
+	for (i = 0; i < fa->buf_cnt && fa->bufs[i] != req->buf; i++)
+		;
+	if (i == fa->buf_cnt && i < sizeof(fa->bufs) / sizeof(fa->bufs[0]))
+		fa->bufs[fa->buf_cnt++] = req->buf;
+
+	fa->submitted++;
+	if (++fa->inflight > fa->max_inflight)
+		fa->max_inflight = fa->inflight;
+
+	return 0;
+}
+
+static platform_aio_req_t *fake_aio_reap(platform_aio_t *aio, int wait)
+{
+	fake_aio_t *fa = (fake_aio_t *)aio;
+	platform_aio_req_t *req = fa->done_head;
+
+	(void)wait;
+	if (!req)
+		return NULL;
+	fa->done_head = req->next;
+	if (!fa->done_head)
+		fa->done_tail = NULL;
+	fa->inflight--;
+
+	return req;
+}
+
+static void fake_aio_destroy(platform_aio_t *aio)
+{
+	(void)aio;
+}
+
+static int tester_run_async_with(test_mode_t mode)
+{
+	platform_t platform = *test_platform_get();
+	const size_t frames = 12;
+	const size_t depth = 4;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	frame_t *frm;
+
+	platform.aio_create = fake_aio_create;
+	platform.aio_submit = fake_aio_submit;
+	platform.aio_reap = fake_aio_reap;
+	platform.aio_destroy = fake_aio_destroy;
+
+	frm = gen_default_frame(&platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = frames;
+	params.mode = mode;
+	params.files = TEST_FILES_MULTIPLE;
+	params.engine = PLATFORM_ENGINE_THREADS;
+	params.queue_depth = depth;
+
+	res = tester_run(&platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT_EQ(res.frames_failed, 0);
+	TEST_ASSERT(res.completion);
+	TEST_ASSERT_EQ(fake_aio.submitted, frames);
+	TEST_ASSERT_EQ(fake_aio.max_inflight, depth);
+	result_free(&platform, &res);
+
+	res = tester_run(&platform, TEST_OP_READ, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT_EQ(res.frames_failed, 0);
+	TEST_ASSERT(res.completion);
+	TEST_ASSERT_EQ(fake_aio.max_inflight, depth);
+	result_free(&platform, &res);
+
+	frame_destroy(&platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_vstreams(void **state)
+{
+	platform_t platform = *test_platform_get();
+	const size_t frames[] = { 5, 3, 4, 2 };
+	const test_mode_t modes[] = { TEST_MODE_NORM, TEST_MODE_REVERSE,
+				      TEST_MODE_RANDOM, TEST_MODE_NORM };
+	tester_vstream_t vs[4];
+	test_result_t hres = { 0 };
+	stream_stats_t stats;
+	size_t start_frame = 0;
+	size_t i;
+	frame_t *frm;
+
+	(void)state;
+	platform.aio_create = fake_aio_create;
+	platform.aio_submit = fake_aio_submit;
+	platform.aio_reap = fake_aio_reap;
+	platform.aio_destroy = fake_aio_destroy;
+
+	frm = gen_default_frame(&platform);
+	TEST_ASSERT(frm);
+
+	memset(vs, 0, sizeof(vs));
+	for (i = 0; i < 4; i++) {
+		vs[i].params.path = ".";
+		vs[i].params.frame = frm;
+		vs[i].params.start_frame = start_frame;
+		vs[i].params.frames = frames[i];
+		vs[i].params.mode = modes[i];
+		vs[i].params.files = TEST_FILES_MULTIPLE;
+		vs[i].params.hist_digits = 2;
+		start_frame += frames[i];
+	}
+	/* Two paced streams, half a period apart */
+	vs[2].params.fps = 10;
+	vs[3].params.fps = 10;
+	vs[3].offset_ns = SEC_IN_NS / 20;
+
+	/* Four streams share two slots */
+	TEST_ASSERT_EQ(tester_run_vstreams(&platform, TEST_OP_WRITE, vs, 4,
+					   PLATFORM_ENGINE_THREADS, 2, &hres),
+		       0);
+	TEST_ASSERT_EQ(fake_aio.submitted, 14);
+	TEST_ASSERT(fake_aio.max_inflight <= 2);
+	for (i = 0; i < 4; i++) {
+		TEST_ASSERT_EQ(vs[i].res.frames_written, frames[i]);
+		TEST_ASSERT_EQ(vs[i].res.frames_failed, 0);
+		TEST_ASSERT(!vs[i].res.hist);
+	}
+	/* One histogram of all streams, intended starts of the paced ones */
+	TEST_ASSERT(hres.hist);
+	TEST_ASSERT_EQ(hres.hist->total, 14);
+	TEST_ASSERT(hres.hist_intended);
+	TEST_ASSERT_EQ(hres.hist_intended->total, 6);
+	TEST_ASSERT_EQ(test_completion_intended(&vs[2].res.completion[1]) -
+			       test_completion_intended(&vs[2].res.completion[0]),
+		       SEC_IN_NS / 10);
+	TEST_ASSERT_EQ(test_completion_intended(&vs[3].res.completion[0]) -
+			       test_completion_intended(&vs[2].res.completion[0]),
+		       SEC_IN_NS / 20);
+	TEST_ASSERT(vs[3].res.completion[0].start >=
+		    test_completion_intended(&vs[3].res.completion[0]));
+
+	tester_vstream_stats(&vs[0], &stats);
+	TEST_ASSERT_EQ(stats.frames, 5);
+	TEST_ASSERT_EQ(stats.bytes, 5 * frm->size);
+	TEST_ASSERT(stats.max_frame_ns >= stats.avg_frame_ns);
+
+	for (i = 0; i < 4; i++)
+		result_free(&platform, &vs[i].res);
+	result_free(&platform, &hres);
+	frame_destroy(&platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_async(void **state)
+{
+	(void)state;
+	return tester_run_async_with(TEST_MODE_NORM);
+}
+
+int test_tester_run_async_reverse(void **state)
+{
+	(void)state;
+	return tester_run_async_with(TEST_MODE_REVERSE);
+}
+
+int test_tester_run_async_random(void **state)
+{
+	(void)state;
+	return tester_run_async_with(TEST_MODE_RANDOM);
+}
+
+int test_tester_run_slot_buffers(void **state)
+{
+	platform_t platform = *test_platform_get();
+	tester_params_t params = { 0 };
+	static char slots[3][ALIGN_SIZE];
+	test_result_t res;
+	void *bufs[3];
+	frame_t *frm;
+	size_t i;
+	size_t j;
+
+	(void)state;
+	platform.aio_create = fake_aio_create;
+	platform.aio_submit = fake_aio_submit;
+	platform.aio_reap = fake_aio_reap;
+	platform.aio_destroy = fake_aio_destroy;
+
+	frm = gen_default_frame(&platform);
+	TEST_ASSERT(frm);
+	for (i = 0; i < 3; i++)
+		bufs[i] = slots[i];
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = 12;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.engine = PLATFORM_ENGINE_THREADS;
+	params.queue_depth = 3;
+	params.bufs = bufs;
+	params.buf_cnt = 3;
+
+	/* Every slot in flight has its own buffer, none is the frame's */
+	res = tester_run(&platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.frames_written, 12);
+	TEST_ASSERT_EQ(fake_aio.buf_cnt, 3);
+	for (i = 0; i < fake_aio.buf_cnt; i++) {
+		for (j = 0; j < 3 && fake_aio.bufs[i] != bufs[j]; j++)
+			;
+		TEST_ASSERT(j < 3);
+	}
+	result_free(&platform, &res);
+
+	/* A smaller pool is shared round-robin */
+	params.buf_cnt = 2;
+	res = tester_run(&platform, TEST_OP_READ, &params);
+	TEST_ASSERT_EQ(res.frames_written, 12);
+	TEST_ASSERT_EQ(fake_aio.buf_cnt, 2);
+	result_free(&platform, &res);
+
+	frame_destroy(&platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_stamp(void **state)
+{
+	const platform_t *platform = *state;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	frame_t *frm;
+
+	frm = gen_default_frame(platform);
+	TEST_ASSERT(frm);
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = 5;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.stamp = 1;
+
+	/* Every frame written is stamped with its number, reads aren't */
+	memset(&fake_stamp, 0, sizeof(fake_stamp));
+	res = tester_run(platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.frames_written, 5);
+	TEST_ASSERT_EQ(fake_stamp.cnt, 5);
+	TEST_ASSERT_EQ(fake_stamp.sum, 0 + 1 + 2 + 3 + 4);
+	result_free(platform, &res);
+
+	res = tester_run(platform, TEST_OP_READ, &params);
+	TEST_ASSERT_EQ(fake_stamp.cnt, 5);
+	result_free(platform, &res);
+
+	frame_destroy(platform, frm);
+
+	return 0;
+}
+
+int test_tester_run_striped(void **state)
+{
+	platform_t platform = *test_platform_get();
+	const size_t frames = 5;
+	tester_params_t params = { 0 };
+	test_result_t res;
+	frame_t *frm;
+
+	(void)state;
+	platform.aio_create = fake_aio_create;
+	platform.aio_submit = fake_aio_submit;
+	platform.aio_reap = fake_aio_reap;
+	platform.aio_destroy = fake_aio_destroy;
+
+	frm = gen_default_frame(&platform);
+	TEST_ASSERT(frm);
+	/* The engine never touches the data, only the ranges matter */
+	frm->size = 10 * ALIGN_SIZE + 100;
+
+	params.path = ".";
+	params.frame = frm;
+	params.frames = frames;
+	params.mode = TEST_MODE_NORM;
+	params.files = TEST_FILES_MULTIPLE;
+	params.stripes = 4;
+
+	res = tester_run(&platform, TEST_OP_WRITE, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT_EQ(res.frames_failed, 0);
+	TEST_ASSERT_EQ(res.bytes_written, frames * frm->size);
+	TEST_ASSERT_EQ(fake_aio.depth, 4);
+	TEST_ASSERT_EQ(fake_aio.submitted, frames * 4);
+	TEST_ASSERT_EQ(fake_aio.max_inflight, 4);
+	result_free(&platform, &res);
+
+	/* More stripes than aligned ranges in the frame */
+	frm->size = 2 * ALIGN_SIZE;
+	res = tester_run(&platform, TEST_OP_READ, &params);
+	TEST_ASSERT_EQ(res.frames_written, frames);
+	TEST_ASSERT_EQ(fake_aio.submitted, frames * 2);
+	result_free(&platform, &res);
+
+	TEST_ASSERT_EQ(tester_stripe_size(10 * ALIGN_SIZE + 100, 4),
+		       3 * ALIGN_SIZE);
+	TEST_ASSERT_EQ(tester_stripe_size(ALIGN_SIZE, 4), ALIGN_SIZE);
+
+	frame_destroy(&platform, frm);
+
+	return 0;
+}
+
 int test_tester_result_aggregate(void)
 {
 	test_result_t a = { 0 };
@@ -281,8 +1230,27 @@ int test_tester(void)
 	TESTF(tester_run_write_read_reverse, test_setup, test_teardown);
 	TESTF(tester_run_write_read_random, test_setup, test_teardown);
 	TESTF(tester_run_write_read_single_file, test_setup, test_teardown);
+	TESTF(tester_run_engine_fallback, test_setup, test_teardown);
+	TESTF(tester_run_preopen, test_setup, test_teardown);
+	TESTF(tester_run_shared_stream, test_setup, test_teardown);
+	TESTF(tester_run_dispatch, test_setup, test_teardown);
+	TESTF(tester_run_async, test_setup, test_teardown);
+	TESTF(tester_run_async_reverse, test_setup, test_teardown);
+	TESTF(tester_run_async_random, test_setup, test_teardown);
+	TESTF(tester_run_slot_buffers, test_setup, test_teardown);
+	TESTF(tester_run_stamp, test_setup, test_teardown);
+	TESTF(tester_run_striped, test_setup, test_teardown);
 	TEST(tester_result_aggregate);
 	TESTF(tester_run_write_read_fps, test_setup, test_teardown);
+	TESTF(tester_pacer, test_setup, test_teardown);
+	TESTF(tester_run_intended, test_setup, test_teardown);
+	TESTF(tester_run_duration, test_setup, test_teardown);
+	TESTF(tester_run_steady_state, test_setup, test_teardown);
+	TEST(tester_completion_pack);
+	TESTF(tester_aggregate_histograms, test_setup, test_teardown);
+	TESTF(tester_run_load, test_setup, test_teardown);
+	TESTF(tester_run_playback, test_setup, test_teardown);
+	TESTF(tester_run_vstreams, test_setup, test_teardown);
 
 	TEST_END();
 }